@@ -52,9 +52,8 @@ extern uint32_t SystemCoreClock;
 #define configTICK_RATE_HZ				( ( TickType_t ) 1000U )
 #define configMAX_PRIORITIES			( 5 )
 #define configMINIMAL_STACK_SIZE		( ( unsigned short ) 128U )
-#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 12U * 1024U ) )
 #define configMAX_TASK_NAME_LEN			( 5 )
-#define configUSE_TRACE_FACILITY		0
+#define configUSE_TRACE_FACILITY		1
 #define configUSE_16_BIT_TICKS			0
 #define configIDLE_SHOULD_YIELD			1
 #define configUSE_MUTEXES				1
@@ -64,7 +63,17 @@ extern uint32_t SystemCoreClock;
 #define configUSE_MALLOC_FAILED_HOOK	0
 #define configUSE_APPLICATION_TASK_TAG	0
 #define configUSE_COUNTING_SEMAPHORES	1
-#define configGENERATE_RUN_TIME_STATS	0
+#define configGENERATE_RUN_TIME_STATS	1
+
+/* All kernel objects are static, RAM use is known at link time */
+#define configSUPPORT_STATIC_ALLOCATION		1
+#define configSUPPORT_DYNAMIC_ALLOCATION	0
+
+/* Run time stats clock, free running TIM6 extended to 32 bits on tick hook */
+extern void vRtosStatsTimerInit(void);
+extern uint32_t u32RtosStatsTimerGet(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	vRtosStatsTimerInit()
+#define portGET_RUN_TIME_COUNTER_VALUE()			u32RtosStatsTimerGet()
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 			0
@@ -90,6 +99,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTaskGetCurrentTaskHandle	1
 
 /* Normal assert() semantics without relying on the provision of an assert.h
 header file. */
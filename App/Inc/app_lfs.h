@@ -20,11 +20,13 @@ extern "C"
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "YM2612_driver.h"
 #include "synth_app_data_const.h"
 #include "midi_lib.h"
+#include "sys_rtos.h"
 
 /* Private defines -----------------------------------------------------------*/
 
@@ -42,6 +44,9 @@ extern "C"
 #define LFS_MIDI_CFG_MAX_PROG_BANK_FLASH    ( LFS_YM_SLOT_NUM )
 #define LFS_MIDI_CFG_MAX_PROG_BANK_SD       ( 255U )
 
+/** Number of CV inputs with V/Oct calibration */
+#define LFS_CAL_CH_NUM                      ( 4U )
+
 /* Exported types ------------------------------------------------------------*/
 
 /** Return codes */
@@ -81,6 +86,13 @@ typedef struct lfs_midi_data
     uint8_t u8Program;
 } lfs_midi_data_t;
 
+/** V/Oct calibration, pitch in cents = (i32Offset - adc) * u32Gain >> 16 */
+typedef struct lfs_cal_data
+{
+    int32_t i32Offset[LFS_CAL_CH_NUM];      /* ADC counts for note 0 */
+    uint32_t u32Gain[LFS_CAL_CH_NUM];       /* Cents per ADC count, Q16 */
+} lfs_cal_data_t;
+
 /** Defined program data */
 typedef struct lfs_ym_cfg
 {
@@ -88,6 +100,16 @@ typedef struct lfs_ym_cfg
     xFmDevice_t xPresetData;
 } lfs_ym_data_t;
 
+/** Preset directory entry, kept on RAM */
+typedef struct lfs_ym_dir_entry
+{
+    const char * pcName;
+    uint32_t u32Crc;
+    uint32_t u32FirstLoadUs;
+    uint16_t u16Size;
+    bool bValid;
+} lfs_ym_dir_entry_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
@@ -115,6 +137,22 @@ lfs_status_t LFS_read_midi_data(lfs_midi_data_t *pxData);
  */
 lfs_status_t LFS_write_midi_data(lfs_midi_data_t *pxData);
 
+/**
+ * @brief Read V/Oct calibration.
+ * 
+ * @param pxData pointer where store calibration.
+ * @return lfs_status_t operation status, error if unit has not been calibrated.
+ */
+lfs_status_t LFS_read_cal_data(lfs_cal_data_t *pxData);
+
+/**
+ * @brief Write V/Oct calibration.
+ * 
+ * @param pxData pointer with data to store.
+ * @return lfs_status_t operation status.
+ */
+lfs_status_t LFS_write_cal_data(lfs_cal_data_t *pxData);
+
 /**
  * @brief Read YM config file
  * 
@@ -124,6 +162,16 @@ lfs_status_t LFS_write_midi_data(lfs_midi_data_t *pxData);
  */
 lfs_status_t LFS_read_ym_data(uint8_t u8Slot, lfs_ym_data_t *pxData);
 
+/**
+ * @brief Read a single channel from YM config file
+ * 
+ * @param u8Slot config slot to read. Value must be lower than LFS_YM_MAX_NUM.
+ * @param u8Channel channel of the stored preset to read.
+ * @param pxData pointer where store channel data.
+ * @return lfs_status_t operation status.
+ */
+lfs_status_t LFS_read_ym_channel(uint8_t u8Slot, uint8_t u8Channel, xFmChannel_t *pxData);
+
 /**
  * @brief Save YM config file
  * 
@@ -133,6 +181,63 @@ lfs_status_t LFS_read_ym_data(uint8_t u8Slot, lfs_ym_data_t *pxData);
  */
 lfs_status_t LFS_write_ym_data(uint8_t u8Slot, lfs_ym_data_t *pxData);
 
+/**
+ * @brief Delete YM config file, slot is created again on next write.
+ * 
+ * @param u8Slot config slot to delete. Value must be lower than LFS_YM_MAX_NUM.
+ * @return lfs_status_t operation status.
+ */
+lfs_status_t LFS_delete_ym_data(uint8_t u8Slot);
+
+/**
+ * @brief Get preset info from RAM directory, no flash access.
+ *        Flash names may be rewritten by a later save, use LFS_get_ym_name to copy them.
+ * 
+ * @param u8Bank preset bank, ROM or FLASH.
+ * @param u8Program preset position on bank.
+ * @param pxEntry pointer where store entry data.
+ * @return lfs_status_t operation status.
+ */
+lfs_status_t LFS_get_ym_dir_entry(uint8_t u8Bank, uint8_t u8Program, lfs_ym_dir_entry_t *pxEntry);
+
+/**
+ * @brief Keep latency of first load of a flash preset after boot, later loads are ignored.
+ * 
+ * @param u8Slot flash preset slot.
+ * @param u32LoadUs time from load request to preset applied, microseconds.
+ * @return true if it was the first load of the slot.
+ */
+bool LFS_set_ym_first_load(uint8_t u8Slot, uint32_t u32LoadUs);
+
+/**
+ * @brief Compute crc of preset register data, same used on RAM directory.
+ * 
+ * @param pxData preset register data.
+ * @return uint32_t crc value.
+ */
+uint32_t LFS_get_ym_crc(const xFmDevice_t *pxData);
+
+/**
+ * @brief Copy preset name from RAM directory, no flash access.
+ * 
+ * @param u8Bank preset bank, ROM or FLASH.
+ * @param u8Program preset position on bank.
+ * @param pcName buffer where copy the name.
+ * @param xLen buffer size, name is truncated to fit.
+ * @return const char* pcName, empty string if not valid.
+ */
+const char * LFS_get_ym_name(uint8_t u8Bank, uint8_t u8Program, char *pcName, size_t xLen);
+
+/**
+ * @brief Get cycles flash was busy on file system erase and program, code fetch
+ *        from flash is stalled meanwhile, so it is the latency added to any task or irq.
+ *        Measured with run time stats clock, RTOS_STATS_CLOCK_CYCLES resolution.
+ * 
+ * @param pxErase where to copy page erase measures, NULL if not used.
+ * @param pxProgram where to copy double word program measures, NULL if not used.
+ */
+void LFS_get_flash_stall(rtos_bench_t *pxErase, rtos_bench_t *pxProgram);
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,6 +26,12 @@ extern "C" {
  */
 void cli_cmd_init(void);
 
+/**
+ * @brief  Get command to run on periodic refresh, called from cli task.
+ * @retval Command line to run, NULL if no periodic command is active.
+ */
+const char * cli_cmd_periodic(void);
+
 /* Private defines -----------------------------------------------------------*/
 
 #ifdef __cplusplus
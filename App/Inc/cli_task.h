@@ -31,9 +31,44 @@ extern "C" {
 /* Buffer sizes */
 #define CLI_OUTPUT_BUFFER_SIZE  configCOMMAND_INT_MAX_OUTPUT_SIZE
 
+/* Log ring drained by serial DMA, must be a power of two */
+#define CLI_LOG_RING_SIZE       ( 512U )
+
+/* Max size of a single log record, formatted on caller stack */
+#define CLI_LOG_RECORD_SIZE     ( 96U )
+
+/* CLI_LOG calls send format id and raw arguments, decoded on host with Tools/py_tools/log_decoder.py */
+// #define CLI_LOG_BINARY
+
+/* Binary log frame: sync, number of args, format id (u16), tick (u32), args (u32) */
+#define CLI_LOG_BIN_SYNC        ( 0x00U )
+#define CLI_LOG_BIN_MAX_ARGS    ( 6U )
+
+/* Accept midi messages mixed with cli commands, running status not supported */
+#define CLI_MIDI_INPUT_ENABLE
+
+/* Buffer for sysEx received on cli port */
+#define CLI_MIDI_SYS_EX_SIZE    ( 64U )
+
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
+
+/**
+  * @brief Log call for real time paths, only integer arguments are supported.
+  *        On binary mode format string is kept out of flash in .cli_log_fmt section,
+  *        its offset is used as id by host decoder.
+  */
+#ifdef CLI_LOG_BINARY
+#define CLI_LOG(MODULE, FMT, ...)                                                                   \
+    do {                                                                                            \
+        static const char cCliLogFmt[] __attribute__((section(".cli_log_fmt"), used)) = MODULE ", " FMT; \
+        const uint32_t u32CliLogArgs[] = { 0U, ##__VA_ARGS__ };                                     \
+        vCliLogBin((uint32_t)cCliLogFmt, &u32CliLogArgs[1U], (sizeof(u32CliLogArgs) / sizeof(uint32_t)) - 1U); \
+    } while (0)
+#else
+#define CLI_LOG(MODULE, FMT, ...)   vCliPrintf(MODULE, FMT, ##__VA_ARGS__)
+#endif
 /* Exported functions prototypes ---------------------------------------------*/
 
 /**
@@ -57,6 +92,32 @@ void vCliPrintf(const char *module_name, const char *Format, ...);
   */
 void vCliRawPrintf(const char *Format, ...);
 
+/**
+  * @brief Push a binary log frame to the log ring, use CLI_LOG macro instead.
+  * @param u32FmtId format string id.
+  * @param pu32Args raw argument words.
+  * @param u32NumArgs number of arguments.
+  * @retval None.
+  */
+void vCliLogBin(uint32_t u32FmtId, const uint32_t *pu32Args, uint32_t u32NumArgs);
+
+/**
+  * @brief Write a binary frame to serial output, not mixed with other log records.
+  *        Frame is mark, data length (16 bit LE), data and 8 bit sum of data.
+  *        Only called from cli task, waits for room on log ring.
+  * @param pcMark text mark used by host to find the frame.
+  * @param pu8Data frame data.
+  * @param u32Len frame data length, frame must fit on log ring.
+  * @retval true frame queued, false timeout waiting for room.
+  */
+bool bCliWriteFrame(const char *pcMark, const uint8_t *pu8Data, uint32_t u32Len);
+
+/**
+  * @brief Get number of log records dropped with log ring full.
+  * @retval number of dropped records since boot.
+  */
+uint32_t u32CliGetLogDropCount(void);
+
 /**
   * @brief Notify event to a task.
   * @param u32Event event to notify.
@@ -64,6 +125,12 @@ void vCliRawPrintf(const char *Format, ...);
   */
 bool bCliTaskNotify(uint32_t u32Event);
 
+/**
+  * @brief Request refresh of periodic cli commands, run on cli task.
+  * @retval operation result, true if cli task is running.
+  */
+bool bCliNotifyPeriodic(void);
+
 #ifdef __cplusplus
 }
 #endif
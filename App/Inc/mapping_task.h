@@ -26,7 +26,7 @@ extern "C" {
 
 /* Task parameters */
 #define MAP_TASK_NAME                   "MAP"
-#define MAP_TASK_STACK                  ( 128U )
+#define MAP_TASK_STACK                  ( 160U )
 #define MAP_TASK_PRIO                   ( 2U )
 #define MAP_TASK_INIT_DELAY             ( 500U )
 
@@ -34,8 +34,16 @@ extern "C" {
 #define MAP_SIGNAL_ERROR                ( 1UL << 0U )
 #define MAP_SIGNAL_ADC_UPDATE           ( 1UL << 1U )
 #define MAP_SIGNAL_MAPPING_UPDATE       ( 1UL << 2U )
+#define MAP_SIGNAL_CAL_LOADED           ( 1UL << 3U )
+#define MAP_SIGNAL_ADC_CH_SHIFT         ( 8U )
+#define MAP_SIGNAL_ADC_CH_MASK          ( 0xFUL << MAP_SIGNAL_ADC_CH_SHIFT )
 #define MAP_SIGNAL_NOT_DEF              ( 1UL << 31U )
 
+/* V/Oct calibration points */
+#define MAP_CAL_POINT_LOW               ( 0U )
+#define MAP_CAL_POINT_HIGH              ( 1U )
+#define MAP_CAL_POINT_NUM               ( 2U )
+
 /* Exported types ------------------------------------------------------------*/
 
 /** Defined mapping channels */
@@ -87,6 +95,23 @@ MapElement_t xMapGetCfg(uint8_t u8MapId);
   */
 void vMapSetCfg(uint8_t u8MapId, MapElement_t xMapValue);
 
+/**
+  * @brief Capture current input as a V/Oct calibration point, high point
+  *        computes channel gain and offset and stores them on flash.
+  * @param u8MapId channel to calibrate.
+  * @param u8Point MAP_CAL_POINT_LOW or MAP_CAL_POINT_HIGH.
+  * @param u8Note note played by the voltage on input.
+  * @retval true point accepted, false input or result out of range.
+  */
+bool bMapCalSetPoint(uint8_t u8MapId, uint8_t u8Point, uint8_t u8Note);
+
+/**
+  * @brief Restore default V/Oct calibration of a channel and store it.
+  * @param u8MapId channel to reset.
+  * @retval None.
+  */
+void vMapCalReset(uint8_t u8MapId);
+
 /**
   * @brief Init resources for MAPPING tasks.
   * @retval None.
@@ -100,6 +125,13 @@ void vMapTaskInit(void);
   */
 bool bMapTaskNotify(uint32_t u32Event);
 
+/**
+  * @brief Convert an ADC count into every FM parameter, used to measure mapping cost.
+  * @param u16AdcValue ADC count to convert.
+  * @retval Xor of all parameter values, keeps the work from being optimized out.
+  */
+uint8_t u8MapBenchParamValues(uint16_t u16AdcValue);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,8 +36,16 @@ extern "C" {
 #define MIDI_SIGNAL_RX_DATA             ( 1UL << 0 )
 #define MIDI_SIGNAL_ERROR               ( 1UL << 2 )
 #define MIDI_SIGNAL_CMD_IN              ( 1UL << 3 )
+#define MIDI_SIGNAL_SYSEX_DONE          ( 1UL << 4 )
+#define MIDI_SIGNAL_CFG_LOADED          ( 1UL << 5 )
 #define MIDI_SIGNAL_ALL                 ( 0xFFFFFFFFU )
 
+/* SysEx vendor id, as sent by Tools/py_tools/YM2612.py */
+#define MIDI_SYSEX_VENDOR_ID_0          ( 0x00U )
+#define MIDI_SYSEX_VENDOR_ID_1          ( 0x12U )
+#define MIDI_SYSEX_VENDOR_ID_2          ( 0x34U )
+#define MIDI_SYSEX_VENDOR_ID_LEN        ( 3U )
+
 /* Extended debug output */
 // #define MIDI_DBG_STATS
 // #define MIDI_DBG_VERBOSE
@@ -51,14 +59,18 @@ typedef enum
     MIDI_CMD_SET_CH,
     MIDI_CMD_SET_PRESET,
     MIDI_CMD_SAVE_MIDI_CFG,
+    MIDI_CMD_SET_PART_PRESET,
+    MIDI_CMD_EXT_MSG,
     MIDI_CMF_NOT_DEF = 0xFFU,
 } MidiCmdType_t;
 
 /** SysEx defined cmd */
 typedef enum
 {
-    MIDI_SYSEX_CMD_SAVE_PRESET = 0x00U,
-    MIDI_SYSEX_CMD_LOAD_PRESET = 0x01U,
+    MIDI_SYSEX_CMD_SET_REG = 0x00U,
+    MIDI_SYSEX_CMD_SAVE_PRESET = 0x01U,
+    MIDI_SYSEX_CMD_LOAD_PRESET = 0x02U,
+    MIDI_SYSEX_CMD_LOAD_DEFAULT_PRESET = 0x03U,
     MIDI_SYSEX_CMD_NO_DEF = 0x1FU
 } MidiSysExCmdDef_t;
 
@@ -80,12 +92,28 @@ typedef struct MidiCmdTaskPayloadSetPreset
     uint8_t u8Program;
 } MidiCmdTaskPayloadSetPreset_t;
 
+typedef struct MidiCmdTaskPayloadSetPartPreset
+{
+    uint8_t u8Part;
+    uint8_t u8Bank;
+    uint8_t u8Program;
+} MidiCmdTaskPayloadSetPartPreset_t;
+
+typedef struct MidiCmdTaskPayloadExtMsg
+{
+    uint8_t u8Status;
+    uint8_t u8Data0;
+    uint8_t u8Data1;
+} MidiCmdTaskPayloadExtMsg_t;
+
 /** Union definitions with all event payload */
 typedef union MidiCmdTaskPayload
 {
     MidiCmdTaskPayloadSetMode_t xSetMode;
     MidiCmdTaskPayloadSetCh_t xSetCh;
     MidiCmdTaskPayloadSetPreset_t xSetPreset;
+    MidiCmdTaskPayloadSetPartPreset_t xSetPartPreset;
+    MidiCmdTaskPayloadExtMsg_t xExtMsg;
 } MidiCmdTaskPayload_t;
 
 /** Midi taks cmd definition */
@@ -121,6 +149,13 @@ typedef struct MidiParam
     MidiParamData_t uData;
 } MidiParam_t;
 
+/** Preset loaded on a single part in multi-timbral mode */
+typedef struct MidiPartPreset
+{
+    uint8_t u8Bank;
+    uint8_t u8Program;
+} MidiPartPreset_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
@@ -153,6 +188,13 @@ bool bMidiSendCmd(MidiTaskCmd_t xMidiTaskCmd);
  */
 MidiParam_t xMidiGetParam(MidiParamType_t ePatamId);
 
+/**
+ * @brief Get preset loaded on a part (voice) in multi-timbral mode.
+ * @param u8Part: part to check.
+ * @return MidiPartPreset_t: bank and program loaded on the part.
+ */
+MidiPartPreset_t xMidiGetPartPreset(uint8_t u8Part);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,98 @@
+/**
+  ******************************************************************************
+  * @file           : storage_task.h
+  * @brief          : Task to handle file system access
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STORAGE_TASK_H
+#define __STORAGE_TASK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sys_rtos.h"
+#include "app_lfs.h"
+
+/* Private includes ----------------------------------------------------------*/
+/* Private defines -----------------------------------------------------------*/
+
+/* Task parameters */
+#define STORAGE_TASK_NAME               "STORAGE"
+#define STORAGE_TASK_STACK              ( 512U )
+#define STORAGE_TASK_PRIO               ( 2U )
+#define STORAGE_TASK_INIT_DELAY         ( 0U )
+
+/* Log every request with its duration */
+// #define STORAGE_DBG_VERBOSE
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Storage commands */
+typedef enum
+{
+    STORAGE_CMD_YM_LOAD = 0x00U,
+    STORAGE_CMD_YM_LOAD_CHANNEL,
+    STORAGE_CMD_YM_SAVE,
+    STORAGE_CMD_YM_DELETE,
+    STORAGE_CMD_MIDI_LOAD,
+    STORAGE_CMD_MIDI_SAVE,
+    STORAGE_CMD_CAL_LOAD,
+    STORAGE_CMD_CAL_SAVE,
+    STORAGE_CMD_CRASH_CLEAR,
+    STORAGE_CMD_NO_DEF = 0xFFU
+} StorageCmdType_t;
+
+typedef struct StorageCmd StorageCmd_t;
+
+/** Request done callback, called from storage task context */
+typedef void (* StorageDoneCb_t)(const StorageCmd_t * pxCmd, bool bResult);
+
+/** Storage command definition */
+struct StorageCmd
+{
+    StorageCmdType_t eCmd;
+    uint8_t u8Slot;                 /* YM preset slot */
+    uint8_t u8Channel;              /* YM channel, only for STORAGE_CMD_YM_LOAD_CHANNEL */
+    uint32_t u32Ctx;                /* Requester data, returned on done callback */
+    void * pvData;                  /* Read destination or write source, owned by requester until done */
+    StorageDoneCb_t pxDoneCb;
+};
+
+/* Exported constants --------------------------------------------------------*/
+/* Exported macro ------------------------------------------------------------*/
+/* Exported functions prototypes ---------------------------------------------*/
+
+/**
+  * @brief Init resources for STORAGE tasks
+  * @retval None.
+  */
+void vStorageTaskInit(void);
+
+/**
+  * @brief Queue a request to storage task, never blocks.
+  * @param xStorageCmd request to send, data buffer must be kept until done callback.
+  * @retval true request queued, false queue full.
+  */
+bool bStorageSendCmd(StorageCmd_t xStorageCmd);
+
+/**
+  * @brief Check if file system has been mounted.
+  * @retval true if storage requests are being served.
+  */
+bool bStorageReady(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STORAGE_TASK_H */
+
+/* EOF */
@@ -20,6 +20,7 @@ extern "C" {
 #include <string.h>
 
 #include "YM2612_driver.h"
+#include "sys_rtos.h"
 
 #include "app_lfs.h"
 #include "synth_app_data_const.h"
@@ -42,6 +43,19 @@ extern "C" {
 /* Maximun number of user presets */
 #define SYNTH_MAX_NUM_USER_PRESET           ( LFS_YM_SLOT_NUM )
 
+/* Preset channel used as timbre source when a program is loaded into a single part */
+#define SYNTH_PART_PRESET_SRC_CHANNEL       ( YM2612_CH_1 )
+
+/* Voice / operator index selecting all of them on FM edit commands */
+#define SYNTH_FM_VOICE_ALL                  ( YM2612_NUM_CHANNEL )
+#define SYNTH_FM_OPERATOR_ALL               ( YM2612_NUM_OP_CHANNEL )
+
+/* Retries reading a snapshot while synth task is publishing it */
+#define SYNTH_SNAPSHOT_RETRY                ( 4U )
+
+/* Max velocity sensitivity value, full curve applied */
+#define SYNTH_VEL_SENS_MAX                  ( 7U )
+
 /* Enable extended DBG */
 // #define SYNTH_DBG_VERBOSE
 
@@ -55,6 +69,14 @@ typedef enum
     SYNTH_CMD_PARAM_UPDATE,
     SYNTH_CMD_PRESET_UPDATE,
     SYNTH_CMD_VOICE_MUTE,
+    SYNTH_CMD_PART_PRESET_UPDATE,
+    SYNTH_CMD_REG_UPDATE,
+    SYNTH_CMD_STORAGE_DONE,
+    SYNTH_CMD_VOICE_PITCH,
+    SYNTH_CMD_FM_PARAM_SET,
+    SYNTH_CMD_FM_COPY,
+    SYNTH_CMD_REG_WRITE,
+    SYNTH_CMD_BENCH,
     SYNTH_CMD_NO_DEF = 0xFFU
 } SynthCmdType_t;
 
@@ -65,6 +87,7 @@ typedef struct
     uint8_t u8VoiceState;
     uint8_t u8Note;
     uint8_t u8Velocity;
+    uint32_t u32GateStamp;              /* Run time stats clock on gate edge, 0 if not sent from a gate input */
 } SynthCmdPayloadVoiceUpdateMono_t;
 
 /** Payload for voice update */
@@ -75,6 +98,14 @@ typedef struct
     uint8_t u8Velocity;
 } SynthCmdPayloadVoiceUpdatePoly_t;
 
+/** Payload for voice fine pitch update */
+typedef struct
+{
+    uint8_t u8VoiceDst;
+    uint8_t u8Note;
+    uint8_t u8Cents;
+} SynthCmdPayloadVoicePitch_t;
+
 /** Payload for parameter update command */
 typedef struct
 {
@@ -90,6 +121,70 @@ typedef struct
     uint8_t u8Program;
 } SynthCmdPayloadPresetUpdate_t;
 
+/** Payload definition for single part preset update command */
+typedef struct
+{
+    uint8_t u8Part;
+    uint8_t u8Bank;
+    uint8_t u8Program;
+} SynthCmdPayloadPartPresetUpdate_t;
+
+/** Payload definition for register data update command */
+typedef struct
+{
+    uint8_t u8Action;
+    uint8_t u8Program;
+    lfs_ym_data_t * pxPreset;
+} SynthCmdPayloadRegUpdate_t;
+
+/** Payload definition for storage request done */
+typedef struct
+{
+    uint8_t u8Cmd;
+    uint8_t u8Slot;
+    uint8_t u8Ctx;
+    uint8_t u8Result;
+} SynthCmdPayloadStorageDone_t;
+
+/** Payload definition for FM parameter edit */
+typedef struct
+{
+    uint8_t u8Param;                /* eFmParameter_t */
+    uint8_t u8Voice;                /* Voice or SYNTH_FM_VOICE_ALL */
+    uint8_t u8Operator;             /* Operator or SYNTH_FM_OPERATOR_ALL */
+    uint8_t u8Value;
+} SynthCmdPayloadFmParamSet_t;
+
+/** Payload definition for FM copy, first voice / operator copied when ALL is selected */
+typedef struct
+{
+    uint8_t u8Voice;
+    uint8_t u8Operator;
+} SynthCmdPayloadFmCopy_t;
+
+/** Payload definition for raw register write */
+typedef struct
+{
+    uint8_t u8Addr;
+    uint8_t u8Data;
+    uint8_t u8Bank;
+} SynthCmdPayloadRegWrite_t;
+
+/** Chip workloads measured on synth task, owned by synth until done callback */
+typedef struct SynthBench
+{
+    rtos_bench_t xReg;                                  /* Single register write */
+    rtos_bench_t xPreset;                               /* Full preset write */
+    rtos_bench_t xNote;                                 /* Note on */
+    void (* pxDoneCb)(struct SynthBench * pxBench);     /* Called from synth task after each run */
+} SynthBench_t;
+
+/** Payload definition for chip bench run */
+typedef struct
+{
+    SynthBench_t * pxBench;
+} SynthCmdPayloadBench_t;
+
 /** Union definitions with all event payload */
 typedef union
 {
@@ -97,6 +192,14 @@ typedef union
     SynthCmdPayloadVoiceUpdatePoly_t    xVoiceUpdatePoly;
     SynthCmdPayloadParamUpdate_t        xParamUpdate;
     SynthCmdPayloadPresetUpdate_t       xPresetUpdate;
+    SynthCmdPayloadPartPresetUpdate_t   xPartPresetUpdate;
+    SynthCmdPayloadRegUpdate_t          xRegUpdate;
+    SynthCmdPayloadStorageDone_t        xStorageDone;
+    SynthCmdPayloadVoicePitch_t         xVoicePitch;
+    SynthCmdPayloadFmParamSet_t         xFmParamSet;
+    SynthCmdPayloadFmCopy_t             xFmCopy;
+    SynthCmdPayloadRegWrite_t           xRegWrite;
+    SynthCmdPayloadBench_t              xBench;
 } SynthCmdPayload_t;
 
 /** Synth command definition */
@@ -114,6 +217,15 @@ typedef enum
     SYNTH_VOICE_CFG_NUM
 } SynthVoiceCfgMode_t;
 
+/** Synth velocity curves */
+typedef enum
+{
+    SYNTH_VEL_CURVE_LINEAR = 0x00U,
+    SYNTH_VEL_CURVE_EXP,
+    SYNTH_VEL_CURVE_FIXED,
+    SYNTH_VEL_CURVE_NUM
+} SynthVelCurve_t;
+
 /** Synth preset actions */
 typedef enum
 {
@@ -167,6 +279,14 @@ void vSynthTaskInit(void);
   */
 bool bSynthSendCmd(SynthCmd_t xSynthCmd);
 
+/**
+  * @brief Send a command to synth task from an interrupt.
+  * @param xSynthCmd Command to send.
+  * @return true cmd queue.
+  * @return false cmd not queue.
+  */
+bool bSynthSendCmdFromISR(SynthCmd_t xSynthCmd);
+
 /**
  * @brief Get internal synth task paramter.
  * @param u8ParamId: Id of parameter to get.
@@ -174,6 +294,27 @@ bool bSynthSendCmd(SynthCmd_t xSynthCmd);
  */
 SynthParam_t xSynthGetParam(uint8_t u8ParamId);
 
+/**
+ * @brief Get a consistent copy of FM chip state published by synth task.
+ * @param pxDevice destination of the copy.
+ * @param pu32Version published version, changes on every update, NULL if not needed.
+ * @return true copy done, false synth task was publishing, retry later.
+ */
+bool bSynthGetFmSnapshot(xFmDevice_t * pxDevice, uint32_t * pu32Version);
+
+/**
+ * @brief Get version of last published FM chip state.
+ * @return version, odd while synth task is publishing.
+ */
+uint32_t u32SynthGetFmVersion(void);
+
+/**
+ * @brief Get cycles from gate edge seen by mapping irq to key on written, RTOS_STATS_CLOCK_CYCLES resolution.
+ * @param pxBench where to copy measures.
+ * @param bReset clear measures after copy.
+ */
+void vSynthGetGateBench(rtos_bench_t * pxBench, bool bReset);
+
 #ifdef __cplusplus
 }
 #endif
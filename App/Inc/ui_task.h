@@ -43,6 +43,8 @@ extern "C" {
 #define UI_SIGNAL_RESTORE_CC            ( 1UL << 8U )
 #define UI_SIGNAL_ERROR                 ( 1UL << 9U )
 #define UI_SIGNAL_CMD                   ( 1UL << 10U )
+#define UI_SIGNAL_SCREEN_REFRESH        ( 1UL << 11U )
+#define UI_SIGNAL_BENCH                 ( 1UL << 12U )
 #define UI_SIGNAL_NOT_DEF               ( 1UL << 31U )
 #define UI_SIGNAL_ALL                   ( 0xFFFFFFFFU )
 
@@ -99,6 +101,14 @@ bool bUiTaskNotify(uint32_t u32Event);
   */
 bool bUiSendCmd(UiCmd_t xUiTaskCmd);
 
+/**
+  * @brief Get cycles spent on full renders requested with UI_SIGNAL_BENCH.
+  * @param pxBench where to copy measures.
+  * @param bReset clear measures after copy.
+  * @retval None.
+  */
+void vUiGetRenderBench(rtos_bench_t * pxBench, bool bReset);
+
 #ifdef __cplusplus
 }
 #endif
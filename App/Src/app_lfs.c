@@ -11,10 +11,16 @@
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <stddef.h>
+#include <string.h>
+
 #include "app_lfs.h"
 #include "lfs.h"
+#include "lfs_util.h"
 #include "user_error.h"
 #include "stm32g0xx_hal.h"
+#include "sys_rtos.h"
+#include "flash_driver.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
@@ -30,8 +36,39 @@
 #define LFS_LOOKAHEAD_SIZE      ( 8U )
 #define LFS_BLOCK_CYCLES        ( 500U )
 
+/* Initial value for preset data crc */
+#define LFS_YM_DIR_CRC_INIT     ( 0xFFFFFFFFU )
+
 /* Private macro -------------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+ * @brief Update a flash preset entry of RAM directory.
+ * 
+ * @param u8Slot slot to update.
+ * @param pxData preset data stored on slot.
+ */
+static void vLfsYmDirUpdate(uint8_t u8Slot, const lfs_ym_data_t *pxData);
+
+/**
+ * @brief Build RAM directory of flash and ROM presets, only done once after mount.
+ */
+static void vLfsYmDirBuild(void);
+
+/**
+ * @brief Get a RAM directory entry, caller must hold a critical section.
+ * 
+ * @param u8Bank preset bank, ROM or FLASH.
+ * @param u8Program preset position on bank.
+ * @return lfs_ym_dir_entry_t* entry, NULL if not valid.
+ */
+static lfs_ym_dir_entry_t * pxLfsYmDirGet(uint8_t u8Bank, uint8_t u8Program);
+
+/** Cycles flash was busy on file system operations, written by storage task.
+ *  Timed with stats timer, SysTick based cycle count can not move while flash stalls the core. */
+static rtos_bench_t xLfsEraseStall = { UINT32_MAX, 0U, 0U, 0U };
+static rtos_bench_t xLfsProgramStall = { UINT32_MAX, 0U, 0U, 0U };
+
 /* Private user code ---------------------------------------------------------*/
 
 /**
@@ -77,22 +114,31 @@ int ll_flash_prog(const struct lfs_config *c, lfs_block_t block, lfs_off_t off,
 
     int iRetval = 0U;
     uint32_t u32FlashAddr = LFS_FLASH_BASE_ADDR + (block * LFS_BLOCK_SIZE) + off;
-    uint64_t *pu64FlashData = (uint64_t *)u32FlashAddr;
-    uint64_t *pu64WriteData = (uint64_t *)buffer;
+    const uint8_t *pu8WriteData = (const uint8_t *)buffer;
     uint32_t u32NumTransfer = size / sizeof(uint64_t);
 
-    HAL_FLASH_Unlock();
-
+    /* One double word per flash operation, higher priority tasks run in between */
     while ( u32NumTransfer-- != 0 )
     {
-        if ( HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, (uint32_t)pu64FlashData++, *pu64WriteData++) != HAL_OK )
+        uint64_t u64Data = 0U;
+        uint32_t u32StartCount = 0U;
+        flash_status_t xFlashStatus = FLASH_DRIVER_ERROR;
+
+        memcpy(&u64Data, pu8WriteData, sizeof(u64Data));
+
+        u32StartCount = u32RtosStatsTimerGet();
+        xFlashStatus = xFLASH_WriteDoubleWord(u32FlashAddr, u64Data);
+        vRtosBenchAdd(&xLfsProgramStall, (u32RtosStatsTimerGet() - u32StartCount) * RTOS_STATS_CLOCK_CYCLES);
+
+        if ( xFlashStatus != FLASH_DRIVER_OK )
         {
             iRetval = -1;
             break;
         }
-    }
 
-    HAL_FLASH_Lock();
+        u32FlashAddr += sizeof(uint64_t);
+        pu8WriteData += sizeof(uint64_t);
+    }
 
     return iRetval;
 }
@@ -109,23 +155,16 @@ int ll_flash_erase(const struct lfs_config *c, lfs_block_t block)
 
     int iRetval = 0U;
     uint32_t u32PageNumber = LFS_PAGE_INIT + block;
-    uint32_t u32PageError = 0U;
-
-    /* Fill EraseInit structure */
-    FLASH_EraseInitTypeDef EraseInitStruct = {0};
-    EraseInitStruct.TypeErase = FLASH_TYPEERASE_PAGES;
-    EraseInitStruct.Page = u32PageNumber;
-    EraseInitStruct.NbPages = 1;
+    uint32_t u32StartCount = u32RtosStatsTimerGet();
+    flash_status_t xFlashStatus = xFLASH_ErasePage(u32PageNumber);
 
-    HAL_FLASH_Unlock();
+    vRtosBenchAdd(&xLfsEraseStall, (u32RtosStatsTimerGet() - u32StartCount) * RTOS_STATS_CLOCK_CYCLES);
 
-    if ( HAL_FLASHEx_Erase(&EraseInitStruct, &u32PageError) != HAL_OK )
+    if ( xFlashStatus != FLASH_DRIVER_OK )
     {
         iRetval = -1;
     }
 
-    HAL_FLASH_Lock();
-
     return iRetval;
 }
 
@@ -167,6 +206,9 @@ const struct lfs_config xLfsCfg = {
 /** Midi cfg filename */
 const char lfs_midi_cfg_filename[] = "midi_cfg";
 
+/** V/Oct calibration filename */
+const char lfs_cal_filename[] = "cal_voct";
+
 /** YM cfg filenames */
 const char *lfs_ym_cfg_filename[LFS_YM_SLOT_NUM] = {
     "ym_cfg_0",
@@ -176,6 +218,78 @@ const char *lfs_ym_cfg_filename[LFS_YM_SLOT_NUM] = {
     "ym_cfg_4",
 };
 
+/** Preset directory, avoid flash access to browse presets */
+static lfs_ym_dir_entry_t xYmDirFlash[LFS_YM_SLOT_NUM] = { 0U };
+static lfs_ym_dir_entry_t xYmDirRom[SYNTH_APP_DATA_CONST_MAX_NUM_ELEMENTS] = { 0U };
+static char cYmDirFlashName[LFS_YM_SLOT_NUM][LFS_YM_CF_NAME_MAX_LEN + 1U] = { 0U };
+static bool bYmDirReady = false;
+
+/* Private user code ---------------------------------------------------------*/
+
+static void vLfsYmDirUpdate(uint8_t u8Slot, const lfs_ym_data_t *pxData)
+{
+    lfs_ym_dir_entry_t * pxEntry = &xYmDirFlash[u8Slot];
+    uint32_t u32Crc = LFS_get_ym_crc(&pxData->xPresetData);
+
+    /* UI task reads names while storage task writes them */
+    taskENTER_CRITICAL();
+
+    /* Name on file may not be null terminated */
+    (void)memcpy(cYmDirFlashName[u8Slot], pxData->pu8Name, LFS_YM_CF_NAME_MAX_LEN);
+    cYmDirFlashName[u8Slot][LFS_YM_CF_NAME_MAX_LEN] = 0U;
+
+    pxEntry->pcName = cYmDirFlashName[u8Slot];
+    pxEntry->u32Crc = u32Crc;
+    pxEntry->u16Size = sizeof(lfs_ym_data_t);
+    pxEntry->bValid = true;
+
+    taskEXIT_CRITICAL();
+}
+
+static void vLfsYmDirBuild(void)
+{
+    if (!bYmDirReady)
+    {
+        lfs_ym_data_t xYmData;
+
+        for (uint8_t u8Slot = 0U; u8Slot < (uint8_t)LFS_YM_SLOT_NUM; u8Slot++)
+        {
+            if (LFS_read_ym_data(u8Slot, &xYmData) == LFS_OK)
+            {
+                vLfsYmDirUpdate(u8Slot, &xYmData);
+            }
+        }
+
+        for (uint8_t u8Preset = 0U; u8Preset < SYNTH_APP_DATA_CONST_MAX_NUM_ELEMENTS; u8Preset++)
+        {
+            lfs_ym_dir_entry_t * pxEntry = &xYmDirRom[u8Preset];
+
+            pxEntry->pcName = pxSYNTH_APP_DATA_CONST_get_name(u8Preset);
+            pxEntry->u32Crc = LFS_get_ym_crc(pxSYNTH_APP_DATA_CONST_get(u8Preset));
+            pxEntry->u16Size = sizeof(xFmDevice_t);
+            pxEntry->bValid = (pxEntry->pcName != NULL);
+        }
+
+        bYmDirReady = true;
+    }
+}
+
+static lfs_ym_dir_entry_t * pxLfsYmDirGet(uint8_t u8Bank, uint8_t u8Program)
+{
+    lfs_ym_dir_entry_t * pxEntry = NULL;
+
+    if ( (u8Bank == LFS_MIDI_BANK_FLASH) && (u8Program < (uint8_t)LFS_YM_SLOT_NUM) && xYmDirFlash[u8Program].bValid )
+    {
+        pxEntry = &xYmDirFlash[u8Program];
+    }
+    else if ( (u8Bank == LFS_MIDI_BANK_ROM) && (u8Program < SYNTH_APP_DATA_CONST_MAX_NUM_ELEMENTS) && xYmDirRom[u8Program].bValid )
+    {
+        pxEntry = &xYmDirRom[u8Program];
+    }
+
+    return pxEntry;
+}
+
 /* Callback ------------------------------------------------------------------*/
 /* Public user code ----------------------------------------------------------*/
 
@@ -245,6 +359,8 @@ lfs_status_t LFS_init(void)
                 }
             }
         }
+
+        vLfsYmDirBuild();
     }
 
     return eRetval;
@@ -302,13 +418,69 @@ lfs_status_t LFS_write_midi_data(lfs_midi_data_t *pxData)
     return LFS_OK;
 }
 
+lfs_status_t LFS_read_cal_data(lfs_cal_data_t *pxData)
+{
+    int err = lfs_file_open(&xLfs, &xFile, lfs_cal_filename, LFS_O_RDONLY);
+
+    /* Not calibrated units have no file */
+    if ( err != LFS_ERR_OK )
+    {
+        return LFS_ERROR;
+    }
+
+    err = lfs_file_read( &xLfs, &xFile, pxData, sizeof(lfs_cal_data_t) );
+    if ( err != sizeof(lfs_cal_data_t) )
+    {
+        (void)lfs_file_close( &xLfs, &xFile );
+        return LFS_ERROR;
+    }
+
+    err = lfs_file_close( &xLfs, &xFile );
+    if ( err != LFS_ERR_OK )
+    {
+        return LFS_ERROR;
+    }
+
+    return LFS_OK;
+}
+
+lfs_status_t LFS_write_cal_data(lfs_cal_data_t *pxData)
+{
+    int err = lfs_file_open(&xLfs, &xFile, lfs_cal_filename, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+
+    if ( err != LFS_ERR_OK )
+    {
+        return LFS_ERROR;
+    }
+
+    err = lfs_file_write( &xLfs, &xFile, pxData, sizeof(lfs_cal_data_t) );
+    if ( err != sizeof(lfs_cal_data_t) )
+    {
+        (void)lfs_file_close( &xLfs, &xFile );
+        return LFS_ERROR;
+    }
+
+    err = lfs_file_close( &xLfs, &xFile );
+    if ( err != LFS_ERR_OK )
+    {
+        return LFS_ERROR;
+    }
+
+    return LFS_OK;
+}
+
 lfs_status_t LFS_read_ym_data(uint8_t u8Slot, lfs_ym_data_t *pxData)
 {
     ERR_ASSERT( u8Slot < (uint8_t)LFS_YM_SLOT_NUM );
 
-    int err = lfs_file_open(&xLfs, &xFile, lfs_ym_cfg_filename[u8Slot], LFS_O_RDWR);
+    int err = lfs_file_open(&xLfs, &xFile, lfs_ym_cfg_filename[u8Slot], LFS_O_RDONLY);
 
-    if ( err == LFS_ERR_OK )
+    /* Slot could be deleted */
+    if ( err != LFS_ERR_OK )
+    {
+        return LFS_ERROR;
+    }
+    else
     {
         int err = lfs_file_rewind( &xLfs, &xFile );
         if (err != LFS_ERR_OK)
@@ -332,11 +504,49 @@ lfs_status_t LFS_read_ym_data(uint8_t u8Slot, lfs_ym_data_t *pxData)
     return LFS_OK;
 }
 
+lfs_status_t LFS_read_ym_channel(uint8_t u8Slot, uint8_t u8Channel, xFmChannel_t *pxData)
+{
+    ERR_ASSERT( u8Slot < (uint8_t)LFS_YM_SLOT_NUM );
+    ERR_ASSERT( u8Channel < (uint8_t)YM2612_NUM_CHANNEL );
+
+    int err = lfs_file_open(&xLfs, &xFile, lfs_ym_cfg_filename[u8Slot], LFS_O_RDONLY);
+
+    if ( err != LFS_ERR_OK )
+    {
+        return LFS_ERROR;
+    }
+
+    // Seek to channel data, skip name and the rest of the channels
+    lfs_soff_t xOffset = offsetof(lfs_ym_data_t, xPresetData.xChannel) + ( u8Channel * sizeof(xFmChannel_t) );
+
+    err = lfs_file_seek( &xLfs, &xFile, xOffset, LFS_SEEK_SET );
+    if ( err != xOffset )
+    {
+        (void)lfs_file_close( &xLfs, &xFile );
+        return LFS_ERROR;
+    }
+
+    err = lfs_file_read( &xLfs, &xFile, pxData, sizeof(xFmChannel_t) );
+    if ( err != sizeof(xFmChannel_t) )
+    {
+        (void)lfs_file_close( &xLfs, &xFile );
+        return LFS_ERROR;
+    }
+
+    err = lfs_file_close( &xLfs, &xFile );
+    if ( err != LFS_ERR_OK )
+    {
+        return LFS_ERROR;
+    }
+
+    return LFS_OK;
+}
+
 lfs_status_t LFS_write_ym_data(uint8_t u8Slot, lfs_ym_data_t *pxData)
 {
     ERR_ASSERT( u8Slot < (uint8_t)LFS_YM_SLOT_NUM );
 
-    int err = lfs_file_open(&xLfs, &xFile, lfs_ym_cfg_filename[u8Slot], LFS_O_RDWR);
+    int err = lfs_file_open(&xLfs, &xFile, lfs_ym_cfg_filename[u8Slot], LFS_O_RDWR | LFS_O_CREAT);
 
     if ( err == LFS_ERR_OK )
     {
@@ -357,9 +567,105 @@ lfs_status_t LFS_write_ym_data(uint8_t u8Slot, lfs_ym_data_t *pxData)
         {
             return LFS_ERROR;
         }
+
+        /* Directory is only refreshed on write */
+        vLfsYmDirUpdate(u8Slot, pxData);
+    }
+
+    return LFS_OK;
+}
+
+lfs_status_t LFS_delete_ym_data(uint8_t u8Slot)
+{
+    ERR_ASSERT( u8Slot < (uint8_t)LFS_YM_SLOT_NUM );
+
+    int err = lfs_remove(&xLfs, lfs_ym_cfg_filename[u8Slot]);
+
+    if ( (err != LFS_ERR_OK) && (err != LFS_ERR_NOENT) )
+    {
+        return LFS_ERROR;
     }
 
+    xYmDirFlash[u8Slot].bValid = false;
+
     return LFS_OK;
 }
 
+lfs_status_t LFS_get_ym_dir_entry(uint8_t u8Bank, uint8_t u8Program, lfs_ym_dir_entry_t *pxEntry)
+{
+    ERR_ASSERT( pxEntry != NULL );
+
+    lfs_status_t eRetval = LFS_ERROR;
+    const lfs_ym_dir_entry_t * pxDirEntry = NULL;
+
+    taskENTER_CRITICAL();
+    pxDirEntry = pxLfsYmDirGet(u8Bank, u8Program);
+    if ( pxDirEntry != NULL )
+    {
+        *pxEntry = *pxDirEntry;
+        eRetval = LFS_OK;
+    }
+    taskEXIT_CRITICAL();
+
+    return eRetval;
+}
+
+bool LFS_set_ym_first_load(uint8_t u8Slot, uint32_t u32LoadUs)
+{
+    ERR_ASSERT( u8Slot < (uint8_t)LFS_YM_SLOT_NUM );
+
+    bool bFirst = false;
+
+    taskENTER_CRITICAL();
+    if ( xYmDirFlash[u8Slot].bValid && (xYmDirFlash[u8Slot].u32FirstLoadUs == 0U) )
+    {
+        xYmDirFlash[u8Slot].u32FirstLoadUs = u32LoadUs;
+        bFirst = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return bFirst;
+}
+
+uint32_t LFS_get_ym_crc(const xFmDevice_t *pxData)
+{
+    return lfs_crc(LFS_YM_DIR_CRC_INIT, pxData, sizeof(xFmDevice_t));
+}
+
+const char * LFS_get_ym_name(uint8_t u8Bank, uint8_t u8Program, char *pcName, size_t xLen)
+{
+    ERR_ASSERT( pcName != NULL );
+    ERR_ASSERT( xLen != 0U );
+
+    const lfs_ym_dir_entry_t * pxDirEntry = NULL;
+
+    pcName[0U] = 0;
+
+    /* Flash names can be rewritten by storage task, copy them while it can not run */
+    taskENTER_CRITICAL();
+    pxDirEntry = pxLfsYmDirGet(u8Bank, u8Program);
+    if ( pxDirEntry != NULL )
+    {
+        (void)strncpy(pcName, pxDirEntry->pcName, xLen - 1U);
+        pcName[xLen - 1U] = 0;
+    }
+    taskEXIT_CRITICAL();
+
+    return pcName;
+}
+
+void LFS_get_flash_stall(rtos_bench_t *pxErase, rtos_bench_t *pxProgram)
+{
+    taskENTER_CRITICAL();
+    if ( pxErase != NULL )
+    {
+        *pxErase = xLfsEraseStall;
+    }
+    if ( pxProgram != NULL )
+    {
+        *pxProgram = xLfsProgramStall;
+    }
+    taskEXIT_CRITICAL();
+}
+
 /* EOF */
@@ -12,8 +12,15 @@
 #include "FreeRTOS_CLI.h"
 
 #include "cli_task.h"
+#include "sys_rtos.h"
 #include "synth_task.h"
 #include "midi_task.h"
+#include "mapping_task.h"
+#include "storage_task.h"
+#include "ui_task.h"
+#include "ui_sys.h"
+#include "crash_store.h"
+#include "midi_lib.h"
 
 #include <stdlib.h>
 #include "printf.h"
@@ -23,7 +30,71 @@
 #include "user_error.h"
 
 /* Private typedef -----------------------------------------------------------*/
+
+/** Flash preset load state, buffer is owned by storage task while busy */
+typedef enum
+{
+    CLI_PRESET_IDLE = 0x00U,
+    CLI_PRESET_BUSY,
+    CLI_PRESET_OK,
+    CLI_PRESET_ERROR,
+} CliPresetLoad_t;
+
+/** Workloads measured by bench command, same order as printed */
+typedef enum
+{
+    CLI_BENCH_REG = 0x00U,
+    CLI_BENCH_PRESET,
+    CLI_BENCH_NOTE,
+    CLI_BENCH_MIDI,
+    CLI_BENCH_PARAM,
+    CLI_BENCH_RENDER,
+    CLI_BENCH_PUSH,
+    CLI_BENCH_LFS,
+    CLI_BENCH_ERASE,
+    CLI_BENCH_PROG,
+    CLI_BENCH_GATE,
+    CLI_BENCH_NUM,
+} CliBench_t;
+
 /* Private define ------------------------------------------------------------*/
+
+/* Max number of tasks shown by top command */
+#define CLI_TOP_MAX_TASKS               ( 10U )
+
+/* Top refresh period limit, seconds */
+#define CLI_TOP_MAX_PERIOD_S            ( 60U )
+
+/* Command run on top periodic refresh */
+#define CLI_TOP_PERIODIC_CMD            "top"
+
+/* Crash dump bytes printed per line */
+#define CLI_CRASH_LINE_BYTES            ( 32U )
+
+/* Registers printed per regdump line, lines are aligned to it */
+#define CLI_REG_LINE_REGS               ( 16U )
+#define CLI_REG_LINE_FIRST              ( YM2612_REG_FIRST & ~(CLI_REG_LINE_REGS - 1U) )
+#define CLI_REG_LINES_BANK              ( ((YM2612_REG_LAST - CLI_REG_LINE_FIRST) / CLI_REG_LINE_REGS) + 1U )
+
+/* Mark of regdump binary frame */
+#define CLI_REG_FRAME_MARK              "\r\n###REGS###"
+
+/* Max time waiting a flash preset load, ms */
+#define CLI_PRESET_LOAD_TIMEOUT         ( 1000U )
+
+/* Bench runs of each workload, default and max */
+#define CLI_BENCH_RUNS                  ( 16U )
+#define CLI_BENCH_RUNS_MAX              ( 64U )
+
+/* Bench midi input is pattern repeated up to 1 KB */
+#define CLI_BENCH_MIDI_REPEAT           ( 1024U / sizeof(pu8BenchMidiPattern) )
+#define CLI_BENCH_MIDI_BATCH            ( 8U )
+
+/* Max time waiting synth or ui task for a bench run, ms */
+#define CLI_BENCH_TASK_TIMEOUT          ( 100U )
+
+/* Core cycles per us, used to show bench averages */
+#define CLI_BENCH_CYCLES_US             ( configCPU_CLOCK_HZ / 1000000U )
 /* Private macro -------------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 
@@ -90,8 +161,167 @@ static BaseType_t midiCc(char *pcWriteBuffer, size_t xWriteBufferLen, const char
  */
 static BaseType_t midiChangeMode(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
 
+/**
+ * @brief  V/Oct input calibration.
+ * @param  pcWriteBuffer
+ * @param  xWriteBufferLen
+ * @param  pcCommandString
+ * @retval pdFALSE, pdTRUE
+ */
+static BaseType_t vOctCal(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief  Show cpu usage per task, stack and heap usage.
+ * @param  pcWriteBuffer
+ * @param  xWriteBufferLen
+ * @param  pcCommandString
+ * @retval pdFALSE, pdTRUE
+ */
+static BaseType_t showTop(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief  Top refresh timer callback.
+ * @param  xTimer timer handler.
+ * @retval None.
+ */
+static void vTopTimerCallback(TimerHandle_t xTimer);
+
+/**
+ * @brief  Show or clear crash dump stored on flash.
+ * @param  pcWriteBuffer
+ * @param  xWriteBufferLen
+ * @param  pcCommandString
+ * @retval pdFALSE, pdTRUE
+ */
+static BaseType_t showCrash(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief  Crash clear done callback, storage task context.
+ * @param  pxCmd request done.
+ * @param  bResult request result.
+ * @retval None.
+ */
+static void vCrashClearDone(const StorageCmd_t * pxCmd, bool bResult);
+
+/**
+ * @brief  Show YM2612 register mirror.
+ * @param  pcWriteBuffer
+ * @param  xWriteBufferLen
+ * @param  pcCommandString
+ * @retval pdFALSE, pdTRUE
+ */
+static BaseType_t regDump(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief  Compare YM2612 register mirror against a preset.
+ * @param  pcWriteBuffer
+ * @param  xWriteBufferLen
+ * @param  pcCommandString
+ * @retval pdFALSE, pdTRUE
+ */
+static BaseType_t regDiff(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief  Flash preset load done callback, storage task context.
+ * @param  pxCmd request done.
+ * @param  bResult request result.
+ * @retval None.
+ */
+static void vCliPresetLoadDone(const StorageCmd_t * pxCmd, bool bResult);
+
+/**
+ * @brief  Load a flash preset on shared preset buffer through storage task.
+ * @param  u8Slot preset slot.
+ * @param  pu32Cycles cycles from request to done callback, NULL if not used.
+ * @retval true preset loaded, false ioc.
+ */
+static bool bCliLoadPreset(uint8_t u8Slot, uint32_t * pu32Cycles);
+
+/**
+ * @brief  Measure cost of main synth workloads.
+ * @param  pcWriteBuffer
+ * @param  xWriteBufferLen
+ * @param  pcCommandString
+ * @retval pdFALSE, pdTRUE
+ */
+static BaseType_t runBench(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+/**
+ * @brief  Run all bench workloads and store measures.
+ * @param  u32Runs runs of each workload.
+ * @retval None.
+ */
+static void vBenchRun(uint32_t u32Runs);
+
+/**
+ * @brief  Synth bench run done, called from synth task.
+ * @param  pxBench measures of the run.
+ * @retval None.
+ */
+static void vBenchSynthDone(SynthBench_t * pxBench);
+
 /* Private variables ---------------------------------------------------------*/
 
+/* RAM layout, from linker file */
+extern uint32_t _sdata[];
+extern uint32_t _end[];
+extern uint32_t _estack[];
+
+/* Top status, line being printed and run time of previous sample */
+static TaskStatus_t xTopTaskStatus[CLI_TOP_MAX_TASKS];
+static UBaseType_t uxTopTaskNum = 0U;
+static UBaseType_t uxTopLine = 0U;
+static uint32_t u32TopWindow = 0U;
+static uint32_t u32TopPrevTotal = 0U;
+static UBaseType_t uxTopPrevTaskNumber[CLI_TOP_MAX_TASKS] = { 0U };
+static uint32_t u32TopPrevRunTime[CLI_TOP_MAX_TASKS] = { 0U };
+
+/* Top periodic refresh timer */
+static TimerHandle_t xTopTimer = NULL;
+static StaticTimer_t xTopTimerCtrl;
+
+/* Crash dump line being printed, 0 for header */
+static uint32_t u32CrashLine = 0U;
+
+/* Regdump line being printed */
+static uint32_t u32RegDumpLine = 0U;
+
+/* Regdiff state, next register to compare and preset used as reference */
+static uint32_t u32RegDiffPos = 0U;
+static uint32_t u32RegDiffCount = 0U;
+static uint32_t u32RegDiffNum = 0U;
+static const xFmDevice_t * pxRegDiffRef = NULL;
+
+/* Flash preset shared by commands, load state set from storage task */
+static lfs_ym_data_t xCliPresetBuffer;
+static volatile CliPresetLoad_t eCliPresetLoad = CLI_PRESET_IDLE;
+static volatile uint32_t u32CliPresetDoneCycles = 0U;
+
+/* Bench measures and line being printed, 0 for header */
+static rtos_bench_t xCliBench[CLI_BENCH_NUM];
+static uint32_t u32BenchLine = 0U;
+static volatile uint8_t u8BenchSink = 0U;
+
+/* Chip measures, written by synth task until each run is done */
+static SynthBench_t xCliSynthBench = { .pxDoneCb = vBenchSynthDone };
+static volatile uint32_t u32CliSynthBenchDone = 0U;
+
+/* Bench line titles */
+static const char * const pcBenchName[CLI_BENCH_NUM] = { "REG", "PRESET", "NOTE", "MIDI1K", "PARAM", "RENDER", "PUSH", "LFS", "ERASE", "PROG", "GATE" };
+
+/* Bench midi input: running status notes, cc, pitch bend, program, pressure and clock */
+static const uint8_t pu8BenchMidiPattern[] =
+{
+    0x90U, 0x3CU, 0x64U, 0x3CU, 0x00U, 0x40U, 0x64U, 0x40U, 0x00U,
+    0xB0U, 0x01U, 0x40U, 0x01U, 0x41U, 0x14U, 0x20U,
+    0xE0U, 0x00U, 0x40U, 0x7FU, 0x7FU,
+    0xF8U,
+    0x80U, 0x43U, 0x00U, 0x47U, 0x00U,
+    0xC0U, 0x05U,
+    0xD0U, 0x30U,
+    0xF8U,
+};
+
 static const CLI_Command_Definition_t xDevReset = {
     "reset",
     "reset:\tForce device reset",
@@ -141,6 +371,70 @@ static const CLI_Command_Definition_t xMidiChangeMode = {
     1U
 };
 
+static const CLI_Command_Definition_t xTop = {
+    "top",
+    "top:\tShow per task cpu run time and stack high water, static RAM, use: top [refresh period 1-60 s, 0 stop]",
+    showTop,
+    -1
+};
+
+static const CLI_Command_Definition_t xCrash = {
+    "crash",
+    "crash:\tShow crash dump kept from a previous run, use: crash [clear]",
+    showCrash,
+    -1
+};
+
+static const CLI_Command_Definition_t xRegDump = {
+    "regdump",
+    "regdump:\tShow last values written on YM2612 registers, use: regdump [bin]",
+    regDump,
+    -1
+};
+
+static const CLI_Command_Definition_t xRegDiff = {
+    "regdiff",
+    "regdiff:\tCompare YM2612 registers against a preset, use: regdiff <bank 0 ROM, 1 FLASH> <program>",
+    regDiff,
+    2U
+};
+
+static const CLI_Command_Definition_t xBench = {
+    "bench",
+    "bench:\tMeasure synth workloads in core cycles, use: bench [runs]",
+    runBench,
+    -1
+};
+
+static const CLI_Command_Definition_t xVOctCal = {
+    "vcal",
+    "vcal:\tV/Oct calibration, apply a known voltage and use: vcal <ch 0-3> <0 low point, 1 high point and save, 2 reset> <note 0-127>",
+    vOctCal,
+    3U
+};
+
+/* Registered commands, help shows them in this order */
+static const CLI_Command_Definition_t * const pxCliCommands[] = {
+    &xDevReset,
+    &xWriteReg,
+    &xUserAssert,
+    &xUserFault,
+    &xVersion,
+    &xMidiCc,
+    &xMidiChangeMode,
+    &xVOctCal,
+    &xTop,
+    &xCrash,
+    &xRegDump,
+    &xRegDiff,
+    &xBench,
+};
+
+#define CLI_CMD_NUM                     ( sizeof(pxCliCommands) / sizeof(pxCliCommands[0U]) )
+
+/* Command list items, kept registered forever */
+static CLI_Definition_List_Item_t xCliCommandItems[CLI_CMD_NUM];
+
 /* Callbacks -----------------------------------------------------------------*/
 /* Private application code --------------------------------------------------*/
 
@@ -181,11 +475,22 @@ static BaseType_t YM2612Write(char *pcWriteBuffer,
     /* Check parameters */
     if ((u8bankSel == YM2612_BANK_0) || u8bankSel == YM2612_BANK_1)
     {
-        YM2612_bank_t xbankValue = (u8bankSel == YM2612_BANK_0)?YM2612_BANK_0:YM2612_BANK_1;
-        
-        vYM2612_write_reg(u8regAddr, u8regData, xbankValue);
-        
-        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "OK");
+        /* Chip is only driven from synth task */
+        SynthCmd_t xSynthCmd = {
+            .eCmd = SYNTH_CMD_REG_WRITE,
+            .uPayload.xRegWrite.u8Addr = u8regAddr,
+            .uPayload.xRegWrite.u8Data = u8regData,
+            .uPayload.xRegWrite.u8Bank = u8bankSel
+        };
+
+        if ( bSynthSendCmd(xSynthCmd) )
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "OK");
+        }
+        else
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "ERROR: Synth busy");
+        }
     }
     else
     {
@@ -288,6 +593,50 @@ static BaseType_t midiChangeMode(char *pcWriteBuffer, size_t xWriteBufferLen, co
     return pdFALSE;
 }
 
+static BaseType_t vOctCal(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    uint8_t u8Channel;
+    uint8_t u8Step;
+    uint8_t u8Note;
+    char *pcParameter1;
+    char *pcParameter2;
+    char *pcParameter3;
+    BaseType_t xParameter1StringLength;
+    BaseType_t xParameter2StringLength;
+    BaseType_t xParameter3StringLength;
+
+    /* Get cmd parameters */
+    pcParameter1 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 1U, &xParameter1StringLength);
+    pcParameter2 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 2U, &xParameter2StringLength);
+    pcParameter3 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 3U, &xParameter3StringLength);
+    pcParameter1[xParameter1StringLength] = 0U;
+    pcParameter2[xParameter2StringLength] = 0U;
+    pcParameter3[xParameter3StringLength] = 0U;
+    u8Channel = (uint8_t)atoi(pcParameter1);
+    u8Step = (uint8_t)atoi(pcParameter2);
+    u8Note = (uint8_t)atoi(pcParameter3);
+
+    if ( u8Channel >= MAP_CH_NUM )
+    {
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "ERROR: Not valid channel");
+    }
+    else if ( u8Step == MAP_CAL_POINT_NUM )
+    {
+        vMapCalReset(u8Channel);
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "OK");
+    }
+    else if ( bMapCalSetPoint(u8Channel, u8Step, u8Note) )
+    {
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "OK");
+    }
+    else
+    {
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "ERROR: Not valid point");
+    }
+
+    return pdFALSE;
+}
+
 static BaseType_t showVersion(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
 {
     vCliPrintf(CLI_TASK_NAME, "APP %s", MAIN_APP_VERSION);
@@ -296,17 +645,549 @@ static BaseType_t showVersion(char *pcWriteBuffer, size_t xWriteBufferLen, const
     return pdFALSE;
 }
 
+static void vTopTimerCallback(TimerHandle_t xTimer)
+{
+    (void)bCliNotifyPeriodic();
+}
+
+static BaseType_t showTop(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t xRetval = pdTRUE;
+
+    if ( uxTopLine == 0U )
+    {
+        char *pcParameter1;
+        BaseType_t xParameter1StringLength = 0;
+        uint32_t u32Total = 0U;
+
+        /* Optional refresh period */
+        pcParameter1 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 1U, &xParameter1StringLength);
+
+        if ( pcParameter1 != NULL )
+        {
+            uint32_t u32Period = (uint32_t)atoi(pcParameter1);
+
+            if ( u32Period == 0U )
+            {
+                (void)xTimerStop(xTopTimer, 0U);
+            }
+            else if ( u32Period <= CLI_TOP_MAX_PERIOD_S )
+            {
+                (void)xTimerChangePeriod(xTopTimer, pdMS_TO_TICKS(u32Period * 1000U), 0U);
+            }
+        }
+
+        /* Sample all tasks, cpu usage is computed over time since previous sample */
+        uxTopTaskNum = uxTaskGetSystemState(xTopTaskStatus, CLI_TOP_MAX_TASKS, &u32Total);
+        u32TopWindow = u32Total - u32TopPrevTotal;
+        u32TopPrevTotal = u32Total;
+
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "TOP: %d tasks, %d ms\r\nTASK   PRIO  STATE  CPU     STACK", (int)uxTopTaskNum, (int)(u32TopWindow / (RTOS_STATS_CLOCK_HZ / 1000U)));
+        uxTopLine++;
+    }
+    else if ( uxTopLine <= uxTopTaskNum )
+    {
+        const TaskStatus_t * pxStatus = &xTopTaskStatus[uxTopLine - 1U];
+        const char pcState[] = { 'X', 'R', 'B', 'S', 'D', '?' };
+        uint32_t u32PrevRunTime = 0U;
+        uint32_t u32Permil = 0U;
+
+        for (UBaseType_t uxIndex = 0U; uxIndex < CLI_TOP_MAX_TASKS; uxIndex++)
+        {
+            if ( uxTopPrevTaskNumber[uxIndex] == pxStatus->xTaskNumber )
+            {
+                u32PrevRunTime = u32TopPrevRunTime[uxIndex];
+            }
+        }
+
+        if ( u32TopWindow >= 1000U )
+        {
+            u32Permil = (pxStatus->ulRunTimeCounter - u32PrevRunTime) / (u32TopWindow / 1000U);
+        }
+
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "%-5s  %d     %c      %3d.%d%%  %d",
+                        pxStatus->pcTaskName, (int)pxStatus->uxCurrentPriority,
+                        pcState[(pxStatus->eCurrentState < eInvalid) ? pxStatus->eCurrentState : eInvalid],
+                        (int)(u32Permil / 10U), (int)(u32Permil % 10U), (int)pxStatus->usStackHighWaterMark);
+        uxTopLine++;
+    }
+    else
+    {
+        /* Keep sample for next call */
+        for (UBaseType_t uxIndex = 0U; uxIndex < CLI_TOP_MAX_TASKS; uxIndex++)
+        {
+            uxTopPrevTaskNumber[uxIndex] = (uxIndex < uxTopTaskNum) ? xTopTaskStatus[uxIndex].xTaskNumber : 0U;
+            u32TopPrevRunTime[uxIndex] = (uxIndex < uxTopTaskNum) ? xTopTaskStatus[uxIndex].ulRunTimeCounter : 0U;
+        }
+
+        /* Kernel objects are static, RAM left after them is main stack and libc heap */
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "RAM: static %d, main stack %d",
+                        (int)((uint32_t)_end - (uint32_t)_sdata), (int)((uint32_t)_estack - (uint32_t)_end));
+        uxTopLine = 0U;
+        xRetval = pdFALSE;
+    }
+
+    return xRetval;
+}
+
+static void vCrashClearDone(const StorageCmd_t * pxCmd, bool bResult)
+{
+    vCliPrintf(CLI_TASK_NAME, "CRASH: clear %s", bResult ? "OK" : "ERROR");
+}
+
+static BaseType_t showCrash(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t xRetval = pdTRUE;
+    const crash_record_t * pxRecord = pxCrashStoreGet();
+    uint32_t u32Start = (u32CrashLine - 1U) * CLI_CRASH_LINE_BYTES;
+
+    if ( u32CrashLine == 0U )
+    {
+        char *pcParameter1;
+        BaseType_t xParameter1StringLength = 0;
+
+        pcParameter1 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 1U, &xParameter1StringLength);
+
+        if ( pcParameter1 != NULL )
+        {
+            if ( strncmp(pcParameter1, "clear", xParameter1StringLength) == 0 )
+            {
+                /* Storage task owns flash, erase is done there */
+                StorageCmd_t xStorageCmd = { .eCmd = STORAGE_CMD_CRASH_CLEAR, .pxDoneCb = vCrashClearDone };
+
+                (void)snprintf(pcWriteBuffer, xWriteBufferLen, "CRASH: clear %s", bStorageSendCmd(xStorageCmd) ? "requested" : "ERROR");
+            }
+            else
+            {
+                (void)snprintf(pcWriteBuffer, xWriteBufferLen, "CRASH: unknown option");
+            }
+            xRetval = pdFALSE;
+        }
+        else if ( pxRecord == NULL )
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "CRASH: none stored");
+            xRetval = pdFALSE;
+        }
+        else
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "CRASH: task %.*s, TCB 0x%08X, %d bytes\r\n###CRASH###",
+                            (int)CRASH_STORE_NAME_LEN, pxRecord->pcTaskName, (unsigned int)pxRecord->u32TcbAddr, (int)pxRecord->u32Len);
+            u32CrashLine++;
+        }
+    }
+    else if ( (pxRecord != NULL) && (u32Start < pxRecord->u32Len) )
+    {
+        uint32_t u32End = u32Start + CLI_CRASH_LINE_BYTES;
+        size_t xLen = 0U;
+
+        if ( u32End > pxRecord->u32Len )
+        {
+            u32End = pxRecord->u32Len;
+        }
+
+        /* Same hex format as CrashCatcher UART dump */
+        for (uint32_t u32Index = u32Start; (u32Index < u32End) && ((xLen + 3U) <= xWriteBufferLen); u32Index++)
+        {
+            xLen += (size_t)snprintf(&pcWriteBuffer[xLen], xWriteBufferLen - xLen, "%02X", pxRecord->pu8Data[u32Index]);
+        }
+
+        u32CrashLine++;
+    }
+    else
+    {
+        (void)snprintf(pcWriteBuffer, xWriteBufferLen, "###END###");
+        u32CrashLine = 0U;
+        xRetval = pdFALSE;
+    }
+
+    return xRetval;
+}
+
+static BaseType_t regDump(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t xRetval = pdTRUE;
+
+    if ( u32RegDumpLine == 0U )
+    {
+        char *pcParameter1;
+        BaseType_t xParameter1StringLength = 0;
+
+        pcParameter1 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 1U, &xParameter1StringLength);
+
+        if ( (pcParameter1 != NULL) && (strncmp(pcParameter1, "bin", xParameter1StringLength) == 0) )
+        {
+            /* Whole mirror on a single frame for host tools */
+            bool bSent = bCliWriteFrame(CLI_REG_FRAME_MARK, pu8YM2612_get_reg_mirror(), YM2612_NUM_BANK * YM2612_REG_NUM);
+
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "REGDUMP: %s", bSent ? "OK" : "ERROR");
+            xRetval = pdFALSE;
+        }
+        else
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "REGDUMP: first %02X, last %02X\r\nBK RG: +0 +1 +2 +3 +4 +5 +6 +7 +8 +9 +A +B +C +D +E +F",
+                            YM2612_REG_FIRST, YM2612_REG_LAST);
+            u32RegDumpLine++;
+        }
+    }
+    else
+    {
+        YM2612_bank_t xBank = (YM2612_bank_t)((u32RegDumpLine - 1U) / CLI_REG_LINES_BANK);
+        uint32_t u32Addr = CLI_REG_LINE_FIRST + (((u32RegDumpLine - 1U) % CLI_REG_LINES_BANK) * CLI_REG_LINE_REGS);
+        size_t xLen = (size_t)snprintf(pcWriteBuffer, xWriteBufferLen, "%d  %02X:", xBank, (unsigned int)u32Addr);
+
+        for (uint32_t u32Index = 0U; (u32Index < CLI_REG_LINE_REGS) && ((xLen + 4U) <= xWriteBufferLen); u32Index++)
+        {
+            uint8_t u8Data = 0U;
+
+            if ( bYM2612_get_reg((uint8_t)(u32Addr + u32Index), xBank, &u8Data) )
+            {
+                xLen += (size_t)snprintf(&pcWriteBuffer[xLen], xWriteBufferLen - xLen, " %02X", u8Data);
+            }
+            else
+            {
+                xLen += (size_t)snprintf(&pcWriteBuffer[xLen], xWriteBufferLen - xLen, " --");
+            }
+        }
+
+        u32RegDumpLine++;
+
+        if ( u32RegDumpLine > (YM2612_NUM_BANK * CLI_REG_LINES_BANK) )
+        {
+            u32RegDumpLine = 0U;
+            xRetval = pdFALSE;
+        }
+    }
+
+    return xRetval;
+}
+
+static void vCliPresetLoadDone(const StorageCmd_t * pxCmd, bool bResult)
+{
+    u32CliPresetDoneCycles = u32RtosGetCycles();
+    eCliPresetLoad = bResult ? CLI_PRESET_OK : CLI_PRESET_ERROR;
+}
+
+static bool bCliLoadPreset(uint8_t u8Slot, uint32_t * pu32Cycles)
+{
+    bool bRetval = false;
+
+    /* Request timed out before, buffer is still owned by storage */
+    if ( eCliPresetLoad != CLI_PRESET_BUSY )
+    {
+        StorageCmd_t xStorageCmd = { .eCmd = STORAGE_CMD_YM_LOAD, .u8Slot = u8Slot, .pvData = &xCliPresetBuffer, .pxDoneCb = vCliPresetLoadDone };
+        uint32_t u32StartCycles = u32RtosGetCycles();
+
+        /* Storage task owns flash, wait here for the preset */
+        eCliPresetLoad = CLI_PRESET_BUSY;
+
+        if ( bStorageSendCmd(xStorageCmd) )
+        {
+            for (uint32_t u32Wait = 0U; (eCliPresetLoad == CLI_PRESET_BUSY) && (u32Wait < CLI_PRESET_LOAD_TIMEOUT); u32Wait++)
+            {
+                vTaskDelay(pdMS_TO_TICKS(1U));
+            }
+
+            if ( eCliPresetLoad == CLI_PRESET_OK )
+            {
+                if ( pu32Cycles != NULL )
+                {
+                    *pu32Cycles = u32CliPresetDoneCycles - u32StartCycles;
+                }
+                bRetval = true;
+            }
+        }
+        else
+        {
+            eCliPresetLoad = CLI_PRESET_IDLE;
+        }
+    }
+
+    return bRetval;
+}
+
+static BaseType_t regDiff(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t xRetval = pdTRUE;
+
+    if ( pxRegDiffRef == NULL )
+    {
+        char *pcParameter1;
+        char *pcParameter2;
+        BaseType_t xParameter1StringLength = 0;
+        BaseType_t xParameter2StringLength = 0;
+        uint8_t u8Bank = 0U;
+        uint8_t u8Program = 0U;
+
+        pcParameter1 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 1U, &xParameter1StringLength);
+        pcParameter2 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 2U, &xParameter2StringLength);
+        u8Bank = (uint8_t)atoi(pcParameter1);
+        u8Program = (uint8_t)atoi(pcParameter2);
+
+        if ( u8Bank == (uint8_t)LFS_MIDI_BANK_ROM )
+        {
+            pxRegDiffRef = pxSYNTH_APP_DATA_CONST_get(u8Program);
+        }
+        else if ( (u8Bank == (uint8_t)LFS_MIDI_BANK_FLASH) && (u8Program < (uint8_t)LFS_YM_SLOT_NUM) )
+        {
+            if ( bCliLoadPreset(u8Program, NULL) )
+            {
+                pxRegDiffRef = &xCliPresetBuffer.xPresetData;
+            }
+        }
+
+        if ( pxRegDiffRef != NULL )
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "REGDIFF: bank %d, program %d\r\nBK RG: CHIP PRESET", u8Bank, u8Program);
+            u32RegDiffPos = 0U;
+            u32RegDiffCount = 0U;
+            u32RegDiffNum = 0U;
+        }
+        else
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "REGDIFF: preset not available");
+            xRetval = pdFALSE;
+        }
+    }
+    else
+    {
+        bool bFound = false;
+
+        /* Next register set by presets and holding a different value */
+        while ( !bFound && (u32RegDiffPos < (YM2612_NUM_BANK * YM2612_REG_NUM)) )
+        {
+            YM2612_bank_t xBank = (YM2612_bank_t)(u32RegDiffPos / YM2612_REG_NUM);
+            uint8_t u8Addr = (uint8_t)(YM2612_REG_FIRST + (u32RegDiffPos % YM2612_REG_NUM));
+            uint8_t u8Chip = 0U;
+            uint8_t u8Preset = 0U;
+
+            if ( bYM2612_get_preset_reg(pxRegDiffRef, u8Addr, xBank, &u8Preset) && bYM2612_get_reg(u8Addr, xBank, &u8Chip) )
+            {
+                u32RegDiffNum++;
+
+                if ( u8Chip != u8Preset )
+                {
+                    (void)snprintf(pcWriteBuffer, xWriteBufferLen, "%d  %02X: %02X   %02X", xBank, u8Addr, u8Chip, u8Preset);
+                    u32RegDiffCount++;
+                    bFound = true;
+                }
+            }
+
+            u32RegDiffPos++;
+        }
+
+        if ( !bFound )
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "REGDIFF: %d of %d registers differ", (int)u32RegDiffCount, (int)u32RegDiffNum);
+            pxRegDiffRef = NULL;
+            xRetval = pdFALSE;
+        }
+    }
+
+    return xRetval;
+}
+
+static void vBenchSynthDone(SynthBench_t * pxBench)
+{
+    u32CliSynthBenchDone++;
+}
+
+static void vBenchRun(uint32_t u32Runs)
+{
+    SynthCmd_t xSynthCmd = { .eCmd = SYNTH_CMD_BENCH, .uPayload.xBench.pxBench = &xCliSynthBench };
+    midi_parser_t xParser;
+    midi_msg_t xMsgBatch[CLI_BENCH_MIDI_BATCH];
+    uint32_t u32StartCycles = 0U;
+
+    for (uint32_t u32Index = 0U; u32Index < (uint32_t)CLI_BENCH_NUM; u32Index++)
+    {
+        vRtosBenchReset(&xCliBench[u32Index]);
+    }
+
+    (void)midi_init(&xParser, NULL, 0U, NULL, NULL, NULL, NULL);
+
+    /* Chip tests run inside synth task, it is the only chip writer */
+    vRtosBenchReset(&xCliSynthBench.xReg);
+    vRtosBenchReset(&xCliSynthBench.xPreset);
+    vRtosBenchReset(&xCliSynthBench.xNote);
+    u32CliSynthBenchDone = 0U;
+
+    for (uint32_t u32Run = 0U; u32Run < u32Runs; u32Run++)
+    {
+        if ( bSynthSendCmd(xSynthCmd) )
+        {
+            for (uint32_t u32Wait = 0U; (u32CliSynthBenchDone <= u32Run) && (u32Wait < CLI_BENCH_TASK_TIMEOUT); u32Wait++)
+            {
+                vTaskDelay(pdMS_TO_TICKS(1U));
+            }
+        }
+
+        if ( u32CliSynthBenchDone <= u32Run )
+        {
+            /* Synth did not answer, do not touch measures it may still write */
+            break;
+        }
+    }
+
+    if ( u32CliSynthBenchDone == u32Runs )
+    {
+        xCliBench[CLI_BENCH_REG] = xCliSynthBench.xReg;
+        xCliBench[CLI_BENCH_PRESET] = xCliSynthBench.xPreset;
+        xCliBench[CLI_BENCH_NOTE] = xCliSynthBench.xNote;
+    }
+
+    for (uint32_t u32Run = 0U; u32Run < u32Runs; u32Run++)
+    {
+        u32StartCycles = u32RtosGetCycles();
+        for (uint32_t u32Repeat = 0U; u32Repeat < CLI_BENCH_MIDI_REPEAT; u32Repeat++)
+        {
+            size_t xParsed = 0U;
+
+            while ( xParsed < sizeof(pu8BenchMidiPattern) )
+            {
+                size_t xUsed = 0U;
+
+                (void)midi_parse(&xParser, &pu8BenchMidiPattern[xParsed], sizeof(pu8BenchMidiPattern) - xParsed, xMsgBatch, CLI_BENCH_MIDI_BATCH, &xUsed);
+                xParsed += xUsed;
+            }
+        }
+        vRtosBenchAdd(&xCliBench[CLI_BENCH_MIDI], u32RtosGetCycles() - u32StartCycles);
+
+        /* Sweep adc range over runs */
+        u32StartCycles = u32RtosGetCycles();
+        u8BenchSink ^= u8MapBenchParamValues((uint16_t)((u32Run * 4095U) / u32Runs));
+        vRtosBenchAdd(&xCliBench[CLI_BENCH_PARAM], u32RtosGetCycles() - u32StartCycles);
+    }
+
+    /* Render is measured inside ui task, it owns the display */
+    vUiGetRenderBench(&xCliBench[CLI_BENCH_RENDER], true);
+
+    for (uint32_t u32Run = 0U; u32Run < u32Runs; u32Run++)
+    {
+        if ( bUiTaskNotify(UI_SIGNAL_BENCH) )
+        {
+            rtos_bench_t xRender = { 0U };
+
+            for (uint32_t u32Wait = 0U; (xRender.u32Count <= u32Run) && (u32Wait < CLI_BENCH_TASK_TIMEOUT); u32Wait++)
+            {
+                vTaskDelay(pdMS_TO_TICKS(1U));
+                vUiGetRenderBench(&xRender, false);
+            }
+        }
+    }
+
+    vUiGetRenderBench(&xCliBench[CLI_BENCH_RENDER], true);
+
+    /* Frames sent to display since last bench, UI task cpu load is shown by top */
+    UI_get_push_bench(&xCliBench[CLI_BENCH_PUSH], true);
+
+    /* Storage round trip, includes queue and task switch */
+    for (uint32_t u32Run = 0U; u32Run < u32Runs; u32Run++)
+    {
+        uint32_t u32Cycles = 0U;
+
+        if ( bCliLoadPreset((uint8_t)(u32Run % (uint32_t)LFS_YM_SLOT_NUM), &u32Cycles) )
+        {
+            vRtosBenchAdd(&xCliBench[CLI_BENCH_LFS], u32Cycles);
+        }
+    }
+
+    /* File system flash busy time since boot, code fetch from flash stalls meanwhile */
+    LFS_get_flash_stall(&xCliBench[CLI_BENCH_ERASE], &xCliBench[CLI_BENCH_PROG]);
+
+    /* Gate input edges since last bench, not generated by bench */
+    vSynthGetGateBench(&xCliBench[CLI_BENCH_GATE], true);
+}
+
+static BaseType_t runBench(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString)
+{
+    BaseType_t xRetval = pdTRUE;
+
+    if ( u32BenchLine == 0U )
+    {
+        char *pcParameter1;
+        BaseType_t xParameter1StringLength = 0;
+        uint32_t u32Runs = CLI_BENCH_RUNS;
+
+        pcParameter1 = (char *)FreeRTOS_CLIGetParameter(pcCommandString, 1U, &xParameter1StringLength);
+
+        if ( pcParameter1 != NULL )
+        {
+            u32Runs = (uint32_t)atoi(pcParameter1);
+        }
+
+        if ( (u32Runs == 0U) || (u32Runs > CLI_BENCH_RUNS_MAX) )
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "BENCH: runs 1 to %d", CLI_BENCH_RUNS_MAX);
+            xRetval = pdFALSE;
+        }
+        else if ( eCliPresetLoad == CLI_PRESET_BUSY )
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "BENCH: preset buffer busy");
+            xRetval = pdFALSE;
+        }
+        else
+        {
+            vBenchRun(u32Runs);
+
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "BENCH: %d runs, %d MHz\r\nTEST        MIN      AVG      MAX   AVG US   JIT US",
+                            (int)u32Runs, (int)CLI_BENCH_CYCLES_US);
+            u32BenchLine++;
+        }
+    }
+    else
+    {
+        const rtos_bench_t * pxBench = &xCliBench[u32BenchLine - 1U];
+
+        if ( pxBench->u32Count == 0U )
+        {
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "%-6s n/a", pcBenchName[u32BenchLine - 1U]);
+        }
+        else
+        {
+            uint32_t u32Avg = pxBench->u32Sum / pxBench->u32Count;
+
+            /* Jitter as max to min spread */
+            (void)snprintf(pcWriteBuffer, xWriteBufferLen, "%-6s %8u %8u %8u %8u %8u", pcBenchName[u32BenchLine - 1U],
+                            (unsigned int)pxBench->u32Min, (unsigned int)u32Avg, (unsigned int)pxBench->u32Max,
+                            (unsigned int)(u32Avg / CLI_BENCH_CYCLES_US),
+                            (unsigned int)((pxBench->u32Max - pxBench->u32Min) / CLI_BENCH_CYCLES_US));
+        }
+
+        u32BenchLine++;
+
+        if ( u32BenchLine > (uint32_t)CLI_BENCH_NUM )
+        {
+            u32BenchLine = 0U;
+            xRetval = pdFALSE;
+        }
+    }
+
+    return xRetval;
+}
+
 /* Public application code ---------------------------------------------------*/
 
 void cli_cmd_init(void)
 {
-    (void)FreeRTOS_CLIRegisterCommand(&xDevReset);
-    (void)FreeRTOS_CLIRegisterCommand(&xWriteReg);
-    (void)FreeRTOS_CLIRegisterCommand(&xUserAssert);
-    (void)FreeRTOS_CLIRegisterCommand(&xUserFault);
-    (void)FreeRTOS_CLIRegisterCommand(&xVersion);
-    (void)FreeRTOS_CLIRegisterCommand(&xMidiCc);
-    (void)FreeRTOS_CLIRegisterCommand(&xMidiChangeMode);
+    for (uint32_t u32Index = 0U; u32Index < CLI_CMD_NUM; u32Index++)
+    {
+        (void)FreeRTOS_CLIRegisterCommandStatic(pxCliCommands[u32Index], &xCliCommandItems[u32Index]);
+    }
+
+    xTopTimer = xTimerCreateStatic("TOP", pdMS_TO_TICKS(1000U), pdTRUE, NULL, vTopTimerCallback, &xTopTimerCtrl);
+    ERR_ASSERT(xTopTimer);
+}
+
+const char * cli_cmd_periodic(void)
+{
+    const char * pcCmd = NULL;
+
+    if ( xTimerIsTimerActive(xTopTimer) != pdFALSE )
+    {
+        pcCmd = CLI_TOP_PERIODIC_CMD;
+    }
+
+    return pcCmd;
 }
 
 /* EOF */
@@ -12,12 +12,18 @@
 
 #include "cli_task.h"
 #include "serial_driver.h"
+#include "spsc_ring.h"
 #include "printf.h"
 #include "user_error.h"
 
 #include "FreeRTOS_CLI.h"
 #include "cli_cmd.h"
 
+#ifdef CLI_MIDI_INPUT_ENABLE
+#include "midi_lib.h"
+#include "midi_task.h"
+#endif
+
 #include "main.h"
 
 /* Private includes ----------------------------------------------------------*/
@@ -35,19 +41,52 @@
 #define CLI_SIGNAL_RX_DONE  (1UL << 1)
 #define CLI_SIGNAL_RX_IDLE  (1UL << 2)
 #define CLI_SIGNAL_ERROR    (1UL << 3)
+#define CLI_SIGNAL_LOG      (1UL << 4)
+#define CLI_SIGNAL_PERIODIC (1UL << 5)
+#define CLI_SIGNAL_ALL      (CLI_SIGNAL_TX_DONE | CLI_SIGNAL_RX_DONE | CLI_SIGNAL_RX_IDLE | CLI_SIGNAL_ERROR | CLI_SIGNAL_LOG | CLI_SIGNAL_PERIODIC)
+
+/* Log record header, tick and module name */
+#define CLI_LOG_HEADER      "%s%08x, %s, "
+
+/* Notice added to output when log records have been dropped */
+#define CLI_LOG_DROP_MSG    "%s%08x, %s, log: %u records dropped"
+
+/* Max time waiting for room on log ring to write a binary frame, ms */
+#define CLI_FRAME_TIMEOUT   ( 100U )
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
 TaskHandle_t cli_task_handle = NULL;
-volatile SemaphoreHandle_t cli_serial_mutex = NULL;
-
-static volatile bool ser_tx_done = false;
+static StaticTask_t xCliTaskTcb;
+static StackType_t pxCliTaskStack[CLI_TASK_STACK];
+
+/* Log ring, many producers serialized on push, drained by serial tx DMA */
+static uint8_t u8CliLogBuffer[CLI_LOG_RING_SIZE];
+static spsc_ring_t xCliLogRing = {
+    .buffer = u8CliLogBuffer,
+    .mask = CLI_LOG_RING_SIZE - 1U,
+    .head = 0U,
+    .tail = 0U,
+    .high_water = 0U,
+};
+
+/* Bytes of log ring on current DMA transfer, 0 when tx is idle */
+static volatile uint32_t u32CliLogTxLen = 0U;
+
+/* Log records lost with ring full */
+static volatile uint32_t u32CliLogDropCount = 0U;
+static uint32_t u32CliLogDropReported = 0U;
 
-static char print_output_buffer[CLI_OUTPUT_BUFFER_SIZE];
 static char cCliOutputBuffer[configCOMMAND_INT_MAX_OUTPUT_SIZE];
 static char cInputBuffer[configCOMMAND_INT_MAX_INPUT_SIZE];
 
+#ifdef CLI_MIDI_INPUT_ENABLE
+static midi_parser_t xCliMidiParser = { 0U };
+static uint8_t u8CliMidiSysExBuffer[CLI_MIDI_SYS_EX_SIZE];
+static uint32_t u32CliMidiSysExDropReported = 0U;
+#endif
+
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -64,6 +103,63 @@ void _cli_main(void *pvParameters);
   */
 void _event_cb(serial_event_t event);
 
+/**
+  * @brief Start DMA transfer of next log ring block if tx is idle.
+  *        Must be called from tx ISR or inside a critical section.
+  * @retval None
+  */
+static void _log_tx_start(void);
+
+/**
+  * @brief Format a log record and push it to the log ring.
+  * @param module_name name of calling task, NULL for raw output
+  * @param Format output format to use
+  * @param Args format arguments
+  * @retval None
+  */
+static void _log_vprintf(const char *module_name, const char *Format, va_list Args);
+
+/**
+  * @brief Push a long string to the log ring, waiting for room. Only for cli task.
+  * @param pcData string to push
+  * @retval None
+  */
+static void _log_write_wait(const char *pcData);
+
+/**
+  * @brief Run a cli command, output is written waiting for room on log ring.
+  * @param pcCommand command line to run.
+  * @retval None.
+  */
+static void _run_command(const char *pcCommand);
+
+#ifdef CLI_MIDI_INPUT_ENABLE
+/**
+  * @brief Forward 1 data midi message received on cli port to midi task
+  * @param cmd midi status byte
+  * @param data midi data byte
+  * @retval None
+  */
+static void _midi_msg_data1_cb(uint8_t cmd, uint8_t data);
+
+/**
+  * @brief Forward 2 data midi message received on cli port to midi task
+  * @param cmd midi status byte
+  * @param data0 first midi data byte
+  * @param data1 second midi data byte
+  * @retval None
+  */
+static void _midi_msg_data2_cb(uint8_t cmd, uint8_t data0, uint8_t data1);
+
+/**
+  * @brief Handle sysEx received on cli port
+  * @param pdata sysEx data
+  * @param len_data sysEx len
+  * @retval None
+  */
+static void _midi_sys_ex_cb(uint8_t *pdata, uint32_t len_data);
+#endif
+
 /* Private fuctions ----------------------------------------------------------*/
 
 void _event_cb(serial_event_t event)
@@ -74,13 +170,12 @@ void _event_cb(serial_event_t event)
     {
         xTaskNotifyFromISR(cli_task_handle, CLI_SIGNAL_RX_IDLE, eSetBits, &wakeTask);
     }
-    else if (event == SERIAL_EVENT_ERROR)
-    {
-        ser_tx_done = true;
-    }
-    else if (event == SERIAL_EVENT_TX_DONE)
+    else if ((event == SERIAL_EVENT_TX_DONE) || (event == SERIAL_EVENT_ERROR))
     {
-        ser_tx_done = true;
+        /* Release sent block and chain next one, on error block is lost */
+        spsc_ring_consume(&xCliLogRing, u32CliLogTxLen);
+        u32CliLogTxLen = 0U;
+        _log_tx_start();
     }
     else
     {
@@ -88,6 +183,135 @@ void _event_cb(serial_event_t event)
     }
 }
 
+static void _log_tx_start(void)
+{
+    if (u32CliLogTxLen == 0U)
+    {
+        const uint8_t * pu8Data = NULL;
+        uint32_t u32Len = spsc_ring_peek(&xCliLogRing, &pu8Data);
+
+        if (u32Len != 0U)
+        {
+            u32CliLogTxLen = u32Len;
+
+            if (SERIAL_send(SERIAL_1, (uint8_t *)pu8Data, (uint16_t)u32Len) != SERIAL_STATUS_OK)
+            {
+                u32CliLogTxLen = 0U;
+            }
+        }
+    }
+}
+
+static void _log_vprintf(const char *module_name, const char *Format, va_list Args)
+{
+    char cRecord[CLI_LOG_RECORD_SIZE];
+    int32_t len_data = 0;
+    int32_t len_msg = 0;
+    bool bPushed = false;
+
+    /* Format outside of critical section, on caller stack */
+    if (module_name != NULL)
+    {
+        len_data = snprintf(cRecord, CLI_LOG_RECORD_SIZE, CLI_LOG_HEADER, CLI_EOL, (unsigned int)xTaskGetTickCount(), module_name);
+        if ((len_data < 0) || (len_data >= (int32_t)CLI_LOG_RECORD_SIZE))
+        {
+            len_data = 0;
+        }
+    }
+
+    len_msg = vsnprintf(&cRecord[len_data], CLI_LOG_RECORD_SIZE - len_data, Format, Args);
+    if (len_msg > 0)
+    {
+        /* Truncated output */
+        if (len_msg >= (int32_t)(CLI_LOG_RECORD_SIZE - len_data))
+        {
+            len_msg = CLI_LOG_RECORD_SIZE - len_data - 1;
+        }
+        len_data += len_msg;
+    }
+
+    if (len_data > 0)
+    {
+        /* Whole record or nothing, push and tx kick are constant time */
+        taskENTER_CRITICAL();
+        if (spsc_ring_free(&xCliLogRing) >= (uint32_t)len_data)
+        {
+            (void)spsc_ring_push(&xCliLogRing, (uint8_t *)cRecord, len_data);
+            bPushed = true;
+        }
+        else
+        {
+            u32CliLogDropCount++;
+        }
+        taskEXIT_CRITICAL();
+
+        /* Tx is started from cli task, then chained on tx done irq */
+        if (bPushed && (u32CliLogTxLen == 0U) && (cli_task_handle != NULL))
+        {
+            xTaskNotify(cli_task_handle, CLI_SIGNAL_LOG, eSetBits);
+        }
+    }
+}
+
+static void _log_write_wait(const char *pcData)
+{
+    uint32_t u32Len = strlen(pcData);
+
+    while (u32Len != 0U)
+    {
+        uint32_t u32Pushed = 0U;
+
+        taskENTER_CRITICAL();
+        u32Pushed = spsc_ring_push(&xCliLogRing, (const uint8_t *)pcData, u32Len);
+        _log_tx_start();
+        taskEXIT_CRITICAL();
+
+        pcData += u32Pushed;
+        u32Len -= u32Pushed;
+
+        if (u32Len != 0U)
+        {
+            vTaskDelay(pdMS_TO_TICKS(1U));
+        }
+    }
+}
+
+static void _run_command(const char *pcCommand)
+{
+    BaseType_t xReturned;
+
+    do {
+        xReturned = FreeRTOS_CLIProcessCommand(pcCommand, cCliOutputBuffer, configCOMMAND_INT_MAX_OUTPUT_SIZE);
+        vCliPrintf(CLI_TASK_NAME, "");
+        _log_write_wait(cCliOutputBuffer);
+        memset(cCliOutputBuffer, 0, configCOMMAND_INT_MAX_OUTPUT_SIZE);
+    } while(xReturned != pdFALSE);
+}
+
+#ifdef CLI_MIDI_INPUT_ENABLE
+static void _midi_msg_data1_cb(uint8_t cmd, uint8_t data)
+{
+    _midi_msg_data2_cb(cmd, data, 0U);
+}
+
+static void _midi_msg_data2_cb(uint8_t cmd, uint8_t data0, uint8_t data1)
+{
+    MidiTaskCmd_t xMidiCmd = { 0U };
+
+    xMidiCmd.eCmd = MIDI_CMD_EXT_MSG;
+    xMidiCmd.uPayload.xExtMsg.u8Status = cmd;
+    xMidiCmd.uPayload.xExtMsg.u8Data0 = data0;
+    xMidiCmd.uPayload.xExtMsg.u8Data1 = data1;
+
+    (void)bMidiSendCmd(xMidiCmd);
+}
+
+static void _midi_sys_ex_cb(uint8_t *pdata, uint32_t len_data)
+{
+    vCliPrintf(CLI_TASK_NAME, "SYSEX: LEN %d", len_data);
+}
+#endif
+
 void _cli_main( void *pvParameters )
 {
     uint8_t u8RxData = 0;
@@ -100,6 +324,11 @@ void _cli_main( void *pvParameters )
     /* Register used functions */
     cli_cmd_init();
 
+#ifdef CLI_MIDI_INPUT_ENABLE
+    /* Second midi input, real time messages are not used from this port */
+    (void)midi_init(&xCliMidiParser, u8CliMidiSysExBuffer, sizeof(u8CliMidiSysExBuffer), _midi_sys_ex_cb, _midi_msg_data1_cb, _midi_msg_data2_cb, NULL);
+#endif
+
     /* Start message */
     vCliRawPrintf(CLI_INIT_MSG, MAIN_APP_VERSION, GIT_REVISION);
 
@@ -109,12 +338,54 @@ void _cli_main( void *pvParameters )
     /* Infinite loop */
     for(;;)
     {
-        BaseType_t event_wait = xTaskNotifyWait(0, CLI_SIGNAL_RX_IDLE, &tmp_event, portMAX_DELAY);
-        if (event_wait == pdPASS)
+        BaseType_t event_wait = xTaskNotifyWait(0, CLI_SIGNAL_ALL, &tmp_event, portMAX_DELAY);
+
+        if ((event_wait == pdPASS) && RTOS_CHECK_SIGNAL(tmp_event, CLI_SIGNAL_LOG))
+        {
+            uint32_t u32DropCount = u32CliLogDropCount;
+
+            /* Report lost records once there is room again */
+            if ((u32DropCount != u32CliLogDropReported) && (spsc_ring_free(&xCliLogRing) >= CLI_LOG_RECORD_SIZE))
+            {
+                vCliRawPrintf(CLI_LOG_DROP_MSG, CLI_EOL, (unsigned int)xTaskGetTickCount(), CLI_TASK_NAME, (unsigned int)(u32DropCount - u32CliLogDropReported));
+                u32CliLogDropReported = u32DropCount;
+            }
+
+            taskENTER_CRITICAL();
+            _log_tx_start();
+            taskEXIT_CRITICAL();
+        }
+
+        if ((event_wait == pdPASS) && RTOS_CHECK_SIGNAL(tmp_event, CLI_SIGNAL_PERIODIC))
+        {
+            const char *pcPeriodicCmd = cli_cmd_periodic();
+
+            if (pcPeriodicCmd != NULL)
+            {
+                _run_command(pcPeriodicCmd);
+            }
+        }
+
+        if ((event_wait == pdPASS) && RTOS_CHECK_SIGNAL(tmp_event, CLI_SIGNAL_RX_IDLE))
         {
             /* Fill input buffer */
             while (SERIAL_read(SERIAL_1, &u8RxData, 1) != 0)
             {
+#ifdef CLI_MIDI_INPUT_ENABLE
+                /* Status bytes and data of an open midi message go to midi parser, oversized sysEx included */
+                if (((u8RxData & 0x80U) != 0U) || midi_msg_pending(&xCliMidiParser))
+                {
+                    (void)midi_update_fsm(&xCliMidiParser, u8RxData);
+
+                    if (midi_get_sys_ex_drop(&xCliMidiParser) != u32CliMidiSysExDropReported)
+                    {
+                        u32CliMidiSysExDropReported = midi_get_sys_ex_drop(&xCliMidiParser);
+                        vCliPrintf(CLI_TASK_NAME, "SYSEX: over %d bytes, dropped %d", CLI_MIDI_SYS_EX_SIZE, u32CliMidiSysExDropReported);
+                    }
+                    continue;
+                }
+#endif
+
                 /* End of command detected */
                 if ((u8RxData == '\r') || (u8RxData == '\n'))
                 {
@@ -122,13 +393,7 @@ void _cli_main( void *pvParameters )
                     {
                         vCliPrintf(CLI_TASK_NAME, "cmd: \"%s\"", cInputBuffer);
 
-                        BaseType_t xReturned;
-
-                        do {
-                            xReturned = FreeRTOS_CLIProcessCommand(cInputBuffer, cCliOutputBuffer, configCOMMAND_INT_MAX_OUTPUT_SIZE);
-                            vCliPrintf(CLI_TASK_NAME, "%s", cCliOutputBuffer);
-                            memset(cCliOutputBuffer, 0, configCOMMAND_INT_MAX_OUTPUT_SIZE);
-                        } while(xReturned != pdFALSE);
+                        _run_command(cInputBuffer);
 
                         i_rx_buff = 0;
                     }
@@ -166,106 +431,106 @@ void vCliTaskInit(void)
     /* Init HW resources */
     (void)SERIAL_init(SERIAL_1, _event_cb);
 
-    /* Create mutex */
-    cli_serial_mutex = xSemaphoreCreateMutex();
-    ERR_ASSERT( cli_serial_mutex );
-
     /* Create task */
-    xTaskCreate(_cli_main, CLI_TASK_NAME, CLI_TASK_STACK, NULL, CLI_TASK_PRIO, &cli_task_handle);
+    cli_task_handle = xTaskCreateStatic(_cli_main, CLI_TASK_NAME, CLI_TASK_STACK, NULL, CLI_TASK_PRIO, pxCliTaskStack, &xCliTaskTcb);
     ERR_ASSERT( cli_task_handle );
 }
 
 /* CLI printf implementation */
 void vCliPrintf(const char *module_name, const char *Format, ...)
 {
-    if (cli_serial_mutex != NULL)
-    {
-        if (xSemaphoreTake(cli_serial_mutex, portMAX_DELAY) != pdTRUE)
-        {
-            ERR_ASSERT(0U);
-        }
-
-        int32_t len_data = 0;
-        va_list Args;
+    va_list Args;
 
-        /* Print task header */
-        memset(print_output_buffer, 0, CLI_OUTPUT_BUFFER_SIZE);
-        len_data = snprintf(
-            (char *)print_output_buffer, 
-            CLI_OUTPUT_BUFFER_SIZE, 
-            "%s%08x, %s, ", 
-            CLI_EOL, 
-            (unsigned int)xTaskGetTickCount(), 
-            module_name);
+    va_start(Args, Format);
+    _log_vprintf(module_name, Format, Args);
+    va_end(Args);
+}
 
-        if (len_data > 0)
-        {
-            ser_tx_done = false;
-            SERIAL_send(SERIAL_1, (uint8_t *)print_output_buffer, len_data);
-            while (ser_tx_done != true)
-            {
-                vTaskDelay(pdMS_TO_TICKS(1U));
-            }
-        }
+/* CLI printf implementation */
+void vCliRawPrintf(const char *Format, ...)
+{
+    va_list Args;
 
-        /* Print cli message */
-        memset(print_output_buffer, 0, CLI_OUTPUT_BUFFER_SIZE);
-        va_start(Args, Format);
-        len_data = vsnprintf((char *)print_output_buffer, CLI_OUTPUT_BUFFER_SIZE, Format, Args);
-        va_end(Args);
+    va_start(Args, Format);
+    _log_vprintf(NULL, Format, Args);
+    va_end(Args);
+}
 
-        if (len_data > 0)
-        {
-            SERIAL_send(SERIAL_1, (uint8_t *)print_output_buffer, len_data);
-            ser_tx_done = false;
-            SERIAL_send(SERIAL_1, (uint8_t *)print_output_buffer, len_data);
-            while (ser_tx_done != true)
-            {
-                vTaskDelay(pdMS_TO_TICKS(1U));
-            }
-        }
+void vCliLogBin(uint32_t u32FmtId, const uint32_t *pu32Args, uint32_t u32NumArgs)
+{
+    ERR_ASSERT(u32NumArgs <= CLI_LOG_BIN_MAX_ARGS);
+
+    uint8_t u8Frame[8U + (4U * CLI_LOG_BIN_MAX_ARGS)];
+    uint32_t u32Tick = xTaskGetTickCount();
+    uint32_t u32Len = 8U + (4U * u32NumArgs);
+    bool bPushed = false;
+
+    u8Frame[0U] = CLI_LOG_BIN_SYNC;
+    u8Frame[1U] = (uint8_t)u32NumArgs;
+    u8Frame[2U] = (uint8_t)u32FmtId;
+    u8Frame[3U] = (uint8_t)(u32FmtId >> 8U);
+    memcpy(&u8Frame[4U], &u32Tick, sizeof(uint32_t));
+    memcpy(&u8Frame[8U], pu32Args, 4U * u32NumArgs);
+
+    taskENTER_CRITICAL();
+    if (spsc_ring_free(&xCliLogRing) >= u32Len)
+    {
+        (void)spsc_ring_push(&xCliLogRing, u8Frame, u32Len);
+        bPushed = true;
+    }
+    else
+    {
+        u32CliLogDropCount++;
+    }
+    taskEXIT_CRITICAL();
 
-        if (xSemaphoreGive(cli_serial_mutex) != pdTRUE)
-        {
-            ERR_ASSERT(0U);
-        }
+    if (bPushed && (u32CliLogTxLen == 0U) && (cli_task_handle != NULL))
+    {
+        xTaskNotify(cli_task_handle, CLI_SIGNAL_LOG, eSetBits);
     }
 }
 
-/* CLI printf implementation */
-void vCliRawPrintf(const char *Format, ...)
+bool bCliWriteFrame(const char *pcMark, const uint8_t *pu8Data, uint32_t u32Len)
 {
-    if (cli_serial_mutex != NULL)
-    {
-        if (xSemaphoreTake(cli_serial_mutex, portMAX_DELAY) != pdTRUE)
-        {
-            ERR_ASSERT(0U);
-        }
-
-        int32_t len_data = 0;
-        va_list Args;
+    uint32_t u32MarkLen = strlen(pcMark);
+    uint8_t pu8Len[2U] = { (uint8_t)u32Len, (uint8_t)(u32Len >> 8U) };
+    uint8_t u8Sum = 0U;
+    bool bPushed = false;
 
-        /* Print cli message */
-        memset(print_output_buffer, 0, CLI_OUTPUT_BUFFER_SIZE);
-        va_start(Args, Format);
-        len_data = vsnprintf((char *)print_output_buffer, CLI_OUTPUT_BUFFER_SIZE, Format, Args);
-        va_end(Args);
+    ERR_ASSERT((u32MarkLen + sizeof(pu8Len) + u32Len + sizeof(u8Sum)) <= CLI_LOG_RING_SIZE);
 
-        if (len_data > 0)
+    for (uint32_t u32Wait = 0U; !bPushed && (u32Wait < CLI_FRAME_TIMEOUT); u32Wait++)
+    {
+        /* Whole frame at once, data can not change and other log records can not split it */
+        taskENTER_CRITICAL();
+        if (spsc_ring_free(&xCliLogRing) >= (u32MarkLen + sizeof(pu8Len) + u32Len + sizeof(u8Sum)))
         {
-            ser_tx_done = false;
-            SERIAL_send(SERIAL_1, (uint8_t *)print_output_buffer, len_data);
-            while (ser_tx_done != true)
+            for (uint32_t u32Index = 0U; u32Index < u32Len; u32Index++)
             {
-                __NOP();
+                u8Sum += pu8Data[u32Index];
             }
+
+            (void)spsc_ring_push(&xCliLogRing, (const uint8_t *)pcMark, u32MarkLen);
+            (void)spsc_ring_push(&xCliLogRing, pu8Len, sizeof(pu8Len));
+            (void)spsc_ring_push(&xCliLogRing, pu8Data, u32Len);
+            (void)spsc_ring_push(&xCliLogRing, &u8Sum, sizeof(u8Sum));
+            _log_tx_start();
+            bPushed = true;
         }
+        taskEXIT_CRITICAL();
 
-        if (xSemaphoreGive(cli_serial_mutex) != pdTRUE)
+        if (!bPushed)
         {
-            ERR_ASSERT(0U);
+            vTaskDelay(pdMS_TO_TICKS(1U));
         }
     }
+
+    return bPushed;
+}
+
+uint32_t u32CliGetLogDropCount(void)
+{
+    return u32CliLogDropCount;
 }
 
 bool bCliTaskNotify(uint32_t u32Event)
@@ -280,4 +545,9 @@ bool bCliTaskNotify(uint32_t u32Event)
     return bRetval;
 }
 
+bool bCliNotifyPeriodic(void)
+{
+    return bCliTaskNotify(CLI_SIGNAL_PERIODIC);
+}
+
 /*****END OF FILE****/
@@ -12,6 +12,7 @@
 /* System Resources */
 #include "sys_mcu.h"
 #include "sys_rtos.h"
+#include "crash_store.h"
 
 /* Tasks */
 #include "midi_task.h"
@@ -19,6 +20,7 @@
 #include "synth_task.h"
 #include "ui_task.h"
 #include "mapping_task.h"
+#include "storage_task.h"
 
 /* Main app ------------------------------------------------------------------*/
 
@@ -33,7 +35,11 @@ int main(void)
     /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
     SYS_Init();
 
+    /* Keep crash dump left by previous run */
+    vCrashStoreInit();
+
     /* Task creation */
+    vStorageTaskInit();
     vMidiTaskInit();
     vCliTaskInit();
     vSynthTaskInit();
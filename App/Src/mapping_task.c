@@ -14,6 +14,7 @@
 
 #include "synth_task.h"
 #include "cli_task.h"
+#include "storage_task.h"
 
 #include "adc_driver.h"
 #include "YM2612_driver.h"
@@ -24,21 +25,47 @@
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 
-/** Update rate for mapping actions in miliseconds */
-#define MAP_TASK_UPDATE_RATE_MS             ( 25U )
-
 /** Send event timeout */
 #define MAP_SEND_EVENT_TIMEOUT              ( 100U )
 
 /** Minimal value to set gate */
 #define ADC_STEPS_GATE_ON                   ( 900U )   // aprox 3V
 
+/** Value to release gate, hysteresis over ADC_STEPS_GATE_ON */
+#define ADC_STEPS_GATE_OFF                  ( 1000U )  // aprox 2.6V
+
 /** ADC full range */
 #define ADC_FULL_RANGE                      ( 4096U )
 
 /** ADC 0mV value */
 #define ADC_ZERO_VOLT                       ( 2048U ) // ADC_FULL_RANGE / 2
 
+/** Default V/Oct gain, 60 notes over ADC_ZERO_VOLT counts, cents per count in Q16 */
+#define MAP_CAL_GAIN_DEFAULT                ( 192000UL ) // 1500 / 512 * 65536
+
+/** Accepted calibrated gain range, keeps conversion inside 32 bits */
+#define MAP_CAL_GAIN_MIN                    ( MAP_CAL_GAIN_DEFAULT / 2U )
+#define MAP_CAL_GAIN_MAX                    ( MAP_CAL_GAIN_DEFAULT * 2U )
+
+/** Accepted calibrated offset range, ADC counts at midi note 0 for any accepted gain */
+#define MAP_CAL_OFFSET_MIN                  ( 0 )
+#define MAP_CAL_OFFSET_MAX                  ( (int32_t)ADC_FULL_RANGE + (int32_t)(((uint32_t)MAP_CENTS_MAX * 65536UL) / MAP_CAL_GAIN_MIN) )
+
+/** Minimal distance between calibration points */
+#define MAP_CAL_MIN_NOTE_SPAN               ( 12U )
+
+/** ADC change to wake up on V/Oct inputs, aprox 6 cents */
+#define MAP_VOCT_ADC_THRESHOLD              ( 2U )
+
+/** Cents per note */
+#define MAP_CENTS_NOTE                      ( 100 )
+
+/** Highest note accepted, last midi note */
+#define MAP_NOTE_MAX                        ( 127U )
+
+/** Highest pitch accepted */
+#define MAP_CENTS_MAX                       ( (int32_t)MAP_NOTE_MAX * MAP_CENTS_NOTE + (MAP_CENTS_NOTE - 1) )
+
 /* Private macro -------------------------------------------------------------*/
 
 /** Get gate status ADC count */
@@ -51,25 +78,87 @@ MapElement_t pxMapElementList[MAP_CH_NUM] = {0U};
 
 /** Task handler */
 TaskHandle_t map_task_handle = NULL;
-
-/** Timer to handle refresh */
-TimerHandle_t xMappingUpdateTimer = NULL;
+static StaticTask_t xMapTaskTcb;
+static StackType_t pxMapTaskStack[MAP_TASK_STACK];
 
 /** Mutex to protect mapping cfg access */
 SemaphoreHandle_t xMappingCfgMutex = NULL;
+static StaticSemaphore_t xMappingCfgMutexCtrl;
 
 /** List of values to set via gate mapping */
 uint8_t u8TmpNotes[SYNTH_MAX_NUM_VOICE] = { 0U };
+uint8_t u8TmpCents[SYNTH_MAX_NUM_VOICE] = { 0U };
+
+/** V/Oct calibration in use, protected by xMappingCfgMutex, written in critical section for ADC interrupt reads */
+static lfs_cal_data_t xMapCal = { 0U };
+
+/** Calibration buffer owned by storage task during requests */
+static lfs_cal_data_t xMapCalStorage = { 0U };
+static volatile bool bMapCalLoadResult = false;
+static volatile bool bMapCalSaveBusy = false;
+
+/** Captured calibration points */
+static uint16_t u16MapCalAdc[MAP_CH_NUM][MAP_CAL_POINT_NUM] = { 0U };
+static uint8_t u8MapCalNote[MAP_CH_NUM][MAP_CAL_POINT_NUM] = { 0U };
 
 /* Private function prototypes -----------------------------------------------*/
 
 /**
- * @brief Cast value from ADC to midi note.
+ * @brief Cast value from ADC to pitch using channel calibration.
  * 
+ * @param u8MapChannel input channel.
+ * @param u16AdcValue adc value.
+ * @return int32_t pitch in cents over midi note 0, negative if out of range.
+ */
+static int32_t i32GetCentsFromAdc(uint8_t u8MapChannel, uint16_t u16AdcValue);
+
+/**
+ * @brief Cast value from ADC to pitch with a given calibration.
+ *
+ * @param i32Offset calibration offset, ADC counts at midi note 0.
+ * @param u32Gain calibration gain, cents per count in Q16.
  * @param u16AdcValue adc value.
- * @return uint8_t midi note number.
+ * @return int32_t pitch in cents over midi note 0, negative if out of range.
  */
-static uint8_t u8GetNoteFromDac(uint16_t u16AdcValue);
+static int32_t i32GetCentsFromCal(int32_t i32Offset, uint32_t u32Gain, uint16_t u16AdcValue);
+
+/**
+ * @brief Pitch of the V/Oct input driving a voice, from the unfiltered sample
+ *        of the last ADC sequence. Called from ADC interrupt.
+ *
+ * @param u8Voice voice driven by the gate.
+ * @return int32_t pitch in cents over midi note 0, negative if no V/Oct input or out of range.
+ */
+static int32_t i32GetVoiceCentsFromIsr(uint8_t u8Voice);
+
+/**
+  * @brief Set default calibration on a channel.
+  * @param u8MapChannel channel to reset.
+  * @retval None.
+  */
+static void vMapCalDefault(uint8_t u8MapChannel);
+
+/**
+  * @brief Check a channel calibration is inside accepted range.
+  * @param i32Offset calibration offset, ADC counts at midi note 0.
+  * @param u32Gain calibration gain, cents per count in Q16.
+  * @retval True if calibration can be used, False ioc.
+  */
+static bool bMapCalValid(int32_t i32Offset, uint32_t u32Gain);
+
+/**
+  * @brief Request calibration save to storage task.
+  * @retval None.
+  */
+static void vMapCalSave(void);
+
+/**
+  * @brief Storage done callback for calibration requests.
+  * @param pxCmd finished request.
+  * @param bResult request result.
+  * @retval None.
+  */
+static void vMapStorageDoneCb(const StorageCmd_t * pxCmd, bool bResult);
 
 /**
   * @brief Handler for mode CV_OCT.
@@ -80,12 +169,18 @@ static uint8_t u8GetNoteFromDac(uint16_t u16AdcValue);
 static void vMappingModeVoctHandler(uint8_t u8MapChannel, MapElement_t * pxMapChannelCfg);
 
 /**
-  * @brief Handler for mode GATE.
-  * @param u8MapChannel mapping channel to apply configuration.
-  * @param pxMapChannelCfg pointer to map element to manage.
+  * @brief Handler for GATE edges, called from ADC interrupt.
+  * @param u32ChMask mask of channels with an edge.
+  * @param bGateOn true for gate activation, false for release.
   * @retval None.
   */
-static void vMappingModeGateHandler(uint8_t u8MapChannel, MapElement_t * pxMapChannelCfg);
+static void vMappingGateEdge(uint32_t u32ChMask, bool bGateOn);
+
+/**
+  * @brief Set ADC gate detection and wake up threshold from channel modes.
+  * @retval None.
+  */
+static void vMappingInputCfgUpdate(void);
 
 /**
   * @brief Handler for mode PARAMETER.
@@ -104,17 +199,19 @@ static void vMappingModeParameterHandler(uint8_t u8MapChannel, MapElement_t * px
 static uint8_t u8GetParamValue(uint8_t u8ParameterId, uint16_t u16AdcValue);
 
 /**
-  * @brief Execute an update loop on all channels.
+  * @brief Execute an update loop on selected channels.
+  * @param u32ChMask mask with one bit per channel to update.
   * @retval None.
   */
-static void vMappingUpdateLoop(void);
+static void vMappingUpdateLoop(uint32_t u32ChMask);
 
 /**
-  * @brief Timer callback to generate update event.
-  * @param xTimer handler that generates the event.
+  * @brief ADC callback, moved channels are forwarded as task signals and gate edges straight to synth.
+  * @param xEvent adc event.
+  * @param u32ChMask mask of updated channels.
   * @retval None.
   */
-static void vMappingUpdateCallback(TimerHandle_t xTimer);
+static void vMappingAdcCallback(adc_event_t xEvent, uint32_t u32ChMask);
 
 /**
   * @brief Main task loop
@@ -125,25 +222,100 @@ static void vMapMain(void *pvParameters);
 
 /* Private fuctions ----------------------------------------------------------*/
 
-static uint8_t u8GetNoteFromDac(uint16_t u16AdcValue)
+static int32_t i32GetCentsFromAdc(uint8_t u8MapChannel, uint16_t u16AdcValue)
 {
-    uint8_t u8Note = 0U;
+    int32_t i32Cents = -1;
 
-    if ( u16AdcValue <= ADC_ZERO_VOLT )
+    if (xSemaphoreTake(xMappingCfgMutex, portMAX_DELAY) == pdTRUE)
     {
-        uint16_t u16TmpNote = 60U - (15U * u16AdcValue) / 512U;
+        i32Cents = i32GetCentsFromCal(xMapCal.i32Offset[u8MapChannel], xMapCal.u32Gain[u8MapChannel], u16AdcValue);
+
+        (void)xSemaphoreGive(xMappingCfgMutex);
+    }
+
+    return i32Cents;
+}
 
-        /* Check remainder */
-        uint16_t u16Remainder = (15U * u16AdcValue) % 512U;
-        if ( u16Remainder < 256U )
+static int32_t i32GetCentsFromCal(int32_t i32Offset, uint32_t u32Gain, uint16_t u16AdcValue)
+{
+    /* Input is inverting, higher voltage gives lower counts */
+    int64_t i64Cents = ((int64_t)i32Offset - u16AdcValue) * u32Gain;
+    int32_t i32Cents = ( i64Cents < 0 ) ? -1 : (int32_t)(i64Cents >> 16U);
+
+    return ( i32Cents <= MAP_CENTS_MAX ) ? i32Cents : -1;
+}
+
+static int32_t i32GetVoiceCentsFromIsr(uint8_t u8Voice)
+{
+    int32_t i32Cents = -1;
+
+    for (uint8_t u8MapChannel = 0U; u8MapChannel < MAP_CH_NUM; u8MapChannel++)
+    {
+        uint16_t u16AdcValue = 0U;
+
+        if ( (pxMapElementList[u8MapChannel].xMode == MAP_MODE_V_OCT) && (pxMapElementList[u8MapChannel].u8Voice == u8Voice) &&
+             (ADC_get_raw_value(ADC_0, u8MapChannel, &u16AdcValue) == ADC_STATUS_OK) )
         {
-            u16TmpNote++;
+            UBaseType_t uxSavedIrq = taskENTER_CRITICAL_FROM_ISR();
+            int32_t i32Offset = xMapCal.i32Offset[u8MapChannel];
+            uint32_t u32Gain = xMapCal.u32Gain[u8MapChannel];
+            taskEXIT_CRITICAL_FROM_ISR(uxSavedIrq);
+
+            i32Cents = i32GetCentsFromCal(i32Offset, u32Gain, u16AdcValue);
+            break;
         }
+    }
+
+    return i32Cents;
+}
 
-        u8Note = (uint8_t)u16TmpNote;
+static void vMapCalDefault(uint8_t u8MapChannel)
+{
+    taskENTER_CRITICAL();
+    xMapCal.i32Offset[u8MapChannel] = (int32_t)ADC_ZERO_VOLT;
+    xMapCal.u32Gain[u8MapChannel] = MAP_CAL_GAIN_DEFAULT;
+    taskEXIT_CRITICAL();
+}
+
+static bool bMapCalValid(int32_t i32Offset, uint32_t u32Gain)
+{
+    return ( (u32Gain >= MAP_CAL_GAIN_MIN) && (u32Gain <= MAP_CAL_GAIN_MAX) &&
+             (i32Offset >= MAP_CAL_OFFSET_MIN) && (i32Offset <= MAP_CAL_OFFSET_MAX) );
+}
+
+static void vMapCalSave(void)
+{
+    if ( bMapCalSaveBusy )
+    {
+        vCliPrintf(MAP_TASK_NAME, "CAL: Save BUSY");
     }
+    else if (xSemaphoreTake(xMappingCfgMutex, portMAX_DELAY) == pdTRUE)
+    {
+        StorageCmd_t xStorageCmd = { 0U };
+
+        xMapCalStorage = xMapCal;
+        (void)xSemaphoreGive(xMappingCfgMutex);
+
+        xStorageCmd.eCmd = STORAGE_CMD_CAL_SAVE;
+        xStorageCmd.pvData = &xMapCalStorage;
+        xStorageCmd.pxDoneCb = vMapStorageDoneCb;
 
-    return u8Note;
+        bMapCalSaveBusy = bStorageSendCmd(xStorageCmd);
+    }
+}
+
+static void vMapStorageDoneCb(const StorageCmd_t * pxCmd, bool bResult)
+{
+    if ( pxCmd->eCmd == STORAGE_CMD_CAL_LOAD )
+    {
+        bMapCalLoadResult = bResult;
+        (void)bMapTaskNotify(MAP_SIGNAL_CAL_LOADED);
+    }
+    else
+    {
+        vCliPrintf(MAP_TASK_NAME, "CAL: Save %s", bResult ? "OK" : "ERROR");
+        bMapCalSaveBusy = false;
+    }
 }
 
 static void vMappingModeVoctHandler(uint8_t u8MapChannel, MapElement_t * pxMapChannelCfg)
@@ -155,71 +327,118 @@ static void vMappingModeVoctHandler(uint8_t u8MapChannel, MapElement_t * pxMapCh
 
     if ( ADC_get_value(ADC_0, u8MapChannel, &u16NewVoltage) == ADC_STATUS_OK )
     {
-        if ( u16NewVoltage < ADC_ZERO_VOLT )
+        int32_t i32NewCents = i32GetCentsFromAdc(u8MapChannel, u16NewVoltage);
+
+        if ( i32NewCents >= 0 )
         {
-            uint8_t u8NewNote = u8GetNoteFromDac(u16NewVoltage);
-            uint8_t u8OldNote = u8GetNoteFromDac(pxMapChannelCfg->u16Value);
+            uint8_t u8Voice = pxMapChannelCfg->u8Voice;
+            uint8_t u8NewNote = (uint8_t)(i32NewCents / MAP_CENTS_NOTE);
+            uint8_t u8NewCents = (uint8_t)(i32NewCents % MAP_CENTS_NOTE);
 
-            // Update new note value to synth task
-            if ( u8NewNote != u8OldNote )
+            // Update new pitch value to synth task
+            if ( (u8NewNote != u8TmpNotes[u8Voice]) || (u8NewCents != u8TmpCents[u8Voice]) )
             {
+                SynthCmd_t xSynthCmd = {
+                    .eCmd = SYNTH_CMD_VOICE_PITCH,
+                    .uPayload.xVoicePitch.u8VoiceDst = u8Voice,
+                    .uPayload.xVoicePitch.u8Note = u8NewNote,
+                    .uPayload.xVoicePitch.u8Cents = u8NewCents,
+                };
+
 #ifdef MAP_DEBUG
-                vCliPrintf(MAP_TASK_NAME, "MAP: V_OCT UPDATE: CH: %d, Note: %d", u8MapChannel, u8NewNote);
+                vCliPrintf(MAP_TASK_NAME, "MAP: V_OCT UPDATE: CH: %d, Note: %d.%02d", u8MapChannel, u8NewNote, u8NewCents);
 #endif
+                /* Pitch is queued before gate edges can use the new note */
+                (void)bSynthSendCmd(xSynthCmd);
+
                 pxMapChannelCfg->u16Value = u16NewVoltage;
-                u8TmpNotes[pxMapChannelCfg->u8Voice] = u8NewNote;
+                u8TmpNotes[u8Voice] = u8NewNote;
+                u8TmpCents[u8Voice] = u8NewCents;
             }
         }
     }
 }
 
-static void vMappingModeGateHandler(uint8_t u8MapChannel, MapElement_t * pxMapChannelCfg)
+static void vMappingGateEdge(uint32_t u32ChMask, bool bGateOn)
 {
-    ERR_ASSERT(pxMapChannelCfg != NULL);
-    ERR_ASSERT(u8MapChannel < MAP_CH_NUM);
-
-    uint16_t u16NewVoltage = 0U;
+    /* Edge time for key on latency, taken once for all channels of the sequence */
+    uint32_t u32GateStamp = u32RtosStatsTimerGet();
 
-    if ( ADC_get_value(ADC_0, u8MapChannel, &u16NewVoltage) == ADC_STATUS_OK )
+    for (uint8_t u8MapChannel = 0U; u8MapChannel < MAP_CH_NUM; u8MapChannel++)
     {
-        bool bNewGateStatus = GATE_FROM_ADC(u16NewVoltage);
-        bool bOldGateStatus = GATE_FROM_ADC(pxMapChannelCfg->u16Value);
+        MapElement_t * pxMapChannelCfg = &pxMapElementList[u8MapChannel];
 
-        // Update new note value to synth task
-        if ( bNewGateStatus != bOldGateStatus )
+        if ( ((u32ChMask & (1UL << u8MapChannel)) != 0U) && (pxMapChannelCfg->xMode == MAP_MODE_GATE) )
         {
+            uint8_t u8Voice = pxMapChannelCfg->u8Voice;
+            uint8_t u8Note = u8TmpNotes[u8Voice];
+            uint8_t u8Cents = u8TmpCents[u8Voice];
+
+            /* Key on pitch from V/Oct sample of the same sequence, filtered value still lags a new note */
+            if ( bGateOn )
+            {
+                int32_t i32Cents = i32GetVoiceCentsFromIsr(u8Voice);
+
+                if ( i32Cents >= 0 )
+                {
+                    u8Note = (uint8_t)(i32Cents / MAP_CENTS_NOTE);
+                    u8Cents = (uint8_t)(i32Cents % MAP_CENTS_NOTE);
+                }
+            }
+
             SynthCmd_t xSynthCmd = {
                 .eCmd = SYNTH_CMD_VOICE_UPDATE_MONO,
-                .uPayload.xVoiceUpdateMono.u8Note = u8TmpNotes[pxMapChannelCfg->u8Voice],
+                .uPayload.xVoiceUpdateMono.u8Note = u8Note,
                 .uPayload.xVoiceUpdateMono.u8Velocity = 127U,
-                .uPayload.xVoiceUpdateMono.u8VoiceDst = pxMapChannelCfg->u8Voice,
-                .uPayload.xVoiceUpdateMono.u8VoiceState = 0U,
+                .uPayload.xVoiceUpdateMono.u8VoiceDst = u8Voice,
+                .uPayload.xVoiceUpdateMono.u8VoiceState = bGateOn ? SYNTH_VOICE_STATE_ON : SYNTH_VOICE_STATE_OFF,
+                .uPayload.xVoiceUpdateMono.u32GateStamp = u32GateStamp,
             };
 
-            if ( bNewGateStatus == true )
-            {
-                xSynthCmd.uPayload.xVoiceUpdateMono.u8VoiceState = SYNTH_VOICE_STATE_ON;
-            }
-            else
-            {
-                xSynthCmd.uPayload.xVoiceUpdateMono.u8VoiceState = SYNTH_VOICE_STATE_OFF;
-            }
+            /* Sent from ADC interrupt, no wait on map task */
+            (void)bSynthSendCmdFromISR(xSynthCmd);
 
-            if ( bSynthSendCmd(xSynthCmd) == true )
-            {
-#ifdef MAP_DEBUG
-                vCliPrintf(MAP_TASK_NAME, "CMD: GATE");
-#endif
-                pxMapChannelCfg->u16Value = u16NewVoltage;
-            }
-            else
+            /* Fine pitch is applied over the key on */
+            if ( bGateOn && (u8Cents != 0U) )
             {
-                vCliPrintf(MAP_TASK_NAME, "CMD: Queue Error");
+                SynthCmd_t xPitchCmd = {
+                    .eCmd = SYNTH_CMD_VOICE_PITCH,
+                    .uPayload.xVoicePitch.u8VoiceDst = u8Voice,
+                    .uPayload.xVoicePitch.u8Note = u8Note,
+                    .uPayload.xVoicePitch.u8Cents = u8Cents,
+                };
+
+                (void)bSynthSendCmdFromISR(xPitchCmd);
             }
         }
     }
 }
 
+static void vMappingInputCfgUpdate(void)
+{
+    for (uint8_t u8MapChannel = 0U; u8MapChannel < MAP_CH_NUM; u8MapChannel++)
+    {
+        /* Pitch inputs need finer steps than parameters */
+        if ( pxMapElementList[u8MapChannel].xMode == MAP_MODE_V_OCT )
+        {
+            (void)ADC_set_threshold(ADC_0, u8MapChannel, MAP_VOCT_ADC_THRESHOLD);
+        }
+        else
+        {
+            (void)ADC_set_threshold(ADC_0, u8MapChannel, ADC_THRESHOLD_DEFAULT);
+        }
+
+        if ( pxMapElementList[u8MapChannel].xMode == MAP_MODE_GATE )
+        {
+            (void)ADC_gate_enable(ADC_0, u8MapChannel, ADC_STEPS_GATE_ON, ADC_STEPS_GATE_OFF);
+        }
+        else
+        {
+            (void)ADC_gate_disable(ADC_0, u8MapChannel);
+        }
+    }
+}
+
 static void vMappingModeParameterHandler(uint8_t u8MapChannel, MapElement_t * pxMapChannelCfg)
 {
     ERR_ASSERT(pxMapChannelCfg != NULL);
@@ -424,21 +643,22 @@ static uint8_t u8GetParamValue(uint8_t u8ParameterId, uint16_t u16AdcValue)
     return u8ParamValue;
 }
 
-static void vMappingUpdateLoop(void)
+static void vMappingUpdateLoop(uint32_t u32ChMask)
 {
     /* Loop for channels */
     for (uint32_t u8Index = 0U; u8Index < MAP_CH_NUM; u8Index++)
     {
+        if ( (u32ChMask & (1UL << u8Index)) == 0U )
+        {
+            continue;
+        }
+
         switch (pxMapElementList[u8Index].xMode)
         {
             case MAP_MODE_V_OCT:
                 vMappingModeVoctHandler(u8Index, &pxMapElementList[u8Index]);
                 break;
 
-            case MAP_MODE_GATE:
-                vMappingModeGateHandler(u8Index, &pxMapElementList[u8Index]);
-                break;
-
             case MAP_MODE_PARAMETER:
                 vMappingModeParameterHandler(u8Index, &pxMapElementList[u8Index]);
                 break;
@@ -450,9 +670,23 @@ static void vMappingUpdateLoop(void)
     }
 }
 
-static void vMappingUpdateCallback(TimerHandle_t xTimer)
+static void vMappingAdcCallback(adc_event_t xEvent, uint32_t u32ChMask)
 {
-    xTaskNotify(map_task_handle, MAP_SIGNAL_MAPPING_UPDATE, eSetBits);
+    if ( xEvent == ADC_EVENT_GATE_ON )
+    {
+        vMappingGateEdge(u32ChMask, true);
+    }
+    else if ( xEvent == ADC_EVENT_GATE_OFF )
+    {
+        vMappingGateEdge(u32ChMask, false);
+    }
+    else if ( (xEvent == ADC_EVENT_UPDATE) && (map_task_handle != NULL) )
+    {
+        BaseType_t xWakeTask = pdFALSE;
+
+        xTaskNotifyFromISR(map_task_handle, MAP_SIGNAL_ADC_UPDATE | (u32ChMask << MAP_SIGNAL_ADC_CH_SHIFT), eSetBits, &xWakeTask);
+        portYIELD_FROM_ISR(xWakeTask);
+    }
 }
 
 static void vMapMain(void *pvParameters)
@@ -461,7 +695,7 @@ static void vMapMain(void *pvParameters)
     vTaskDelay(pdMS_TO_TICKS(MAP_TASK_INIT_DELAY));
 
     /* Init ADC peripheral */
-    ADC_init(ADC_0, NULL);
+    ADC_init(ADC_0, vMappingAdcCallback);
 
     /* Init ADC conversion */
     ADC_start(ADC_0);
@@ -469,8 +703,14 @@ static void vMapMain(void *pvParameters)
     /* Show init msg */
     vCliPrintf(MAP_TASK_NAME, "Init");
 
-    /* Init update timer */
-    xTimerStart(xMappingUpdateTimer, 0U);
+    /* Default calibration is kept on units without calibration file */
+    StorageCmd_t xStorageCmd = { 0U };
+
+    xStorageCmd.eCmd = STORAGE_CMD_CAL_LOAD;
+    xStorageCmd.pvData = &xMapCalStorage;
+    xStorageCmd.pxDoneCb = vMapStorageDoneCb;
+
+    (void)bStorageSendCmd(xStorageCmd);
 
     for(;;)
     {
@@ -478,16 +718,64 @@ static void vMapMain(void *pvParameters)
 
         BaseType_t xEventWait = xTaskNotifyWait(0U, 
                                 (
-                                    MAP_SIGNAL_MAPPING_UPDATE
+                                    MAP_SIGNAL_MAPPING_UPDATE |
+                                    MAP_SIGNAL_CAL_LOADED |
+                                    MAP_SIGNAL_ADC_UPDATE |
+                                    MAP_SIGNAL_ADC_CH_MASK
                                 ), 
                                 &u32TaskEvent, 
                                 portMAX_DELAY);
 
         if (xEventWait == pdPASS)
         {
+            if ( RTOS_CHECK_SIGNAL(u32TaskEvent, MAP_SIGNAL_CAL_LOADED) )
+            {
+                if ( bMapCalLoadResult && (xSemaphoreTake(xMappingCfgMutex, portMAX_DELAY) == pdTRUE) )
+                {
+                    uint32_t u32InvalidMask = 0U;
+
+                    /* Stored data may be corrupted or from other hardware, out of range channels keep default */
+                    for (uint8_t u8MapChannel = 0U; u8MapChannel < MAP_CH_NUM; u8MapChannel++)
+                    {
+                        if ( bMapCalValid(xMapCalStorage.i32Offset[u8MapChannel], xMapCalStorage.u32Gain[u8MapChannel]) )
+                        {
+                            taskENTER_CRITICAL();
+                            xMapCal.i32Offset[u8MapChannel] = xMapCalStorage.i32Offset[u8MapChannel];
+                            xMapCal.u32Gain[u8MapChannel] = xMapCalStorage.u32Gain[u8MapChannel];
+                            taskEXIT_CRITICAL();
+                        }
+                        else
+                        {
+                            vMapCalDefault(u8MapChannel);
+                            u32InvalidMask |= (1UL << u8MapChannel);
+                        }
+                    }
+                    (void)xSemaphoreGive(xMappingCfgMutex);
+
+                    if ( u32InvalidMask != 0U )
+                    {
+                        vCliPrintf(MAP_TASK_NAME, "CAL: Load OK, out of range channels 0x%X, default used", u32InvalidMask);
+                    }
+                    else
+                    {
+                        vCliPrintf(MAP_TASK_NAME, "CAL: Load OK");
+                    }
+                }
+                else
+                {
+                    vCliPrintf(MAP_TASK_NAME, "CAL: Not found, default used");
+                }
+            }
+
             if ( RTOS_CHECK_SIGNAL(u32TaskEvent, MAP_SIGNAL_MAPPING_UPDATE) )
             {
-                vMappingUpdateLoop();
+                /* Cfg changed, refresh all channels */
+                vMappingInputCfgUpdate();
+                vMappingUpdateLoop(MAP_SIGNAL_ADC_CH_MASK >> MAP_SIGNAL_ADC_CH_SHIFT);
+            }
+            else if ( RTOS_CHECK_SIGNAL(u32TaskEvent, MAP_SIGNAL_ADC_UPDATE) )
+            {
+                vMappingUpdateLoop((u32TaskEvent & MAP_SIGNAL_ADC_CH_MASK) >> MAP_SIGNAL_ADC_CH_SHIFT);
             }
             else
             {
@@ -522,25 +810,101 @@ void vMapSetCfg(uint8_t u8MapId, MapElement_t xMapValue)
         ERR_ASSERT(0U);
     }
 
+    /* Apply new cfg without waiting for an input change */
+    (void)bMapTaskNotify(MAP_SIGNAL_MAPPING_UPDATE);
+
+}
+
+bool bMapCalSetPoint(uint8_t u8MapId, uint8_t u8Point, uint8_t u8Note)
+{
+    bool bRetval = false;
+    uint16_t u16AdcValue = 0U;
+
+    if ( (u8MapId < MAP_CH_NUM) && (u8Point < MAP_CAL_POINT_NUM) && (u8Note <= MAP_NOTE_MAX) )
+    {
+        if ( ADC_get_value(ADC_0, u8MapId, &u16AdcValue) == ADC_STATUS_OK )
+        {
+            u16MapCalAdc[u8MapId][u8Point] = u16AdcValue;
+            u8MapCalNote[u8MapId][u8Point] = u8Note;
+            bRetval = true;
+        }
+    }
+
+    if ( bRetval && (u8Point == MAP_CAL_POINT_HIGH) )
+    {
+        /* Input is inverting, high note gives lower counts */
+        uint32_t u32NoteSpan = (uint32_t)u8MapCalNote[u8MapId][MAP_CAL_POINT_HIGH] - u8MapCalNote[u8MapId][MAP_CAL_POINT_LOW];
+        int32_t i32AdcSpan = (int32_t)u16MapCalAdc[u8MapId][MAP_CAL_POINT_LOW] - (int32_t)u16MapCalAdc[u8MapId][MAP_CAL_POINT_HIGH];
+        uint32_t u32Gain = 0U;
+
+        if ( (u8MapCalNote[u8MapId][MAP_CAL_POINT_HIGH] >= (u8MapCalNote[u8MapId][MAP_CAL_POINT_LOW] + MAP_CAL_MIN_NOTE_SPAN)) && (i32AdcSpan > 0) )
+        {
+            u32Gain = ((u32NoteSpan * MAP_CENTS_NOTE * 65536UL) + ((uint32_t)i32AdcSpan / 2U)) / (uint32_t)i32AdcSpan;
+        }
+
+        bRetval = ( (u32Gain >= MAP_CAL_GAIN_MIN) && (u32Gain <= MAP_CAL_GAIN_MAX) );
+
+        if ( bRetval && (xSemaphoreTake(xMappingCfgMutex, portMAX_DELAY) == pdTRUE) )
+        {
+            uint32_t u32LowCents = (uint32_t)u8MapCalNote[u8MapId][MAP_CAL_POINT_LOW] * MAP_CENTS_NOTE;
+
+            int32_t i32Offset = (int32_t)u16MapCalAdc[u8MapId][MAP_CAL_POINT_LOW] + (int32_t)(((u32LowCents * 65536UL) + (u32Gain / 2U)) / u32Gain);
+
+            taskENTER_CRITICAL();
+            xMapCal.u32Gain[u8MapId] = u32Gain;
+            xMapCal.i32Offset[u8MapId] = i32Offset;
+            taskEXIT_CRITICAL();
+
+            (void)xSemaphoreGive(xMappingCfgMutex);
+
+            vCliPrintf(MAP_TASK_NAME, "CAL: CH %d, Offset %d, Gain %d", u8MapId, xMapCal.i32Offset[u8MapId], u32Gain);
+            vMapCalSave();
+        }
+    }
+
+    return bRetval;
+}
+
+void vMapCalReset(uint8_t u8MapId)
+{
+    ERR_ASSERT(u8MapId < MAP_CH_NUM);
+
+    if ( xSemaphoreTake(xMappingCfgMutex, portMAX_DELAY) == pdTRUE )
+    {
+        vMapCalDefault(u8MapId);
+        (void)xSemaphoreGive(xMappingCfgMutex);
+    }
+
+    vMapCalSave();
 }
 
 void vMapTaskInit(void)
 {
     /* Create task */
-    xTaskCreate(vMapMain, MAP_TASK_NAME, MAP_TASK_STACK, NULL, MAP_TASK_PRIO, &map_task_handle);
+    map_task_handle = xTaskCreateStatic(vMapMain, MAP_TASK_NAME, MAP_TASK_STACK, NULL, MAP_TASK_PRIO, pxMapTaskStack, &xMapTaskTcb);
     ERR_ASSERT( map_task_handle );
 
     /* Create mutex */
-    xMappingCfgMutex = xSemaphoreCreateMutex();
+    xMappingCfgMutex = xSemaphoreCreateMutexStatic(&xMappingCfgMutexCtrl);
     ERR_ASSERT( xMappingCfgMutex );
 
-    /* Create timer resources */
-    xMappingUpdateTimer = xTimerCreate("MappingUpdateTimer", 
-                                pdMS_TO_TICKS(MAP_TASK_UPDATE_RATE_MS), 
-                                pdTRUE, 
-                                (void *)0U, 
-                                vMappingUpdateCallback);
-    ERR_ASSERT( xMappingUpdateTimer );
+    /* Nominal V/Oct scale until stored calibration is loaded */
+    for (uint8_t u8MapChannel = 0U; u8MapChannel < MAP_CH_NUM; u8MapChannel++)
+    {
+        vMapCalDefault(u8MapChannel);
+    }
+}
+
+uint8_t u8MapBenchParamValues(uint16_t u16AdcValue)
+{
+    uint8_t u8Retval = 0U;
+
+    for (uint8_t u8ParameterId = 0U; u8ParameterId < (uint8_t)FM_VAR_SIZE_NUMBER; u8ParameterId++)
+    {
+        u8Retval ^= u8GetParamValue(u8ParameterId, u16AdcValue);
+    }
+
+    return u8Retval;
 }
 
 bool bMapTaskNotify(uint32_t u32Event)
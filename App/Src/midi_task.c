@@ -17,6 +17,7 @@
 
 #include "cli_task.h"
 #include "synth_task.h"
+#include "storage_task.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -30,24 +31,84 @@
 /* Serial interface */
 #define MIDI_SERIAL                         ( SERIAL_0 )
 
+/* Max decoded messages on each parser pass */
+#define MIDI_MSG_BATCH_SIZE                 ( 8U )
+
 /* Queue item size */
 #define MIDI_TASK_CMD_QUEUE_ELEMENT_SIZE    ( sizeof(MidiTaskCmd_t) )
 
 /* Queue size */
-#define MIDI_TASK_CMD_QUEUE_SIZE            ( 5U )
+#define MIDI_TASK_CMD_QUEUE_SIZE            ( 16U )
+
+/* SysEx payload layout: preset name is sent nibble packed, low nibble first */
+#define MIDI_SYSEX_NAME_LEN                 ( LFS_YM_CF_NAME_MAX_LEN - 1U )
+#define MIDI_SYSEX_NAME_NIBBLES             ( MIDI_SYSEX_NAME_LEN * 2U )
+#define MIDI_SYSEX_REG_LEN                  ( sizeof(xFmDevice_t) )
+#define MIDI_SYSEX_PROGRAM_LEN              ( 1U )
 
 /* Private macro -------------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
+
+/** SysEx decoder states */
+typedef enum
+{
+    MIDI_SYSEX_STATE_IDLE = 0x00U,
+    MIDI_SYSEX_STATE_VENDOR,
+    MIDI_SYSEX_STATE_CMD,
+    MIDI_SYSEX_STATE_PAYLOAD,
+    MIDI_SYSEX_STATE_SKIP,
+    MIDI_SYSEX_STATE_DONE,
+} MidiSysExState_t;
+
+/** SysEx streaming decoder control structure */
+typedef struct
+{
+    uint8_t u8State;
+    uint8_t u8Cmd;
+    uint8_t u8Program;
+    uint16_t u16Index;
+    bool bBusy;
+} MidiSysExDecoder_t;
+
 /* Private variables ---------------------------------------------------------*/
 
 /** Midi control structure */
 lfs_midi_data_t xMidiHandler = { 0U };
 
+/** Cfg buffers used by storage task, kept out of xMidiHandler until the request ends */
+static lfs_midi_data_t xMidiCfgLoadBuffer = { 0U };
+static lfs_midi_data_t xMidiCfgSaveBuffer = { 0U };
+static volatile bool bMidiCfgLoadResult = false;
+static volatile bool bMidiCfgSaveBusy = false;
+
+/** Preset loaded on each part */
+MidiPartPreset_t xMidiPartPreset[MIDI_NUM_CHANNEL] = { 0U };
+
+/** Parser for midi serial port */
+midi_parser_t xMidiParser = { 0U };
+
+/** SysEx decoder for midi serial port */
+MidiSysExDecoder_t xMidiSysEx = { 0U };
+
+/** Preset decoded from SysEx, owned by synth task while decoder is busy */
+lfs_ym_data_t xMidiSysExPreset = { 0U };
+
+/** Vendor id expected on SysEx header */
+static const uint8_t pu8MidiSysExVendorId[MIDI_SYSEX_VENDOR_ID_LEN] = {
+    MIDI_SYSEX_VENDOR_ID_0,
+    MIDI_SYSEX_VENDOR_ID_1,
+    MIDI_SYSEX_VENDOR_ID_2
+};
+
 /** Task handler */
 TaskHandle_t xMidiTaskHandle = NULL;
+static StaticTask_t xMidiTaskTcb;
+static StackType_t pxMidiTaskStack[MIDI_TASK_STACK];
 
 /** Queue for midi in_cmd */
 QueueHandle_t xMidiTaskCmdQueueHandle = NULL;
+static StaticQueue_t xMidiTaskCmdQueueCtrl;
+static uint8_t pu8MidiTaskCmdQueueStorage[MIDI_TASK_CMD_QUEUE_SIZE * MIDI_TASK_CMD_QUEUE_ELEMENT_SIZE];
 
 #ifdef MIDI_DBG_STATS
 volatile uint32_t u32NoteOnCount = 0U;
@@ -76,6 +137,19 @@ static void vHandleCmdSetChannel(MidiCmdTaskPayloadSetCh_t * pxCmdPayload);
  */
 static void vHandleCmdSetPreset(MidiCmdTaskPayloadSetPreset_t * pxCmdPayload);
 
+/**
+ * @brief Load bank and program on a single part in multi-timbral mode.
+ * @param pxCmdPayload 
+ */
+static void vHandleCmdSetPartPreset(MidiCmdTaskPayloadSetPartPreset_t * pxCmdPayload);
+
+/**
+ * @brief Set the same preset on all parts.
+ * @param u8Bank bank loaded.
+ * @param u8Program program loaded.
+ */
+static void vSetPartPresetAll(uint8_t u8Bank, uint8_t u8Program);
+
 /**
  * @brief Save current cfg into flash.
  */
@@ -88,11 +162,25 @@ static void vHandleCmdSaveMidiCfg(void);
 static void vResetMidiCfg(void);
 
 /**
-  * @brief Load data from persistence memory.
-  * @retval Operation result.
+  * @brief Request data load from persistence memory, applied on MIDI_SIGNAL_CFG_LOADED.
+  * @retval None.
   */
 static void vRestoreMidiCfg(void);
 
+/**
+  * @brief Apply cfg read by storage task.
+  * @retval None.
+  */
+static void vHandleCfgLoaded(void);
+
+/**
+  * @brief Storage done callback for midi cfg requests.
+  * @param pxCmd finished request.
+  * @param bResult request result.
+  * @retval None.
+  */
+static void vMidiStorageDoneCb(const StorageCmd_t * pxCmd, bool bResult);
+
 /**
   * @brief Handle note on.
   * @param pu8MidiCmd pointer to midi command.
@@ -107,6 +195,13 @@ static void vMidiCmdOn(uint8_t * pu8MidiCmd);
   */
 static void vMidiCmdOff(uint8_t * pu8MidiCmd);
 
+/**
+  * @brief Handle program change.
+  * @param pu8MidiCmd pointer to midi command.
+  * @retval None.
+  */
+static void vMidiCmdProgChange(uint8_t * pu8MidiCmd);
+
 /**
   * @brief Handle MIDI CC.
   * @param pu8MidiCmd pointer to midi command.
@@ -122,12 +217,33 @@ static void vMidiCmdCC(uint8_t * pu8MidiCmd);
 static void vHandleMidiCmd(uint8_t * pu8MidiCmd);
 
 /**
-  * @brief Callback for midi commands detection.
-  * @param pu8Data pointer of SysEx cmd.
-  * @param u32LenData len of SysEx cmd.
+  * @brief Dispatch a batch of decoded midi messages.
+  * @param pxMsgBatch pointer to decoded messages.
+  * @param u32NumMsg number of messages in batch.
+  * @retval None.
+  */
+static void vHandleMidiMsgBatch(midi_msg_t * pxMsgBatch, uint32_t u32NumMsg);
+
+/**
+  * @brief Callback for SysEx bytes, decoded as they are received.
+  * @param eEvent SysEx stream event.
+  * @param u8Data SysEx data byte, only valid for data events.
+  * @retval None.
+  */
+static void vMidiCmdSysExCallBack(midiSysExEvent_t eEvent, uint8_t u8Data);
+
+/**
+  * @brief Decode a SysEx payload byte.
+  * @param u8Data SysEx data byte.
   * @retval None.
   */
-static void vMidiCmdSysExCallBack(uint8_t *pu8Data, uint32_t u32LenData);
+static void vMidiSysExDecodeByte(uint8_t u8Data);
+
+/**
+  * @brief Execute a completed SysEx command.
+  * @retval None.
+  */
+static void vMidiSysExExecute(void);
 
 /**
   * @brief Callback for midi commands detection.
@@ -176,6 +292,8 @@ static void vResetMidiCfg(void)
     xMidiHandler.u8Program = LFS_MIDI_CFG_DEFAULT_PROG;
     xMidiHandler.u8BaseChannel = LFS_MIDI_CFG_DEFAULT_CH;
 
+    vSetPartPresetAll(LFS_MIDI_CFG_DEFAULT_BANK, LFS_MIDI_CFG_DEFAULT_PROG);
+
     /* Send mute all channels to synth task */
     SynthCmd_t xSynthCmd = { 0U };
 
@@ -184,38 +302,63 @@ static void vResetMidiCfg(void)
     (void)bSynthSendCmd(xSynthCmd);
 }
 
+static void vMidiStorageDoneCb(const StorageCmd_t * pxCmd, bool bResult)
+{
+    if ( pxCmd->eCmd == STORAGE_CMD_MIDI_LOAD )
+    {
+        bMidiCfgLoadResult = bResult;
+        (void)bMidiTaskNotify(MIDI_SIGNAL_CFG_LOADED);
+    }
+    else
+    {
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Save Midi CFG %s", bResult ? "OK" : "ERROR");
+        bMidiCfgSaveBusy = false;
+    }
+}
+
 static void vRestoreMidiCfg(void)
 {
-    /* Init flash data */
-    if ( LFS_init() == LFS_OK )
+    StorageCmd_t xStorageCmd = { 0U };
+
+    xStorageCmd.eCmd = STORAGE_CMD_MIDI_LOAD;
+    xStorageCmd.pvData = &xMidiCfgLoadBuffer;
+    xStorageCmd.pxDoneCb = vMidiStorageDoneCb;
+
+    /* Served once the file system is mounted, defaults are kept meanwhile */
+    if ( !bStorageSendCmd(xStorageCmd) )
     {
-        if ( LFS_read_midi_data(&xMidiHandler) == LFS_OK )
-        {
-            vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Mode %02X", xMidiHandler.u8Mode);
-            vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Channel %02X", xMidiHandler.u8BaseChannel);
-            vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Bank %02X", xMidiHandler.u8Bank);
-            vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Program %02X", xMidiHandler.u8Program);
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Error requesting flash data");
+        ERR_ASSERT(0U);
+    }
+}
 
-            // Load last used preset
-            SynthCmd_t xSynthCmd = { 0U };
+static void vHandleCfgLoaded(void)
+{
+    if ( bMidiCfgLoadResult )
+    {
+        (void)memcpy(&xMidiHandler, &xMidiCfgLoadBuffer, sizeof(lfs_midi_data_t));
 
-            xSynthCmd.eCmd = SYNTH_CMD_PRESET_UPDATE;
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Mode %02X", xMidiHandler.u8Mode);
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Channel %02X", xMidiHandler.u8BaseChannel);
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Bank %02X", xMidiHandler.u8Bank);
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Load Program %02X", xMidiHandler.u8Program);
 
-            xSynthCmd.uPayload.xPresetUpdate.u8Action = SYNTH_PRESET_ACTION_LOAD;
-            xSynthCmd.uPayload.xPresetUpdate.u8Bank = xMidiHandler.u8Bank;
-            xSynthCmd.uPayload.xPresetUpdate.u8Program = xMidiHandler.u8Program;
+        vSetPartPresetAll(xMidiHandler.u8Bank, xMidiHandler.u8Program);
 
-            (void)bSynthSendCmd(xSynthCmd);
-        }
-        else
-        {
-            vCliPrintf(MIDI_TASK_NAME, "FLASH: Error reading flash data");
-            ERR_ASSERT(0U);
-        }
+        // Load last used preset
+        SynthCmd_t xSynthCmd = { 0U };
+
+        xSynthCmd.eCmd = SYNTH_CMD_PRESET_UPDATE;
+
+        xSynthCmd.uPayload.xPresetUpdate.u8Action = SYNTH_PRESET_ACTION_LOAD;
+        xSynthCmd.uPayload.xPresetUpdate.u8Bank = xMidiHandler.u8Bank;
+        xSynthCmd.uPayload.xPresetUpdate.u8Program = xMidiHandler.u8Program;
+
+        (void)bSynthSendCmd(xSynthCmd);
     }
     else
     {
-        vCliPrintf(MIDI_TASK_NAME, "FLASH: Error on init FSM");
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Error reading flash data");
         ERR_ASSERT(0U);
     }
 }
@@ -303,6 +446,8 @@ static void vHandleCmdSetPreset(MidiCmdTaskPayloadSetPreset_t * pxCmdPayload)
     {
         vCliPrintf(MIDI_TASK_NAME, "LOAD BANK %d, PROGRAM %d - OK", u8NewBank, u8NewProgram);
 
+        vSetPartPresetAll(xMidiHandler.u8Bank, xMidiHandler.u8Program);
+
         SynthCmd_t xSynthCmd = { 0U };
 
         xSynthCmd.eCmd = SYNTH_CMD_PRESET_UPDATE;
@@ -318,16 +463,79 @@ static void vHandleCmdSetPreset(MidiCmdTaskPayloadSetPreset_t * pxCmdPayload)
     }
 }
 
+static void vHandleCmdSetPartPreset(MidiCmdTaskPayloadSetPartPreset_t * pxCmdPayload)
+{
+    uint8_t u8Part = pxCmdPayload->u8Part;
+    uint8_t u8NewBank = pxCmdPayload->u8Bank;
+    uint8_t u8NewProgram = pxCmdPayload->u8Program;
+    bool bLoadResult = false;
+
+    if ( u8Part < MIDI_NUM_CHANNEL )
+    {
+        if ( u8NewBank == LFS_MIDI_BANK_ROM )
+        {
+            bLoadResult = ( u8NewProgram < LFS_MIDI_CFG_MAX_PROG_BANK_FIX );
+        }
+        else if ( u8NewBank == LFS_MIDI_BANK_FLASH )
+        {
+            bLoadResult = ( u8NewProgram < LFS_MIDI_CFG_MAX_PROG_BANK_FLASH );
+        }
+    }
+
+    if ( bLoadResult )
+    {
+        vCliPrintf(MIDI_TASK_NAME, "LOAD PART %d: BANK %d, PROGRAM %d - OK", u8Part, u8NewBank, u8NewProgram);
+
+        xMidiPartPreset[u8Part].u8Bank = u8NewBank;
+        xMidiPartPreset[u8Part].u8Program = u8NewProgram;
+
+        SynthCmd_t xSynthCmd = { 0U };
+
+        xSynthCmd.eCmd = SYNTH_CMD_PART_PRESET_UPDATE;
+        xSynthCmd.uPayload.xPartPresetUpdate.u8Part = u8Part;
+        xSynthCmd.uPayload.xPartPresetUpdate.u8Bank = u8NewBank;
+        xSynthCmd.uPayload.xPartPresetUpdate.u8Program = u8NewProgram;
+
+        (void)bSynthSendCmd(xSynthCmd);
+    }
+    else
+    {
+        vCliPrintf(MIDI_TASK_NAME, "LOAD PART %d: BANK %d, PROGRAM %d - ERROR", u8Part, u8NewBank, u8NewProgram);
+    }
+}
+
+static void vSetPartPresetAll(uint8_t u8Bank, uint8_t u8Program)
+{
+    for ( uint8_t u8Part = 0U; u8Part < MIDI_NUM_CHANNEL; u8Part++ )
+    {
+        xMidiPartPreset[u8Part].u8Bank = u8Bank;
+        xMidiPartPreset[u8Part].u8Program = u8Program;
+    }
+}
+
 void vHandleCmdSaveMidiCfg(void)
 {
-    if ( LFS_write_midi_data(&xMidiHandler) == LFS_OK )
+    if ( bMidiCfgSaveBusy )
     {
-        vCliPrintf(MIDI_TASK_NAME, "FLASH: Save Midi CFG OK");
+        vCliPrintf(MIDI_TASK_NAME, "FLASH: Save Midi CFG BUSY");
     }
     else
     {
-        vCliPrintf(MIDI_TASK_NAME, "FLASH: Save Midi CFG ERROR");
-        ERR_ASSERT(0U);
+        StorageCmd_t xStorageCmd = { 0U };
+
+        /* Snapshot, xMidiHandler keeps changing while storage writes */
+        (void)memcpy(&xMidiCfgSaveBuffer, &xMidiHandler, sizeof(lfs_midi_data_t));
+
+        xStorageCmd.eCmd = STORAGE_CMD_MIDI_SAVE;
+        xStorageCmd.pvData = &xMidiCfgSaveBuffer;
+        xStorageCmd.pxDoneCb = vMidiStorageDoneCb;
+
+        bMidiCfgSaveBusy = bStorageSendCmd(xStorageCmd);
+
+        if ( !bMidiCfgSaveBusy )
+        {
+            vCliPrintf(MIDI_TASK_NAME, "FLASH: Save Midi CFG ERROR");
+        }
     }
 }
 
@@ -345,7 +553,7 @@ static void vMidiCmdOn(uint8_t * pu8MidiCmd)
     uint8_t u8Channel = u8Status & MIDI_STATUS_CH_MASK;
 
 #ifdef MIDI_DBG_VERBOSE
-    vCliPrintf(MIDI_TASK_NAME, "NOTE_ON : CH x%02X, NOTE x%02X, VEL x%02X", u8Channel, u8Note, u8Velocity);
+    CLI_LOG(MIDI_TASK_NAME, "NOTE_ON : CH x%02X, NOTE x%02X, VEL x%02X", u8Channel, u8Note, u8Velocity);
 #endif
 
     SynthCmd_t xSynthCmd = { 0U };
@@ -393,7 +601,7 @@ static void vMidiCmdOff(uint8_t * pu8MidiCmd)
     uint8_t u8Channel = u8Status & MIDI_STATUS_CH_MASK;
 
 #ifdef MIDI_DBG_VERBOSE
-    vCliPrintf(MIDI_TASK_NAME, "NOTE_OFF: CH x%02X, NOTE x%02X, VEL x%02X", u8Channel, u8Note, u8Velocity);
+    CLI_LOG(MIDI_TASK_NAME, "NOTE_OFF: CH x%02X, NOTE x%02X, VEL x%02X", u8Channel, u8Note, u8Velocity);
 #endif
 
     // Send new cmd VociceChUpdate
@@ -428,6 +636,36 @@ static void vMidiCmdOff(uint8_t * pu8MidiCmd)
     }
 }
 
+static void vMidiCmdProgChange(uint8_t * pu8MidiCmd)
+{
+    ERR_ASSERT(pu8MidiCmd);
+
+    uint8_t u8Status = *pu8MidiCmd++;
+    uint8_t u8Program = *pu8MidiCmd++;
+    uint8_t u8Channel = u8Status & MIDI_STATUS_CH_MASK;
+
+#ifdef MIDI_DBG_VERBOSE
+    CLI_LOG(MIDI_TASK_NAME, "PROG: CH x%02X, PROG x%02X", u8Channel, u8Program);
+#endif
+
+    /* Each part answers its own channel, program is taken from the bank already loaded on it */
+    if ( xMidiHandler.u8Mode == (uint8_t)MidiMode4 )
+    {
+        uint8_t u8Part = u8Channel - xMidiHandler.u8BaseChannel;
+
+        if ( ( u8Channel >= xMidiHandler.u8BaseChannel ) && ( u8Part < MIDI_NUM_CHANNEL ) )
+        {
+            MidiCmdTaskPayloadSetPartPreset_t xPartPreset = {
+                .u8Part = u8Part,
+                .u8Bank = xMidiPartPreset[u8Part].u8Bank,
+                .u8Program = u8Program,
+            };
+
+            vHandleCmdSetPartPreset(&xPartPreset);
+        }
+    }
+}
+
 static void vMidiCmdCC(uint8_t * pu8MidiCmd)
 {
     ERR_ASSERT(pu8MidiCmd);
@@ -438,7 +676,7 @@ static void vMidiCmdCC(uint8_t * pu8MidiCmd)
     uint8_t u8Channel = u8Status & MIDI_STATUS_CH_MASK;
 
 #ifdef MIDI_DBG_VERBOSE
-    vCliPrintf(MIDI_TASK_NAME, "CC: CH x%02X, CC x%02X, DATA: x%02X", u8Channel, u8CmdCc, u8Data);
+    CLI_LOG(MIDI_TASK_NAME, "CC: CH x%02X, CC x%02X, DATA: x%02X", u8Channel, u8CmdCc, u8Data);
 #endif
 
     if ( u8Channel == xMidiHandler.u8BaseChannel )
@@ -479,16 +717,215 @@ static void vHandleMidiCmd(uint8_t * pu8MidiCmd)
         {
             vMidiCmdCC(pu8MidiCmd);
         }
+        else if ((u8MidiCmd & MIDI_STATUS_CMD_MASK) == MIDI_STATUS_PROG_CHANGE)
+        {
+            vMidiCmdProgChange(pu8MidiCmd);
+        }
     }
 }
 
-static void vMidiCmdSysExCallBack(uint8_t *pu8Data, uint32_t u32LenData)
+static void vHandleMidiMsgBatch(midi_msg_t * pxMsgBatch, uint32_t u32NumMsg)
 {
-    ERR_ASSERT(pu8Data);
+    ERR_ASSERT(pxMsgBatch);
 
-#ifdef MIDI_DBG_VERBOSE
-    vCliPrintf(MIDI_TASK_NAME, "SYSEX: CMD LEN %d", u32LenData);
-#endif
+    for (uint32_t u32IndexMsg = 0U; u32IndexMsg < u32NumMsg; u32IndexMsg++)
+    {
+        midi_msg_t * pxMsg = &pxMsgBatch[u32IndexMsg];
+
+        switch (pxMsg->type)
+        {
+            case midiMsgData1:
+                vMidiCmd1CallBack(pxMsg->status, pxMsg->data0);
+                break;
+
+            case midiMsgData2:
+                vMidiCmd2CallBack(pxMsg->status, pxMsg->data0, pxMsg->data1);
+                break;
+
+            case midiMsgRt:
+                vMidiCmdRtCallBack(pxMsg->status);
+                break;
+
+            case midiMsgSysEx:
+                /* Decoded while received, run once its span is validated */
+                if (xMidiSysEx.u8State == MIDI_SYSEX_STATE_DONE)
+                {
+                    vMidiSysExExecute();
+                    xMidiSysEx.u8State = MIDI_SYSEX_STATE_IDLE;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+static void vMidiCmdSysExCallBack(midiSysExEvent_t eEvent, uint8_t u8Data)
+{
+    switch (eEvent)
+    {
+        case midiSysExStart:
+            if (xMidiSysEx.bBusy)
+            {
+                /* Last decoded preset still in use by synth task */
+                vCliPrintf(MIDI_TASK_NAME, "SYSEX: BUSY");
+                xMidiSysEx.u8State = MIDI_SYSEX_STATE_SKIP;
+            }
+            else
+            {
+                xMidiSysEx.u8State = MIDI_SYSEX_STATE_VENDOR;
+                xMidiSysEx.u8Cmd = MIDI_SYSEX_CMD_NO_DEF;
+                xMidiSysEx.u16Index = 0U;
+            }
+            break;
+
+        case midiSysExData:
+            vMidiSysExDecodeByte(u8Data);
+            break;
+
+        case midiSysExEnd:
+            /* Serial span not released yet, command is run from batch handling */
+            if (xMidiSysEx.u8State == MIDI_SYSEX_STATE_PAYLOAD)
+            {
+                xMidiSysEx.u8State = MIDI_SYSEX_STATE_DONE;
+            }
+            else
+            {
+                xMidiSysEx.u8State = MIDI_SYSEX_STATE_IDLE;
+            }
+            break;
+
+        case midiSysExAbort:
+        default:
+            if (xMidiSysEx.u8State != MIDI_SYSEX_STATE_IDLE)
+            {
+                vCliPrintf(MIDI_TASK_NAME, "SYSEX: ABORT");
+            }
+            xMidiSysEx.u8State = MIDI_SYSEX_STATE_IDLE;
+            break;
+    }
+}
+
+static void vMidiSysExDecodeByte(uint8_t u8Data)
+{
+    uint16_t u16Index = xMidiSysEx.u16Index;
+    uint8_t * pu8RegData = (uint8_t *)&xMidiSysExPreset.xPresetData;
+
+    switch (xMidiSysEx.u8State)
+    {
+        case MIDI_SYSEX_STATE_VENDOR:
+            if (u8Data != pu8MidiSysExVendorId[u16Index])
+            {
+                xMidiSysEx.u8State = MIDI_SYSEX_STATE_SKIP;
+            }
+            else if (++u16Index == MIDI_SYSEX_VENDOR_ID_LEN)
+            {
+                xMidiSysEx.u8State = MIDI_SYSEX_STATE_CMD;
+                u16Index = 0U;
+            }
+            break;
+
+        case MIDI_SYSEX_STATE_CMD:
+            xMidiSysEx.u8Cmd = u8Data;
+            xMidiSysEx.u8State = (u8Data <= MIDI_SYSEX_CMD_LOAD_DEFAULT_PRESET) ? MIDI_SYSEX_STATE_PAYLOAD : MIDI_SYSEX_STATE_SKIP;
+            break;
+
+        case MIDI_SYSEX_STATE_PAYLOAD:
+            if (xMidiSysEx.u8Cmd == MIDI_SYSEX_CMD_SET_REG)
+            {
+                if (u16Index < MIDI_SYSEX_REG_LEN)
+                {
+                    pu8RegData[u16Index] = u8Data;
+                }
+            }
+            else if (u16Index < MIDI_SYSEX_PROGRAM_LEN)
+            {
+                xMidiSysEx.u8Program = u8Data;
+            }
+            else if (xMidiSysEx.u8Cmd == MIDI_SYSEX_CMD_SAVE_PRESET)
+            {
+                uint16_t u16Offset = u16Index - MIDI_SYSEX_PROGRAM_LEN;
+
+                if (u16Offset < MIDI_SYSEX_NAME_NIBBLES)
+                {
+                    uint8_t * pu8Char = &xMidiSysExPreset.pu8Name[u16Offset / 2U];
+
+                    if ((u16Offset & 0x01U) == 0U)
+                    {
+                        *pu8Char = u8Data & 0x0FU;
+                    }
+                    else
+                    {
+                        *pu8Char |= (u8Data & 0x0FU) << 4U;
+                    }
+                }
+                else if ((u16Offset - MIDI_SYSEX_NAME_NIBBLES) < MIDI_SYSEX_REG_LEN)
+                {
+                    pu8RegData[u16Offset - MIDI_SYSEX_NAME_NIBBLES] = u8Data;
+                }
+            }
+
+            /* Count all bytes, length is checked when sysEx is completed */
+            if (u16Index < UINT16_MAX)
+            {
+                u16Index++;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    xMidiSysEx.u16Index = u16Index;
+}
+
+static void vMidiSysExExecute(void)
+{
+    uint16_t u16ExpectedLen = 0U;
+
+    switch (xMidiSysEx.u8Cmd)
+    {
+        case MIDI_SYSEX_CMD_SET_REG:
+            u16ExpectedLen = MIDI_SYSEX_REG_LEN;
+            break;
+
+        case MIDI_SYSEX_CMD_SAVE_PRESET:
+            u16ExpectedLen = MIDI_SYSEX_PROGRAM_LEN + MIDI_SYSEX_NAME_NIBBLES + MIDI_SYSEX_REG_LEN;
+            break;
+
+        default:
+            u16ExpectedLen = MIDI_SYSEX_PROGRAM_LEN;
+            break;
+    }
+
+    if (xMidiSysEx.u16Index != u16ExpectedLen)
+    {
+        vCliPrintf(MIDI_TASK_NAME, "SYSEX: CMD %d, LEN %d ERROR", xMidiSysEx.u8Cmd, xMidiSysEx.u16Index);
+    }
+    else if ((xMidiSysEx.u8Cmd == MIDI_SYSEX_CMD_SET_REG) || (xMidiSysEx.u8Cmd == MIDI_SYSEX_CMD_SAVE_PRESET))
+    {
+        SynthCmd_t xSynthCmd = { 0U };
+
+        xMidiSysExPreset.pu8Name[MIDI_SYSEX_NAME_LEN] = 0U;
+
+        xSynthCmd.eCmd = SYNTH_CMD_REG_UPDATE;
+        xSynthCmd.uPayload.xRegUpdate.u8Action = (xMidiSysEx.u8Cmd == MIDI_SYSEX_CMD_SAVE_PRESET) ? SYNTH_PRESET_ACTION_SAVE : SYNTH_PRESET_ACTION_LOAD;
+        xSynthCmd.uPayload.xRegUpdate.u8Program = xMidiSysEx.u8Program;
+        xSynthCmd.uPayload.xRegUpdate.pxPreset = &xMidiSysExPreset;
+
+        /* Synth task releases the preset with MIDI_SIGNAL_SYSEX_DONE */
+        xMidiSysEx.bBusy = bSynthSendCmd(xSynthCmd);
+    }
+    else
+    {
+        MidiCmdTaskPayloadSetPreset_t xSetPreset = { 0U };
+
+        xSetPreset.u8Bank = (xMidiSysEx.u8Cmd == MIDI_SYSEX_CMD_LOAD_PRESET) ? LFS_MIDI_BANK_FLASH : LFS_MIDI_BANK_ROM;
+        xSetPreset.u8Program = xMidiSysEx.u8Program;
+
+        vHandleCmdSetPreset(&xSetPreset);
+    }
 }
 
 static void vMidiCmd1CallBack(uint8_t u8Cmd, uint8_t u8Data)
@@ -506,7 +943,7 @@ static void vMidiCmd2CallBack(uint8_t u8Cmd, uint8_t u8Data0, uint8_t u8Data1)
 static void vMidiCmdRtCallBack(uint8_t u8RtCmd)
 {
 #ifdef MIDI_DBG_VERBOSE
-    vCliPrintf(MIDI_TASK_NAME, "RT: %02X", u8RtCmd);
+    CLI_LOG(MIDI_TASK_NAME, "RT: %02X", u8RtCmd);
 #endif
 }
 
@@ -544,12 +981,13 @@ static void vMidiMain(void *pvParameters)
     (void)SERIAL_init(MIDI_SERIAL, vSerialPortHandlerCallBack);
 
     /* Init MIDI library */
-    (void)midi_init(vMidiCmdSysExCallBack, vMidiCmd1CallBack, vMidiCmd2CallBack, vMidiCmdRtCallBack);
+    (void)midi_init(&xMidiParser, NULL, 0U, NULL, vMidiCmd1CallBack, vMidiCmd2CallBack, vMidiCmdRtCallBack);
+    midi_set_sys_ex_stream(&xMidiParser, vMidiCmdSysExCallBack);
 
     /* Reset midi control structure */
     vResetMidiCfg();
 
-    /* Init flash data */
+    /* Request stored cfg */
     vRestoreMidiCfg();
 
     for (;;)
@@ -559,34 +997,89 @@ static void vMidiMain(void *pvParameters)
 
         if (xEventWait == pdPASS)
         {
+            /* 
+            * Decoded SysEx preset released by synth task.
+            */
+            if ( RTOS_CHECK_SIGNAL(u32Event, MIDI_SIGNAL_SYSEX_DONE) )
+            {
+                xMidiSysEx.bBusy = false;
+            }
+
+            /* 
+            * Stored cfg read by storage task.
+            */
+            if ( RTOS_CHECK_SIGNAL(u32Event, MIDI_SIGNAL_CFG_LOADED) )
+            {
+                vHandleCfgLoaded();
+            }
+
             /* 
             * Handle Serial incomming data here.
             */
             if ( RTOS_CHECK_SIGNAL(u32Event, MIDI_SIGNAL_RX_DATA) )
             {
-                /* Process all buffered bytes */
-                uint8_t u8RxData = 0U;
+                /* Parse received bytes in place from serial DMA buffer */
+                serial_span_t xRxSpan[SERIAL_RX_SPAN_MAX];
+                midi_msg_t xMsgBatch[MIDI_MSG_BATCH_SIZE];
+                uint8_t u8NumSpan = 0U;
 
-                while ( SERIAL_read(MIDI_SERIAL, &u8RxData, 1U ) != 0U )
+                while ( (u8NumSpan = SERIAL_get_rx_spans(MIDI_SERIAL, xRxSpan)) != 0U )
                 {
+                    bool bRxOverrun = false;
+
+                    for (uint8_t u8IndexSpan = 0U; (u8IndexSpan < u8NumSpan) && !bRxOverrun; u8IndexSpan++)
+                    {
+                        const uint8_t * pu8RxData = xRxSpan[u8IndexSpan].data;
+                        size_t xLen = xRxSpan[u8IndexSpan].len;
+                        size_t xParsed = 0U;
+
 #ifdef MIDI_DBG_VERBOSE
-                    vCliPrintf(MIDI_TASK_NAME, "SERIAL IN: 0x%02X", u8RxData);
+                        CLI_LOG(MIDI_TASK_NAME, "SERIAL IN: %d bytes", xLen);
 #endif
 
 #ifdef MIDI_DBG_STATS
-                    if (u8RxData != 254U)
-                    {
-                        u32MidiByteCount++;
-                    }
+                        for (uint32_t u32IndexByte = 0U; u32IndexByte < xLen; u32IndexByte++)
+                        {
+                            if (pu8RxData[u32IndexByte] != 254U)
+                            {
+                                u32MidiByteCount++;
+                            }
+                        }
 #endif
-                    midi_update_fsm(u8RxData);
+
+                        while ( (xParsed < xLen) && !bRxOverrun )
+                        {
+                            size_t xUsed = 0U;
+                            size_t xNumMsg = midi_parse(&xMidiParser, &pu8RxData[xParsed], xLen - xParsed, xMsgBatch, MIDI_MSG_BATCH_SIZE, &xUsed);
+
+                            /* Batch is only valid if DMA did not write over it while parsed */
+                            if ( SERIAL_release_rx(MIDI_SERIAL, (uint16_t)xUsed) == SERIAL_STATUS_OK )
+                            {
+                                vHandleMidiMsgBatch(xMsgBatch, xNumMsg);
+                                xParsed += xUsed;
+                            }
+                            else
+                            {
+                                /* Pending data dropped by driver, restart parser on next byte received */
+                                (void)midi_reset_fsm(&xMidiParser);
+                                bRxOverrun = true;
+
+                                /* SysEx ended on a span written over by DMA, payload can not be trusted */
+                                if (xMidiSysEx.u8State == MIDI_SYSEX_STATE_DONE)
+                                {
+                                    vCliPrintf(MIDI_TASK_NAME, "SYSEX: OVERRUN");
+                                    xMidiSysEx.u8State = MIDI_SYSEX_STATE_IDLE;
+                                }
+                            }
+                        }
+                    }
                 }
             }
 
             /* 
             * Handle MIDI parameter change here.
             */
-            else if ( RTOS_CHECK_SIGNAL(u32Event, MIDI_SIGNAL_CMD_IN) )
+            if ( RTOS_CHECK_SIGNAL(u32Event, MIDI_SIGNAL_CMD_IN) )
             {
                 MidiTaskCmd_t xMidiCmd;
 
@@ -610,6 +1103,14 @@ static void vMidiMain(void *pvParameters)
                             vHandleCmdSaveMidiCfg();
                             break;
 
+                        case MIDI_CMD_SET_PART_PRESET:
+                            vHandleCmdSetPartPreset(&xMidiCmd.uPayload.xSetPartPreset);
+                            break;
+
+                        case MIDI_CMD_EXT_MSG:
+                            vMidiCmd2CallBack(xMidiCmd.uPayload.xExtMsg.u8Status, xMidiCmd.uPayload.xExtMsg.u8Data0, xMidiCmd.uPayload.xExtMsg.u8Data1);
+                            break;
+
                         default:
                             vCliPrintf(MIDI_TASK_NAME, "Not defined MidiTask cmd: x%02X", xMidiCmd.eCmd);
                             break;
@@ -652,14 +1153,21 @@ MidiParam_t xMidiGetParam(MidiParamType_t ePatamId)
     return xRetval;
 }
 
+MidiPartPreset_t xMidiGetPartPreset(uint8_t u8Part)
+{
+    ERR_ASSERT(u8Part < MIDI_NUM_CHANNEL);
+
+    return xMidiPartPreset[u8Part];
+}
+
 void vMidiTaskInit(void)
 {
     /* Create task */
-    xTaskCreate(vMidiMain, MIDI_TASK_NAME, MIDI_TASK_STACK, NULL, MIDI_TASK_PRIO, &xMidiTaskHandle);
+    xMidiTaskHandle = xTaskCreateStatic(vMidiMain, MIDI_TASK_NAME, MIDI_TASK_STACK, NULL, MIDI_TASK_PRIO, pxMidiTaskStack, &xMidiTaskTcb);
     ERR_ASSERT(xMidiTaskHandle);
 
     /* Create queue */
-    xMidiTaskCmdQueueHandle = xQueueCreate(MIDI_TASK_CMD_QUEUE_SIZE, MIDI_TASK_CMD_QUEUE_ELEMENT_SIZE);
+    xMidiTaskCmdQueueHandle = xQueueCreateStatic(MIDI_TASK_CMD_QUEUE_SIZE, MIDI_TASK_CMD_QUEUE_ELEMENT_SIZE, pu8MidiTaskCmdQueueStorage, &xMidiTaskCmdQueueCtrl);
     ERR_ASSERT(xMidiTaskCmdQueueHandle);
 }
 
@@ -0,0 +1,207 @@
+/**
+  ******************************************************************************
+  * @file           : storage_task.c
+  * @brief          : Task to handle file system access
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include "storage_task.h"
+
+#include "cli_task.h"
+#include "crash_store.h"
+
+#include "user_error.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Request queue size */
+#define STORAGE_CMD_QUEUE_SIZE              ( 8U )
+
+/* Request queue item size */
+#define STORAGE_CMD_QUEUE_ELEMENT_SIZE      ( sizeof(StorageCmd_t) )
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+
+/** Task handler */
+TaskHandle_t xStorageTaskHandle = NULL;
+static StaticTask_t xStorageTaskTcb;
+static StackType_t pxStorageTaskStack[STORAGE_TASK_STACK];
+
+/** Queue handler */
+QueueHandle_t xStorageCmdQueueHandle = NULL;
+static StaticQueue_t xStorageCmdQueueCtrl;
+static uint8_t pu8StorageCmdQueueStorage[STORAGE_CMD_QUEUE_SIZE * STORAGE_CMD_QUEUE_ELEMENT_SIZE];
+
+/** File system mounted */
+static volatile bool bStorageMounted = false;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/**
+  * @brief Execute a storage request, only called from storage task.
+  * @param pxCmd request to execute.
+  * @retval true operation done, false error.
+  */
+static bool bHandleStorageCmd(const StorageCmd_t * pxCmd);
+
+/**
+  * @brief Main task loop
+  * @param pvParameters function paramters
+  * @retval None
+  */
+static void vStorageMain(void *pvParameters);
+
+/* Private fuctions ----------------------------------------------------------*/
+
+static bool bHandleStorageCmd(const StorageCmd_t * pxCmd)
+{
+    lfs_status_t eResult = LFS_ERROR;
+
+    switch (pxCmd->eCmd)
+    {
+        case STORAGE_CMD_YM_LOAD:
+            if ( pxCmd->u8Slot < (uint8_t)LFS_YM_SLOT_NUM )
+            {
+                eResult = LFS_read_ym_data(pxCmd->u8Slot, (lfs_ym_data_t *)pxCmd->pvData);
+            }
+            break;
+
+        case STORAGE_CMD_YM_LOAD_CHANNEL:
+            if ( (pxCmd->u8Slot < (uint8_t)LFS_YM_SLOT_NUM) && (pxCmd->u8Channel < (uint8_t)YM2612_NUM_CHANNEL) )
+            {
+                eResult = LFS_read_ym_channel(pxCmd->u8Slot, pxCmd->u8Channel, (xFmChannel_t *)pxCmd->pvData);
+            }
+            break;
+
+        case STORAGE_CMD_YM_SAVE:
+            if ( pxCmd->u8Slot < (uint8_t)LFS_YM_SLOT_NUM )
+            {
+                eResult = LFS_write_ym_data(pxCmd->u8Slot, (lfs_ym_data_t *)pxCmd->pvData);
+            }
+            break;
+
+        case STORAGE_CMD_YM_DELETE:
+            if ( pxCmd->u8Slot < (uint8_t)LFS_YM_SLOT_NUM )
+            {
+                eResult = LFS_delete_ym_data(pxCmd->u8Slot);
+            }
+            break;
+
+        case STORAGE_CMD_MIDI_LOAD:
+            eResult = LFS_read_midi_data((lfs_midi_data_t *)pxCmd->pvData);
+            break;
+
+        case STORAGE_CMD_MIDI_SAVE:
+            eResult = LFS_write_midi_data((lfs_midi_data_t *)pxCmd->pvData);
+            break;
+
+        case STORAGE_CMD_CAL_LOAD:
+            eResult = LFS_read_cal_data((lfs_cal_data_t *)pxCmd->pvData);
+            break;
+
+        case STORAGE_CMD_CAL_SAVE:
+            eResult = LFS_write_cal_data((lfs_cal_data_t *)pxCmd->pvData);
+            break;
+
+        case STORAGE_CMD_CRASH_CLEAR:
+            eResult = bCrashStoreClear() ? LFS_OK : LFS_ERROR;
+            break;
+
+        default:
+            vCliPrintf(STORAGE_TASK_NAME, "Not defined command: x%02X", pxCmd->eCmd);
+            break;
+    }
+
+    return (eResult == LFS_OK);
+}
+
+static void vStorageMain(void *pvParameters)
+{
+    /* Init delay to for pow stabilization */
+    vTaskDelay(pdMS_TO_TICKS(STORAGE_TASK_INIT_DELAY));
+
+    /* Show init msg */
+    vCliPrintf(STORAGE_TASK_NAME, "Init");
+
+    /* Mount file system, requests queued meanwhile are served after it */
+    if ( LFS_init() == LFS_OK )
+    {
+        vCliPrintf(STORAGE_TASK_NAME, "FLASH: Init OK");
+        bStorageMounted = true;
+    }
+    else
+    {
+        vCliPrintf(STORAGE_TASK_NAME, "FLASH: Init ERROR");
+        ERR_ASSERT(0U);
+    }
+
+    for (;;)
+    {
+        StorageCmd_t xStorageCmd;
+
+        if (xQueueReceive(xStorageCmdQueueHandle, &xStorageCmd, portMAX_DELAY) == pdPASS)
+        {
+            bool bResult = false;
+            uint32_t u32StartUs = u32RtosGetTimeUs();
+
+            if ( bStorageMounted )
+            {
+                bResult = bHandleStorageCmd(&xStorageCmd);
+            }
+
+#ifdef STORAGE_DBG_VERBOSE
+            vCliPrintf(STORAGE_TASK_NAME, "CMD x%02X, SLOT %d: %d, %d us", xStorageCmd.eCmd, xStorageCmd.u8Slot, bResult, u32RtosGetTimeUs() - u32StartUs);
+#else
+            (void)u32StartUs;
+#endif
+
+            if ( xStorageCmd.pxDoneCb != NULL )
+            {
+                xStorageCmd.pxDoneCb(&xStorageCmd, bResult);
+            }
+        }
+    }
+}
+
+/* Public fuctions -----------------------------------------------------------*/
+
+void vStorageTaskInit(void)
+{
+    /* Create task */
+    xStorageTaskHandle = xTaskCreateStatic(vStorageMain, STORAGE_TASK_NAME, STORAGE_TASK_STACK, NULL, STORAGE_TASK_PRIO, pxStorageTaskStack, &xStorageTaskTcb);
+    ERR_ASSERT(xStorageTaskHandle);
+
+    /* Create queue */
+    xStorageCmdQueueHandle = xQueueCreateStatic(STORAGE_CMD_QUEUE_SIZE, STORAGE_CMD_QUEUE_ELEMENT_SIZE, pu8StorageCmdQueueStorage, &xStorageCmdQueueCtrl);
+    ERR_ASSERT(xStorageCmdQueueHandle);
+}
+
+bool bStorageSendCmd(StorageCmd_t xStorageCmd)
+{
+    bool bRetval = false;
+
+    if ( xStorageCmdQueueHandle != NULL )
+    {
+        if ( xQueueSend(xStorageCmdQueueHandle, &xStorageCmd, 0U) == pdPASS )
+        {
+            bRetval = true;
+        }
+        else
+        {
+            vCliPrintf(STORAGE_TASK_NAME, "CMD: Queue Error");
+        }
+    }
+
+    return bRetval;
+}
+
+bool bStorageReady(void)
+{
+    return bStorageMounted;
+}
+
+/* EOF */
@@ -14,6 +14,7 @@
 #include "cli_task.h"
 #include "ui_task.h"
 #include "midi_task.h"
+#include "storage_task.h"
 
 #include "printf.h"
 #include "user_error.h"
@@ -33,8 +34,20 @@
 #define SYNTH_CC_REG_NONE                   ( 0x00U )
 #define SYNTH_CC_REG_VOICE                  ( 0xF0U )
 #define SYNTH_CC_REG_OPERATOR               ( 0xF1U )
+#define SYNTH_CC_REG_VEL_CURVE              ( 0xF2U )
+#define SYNTH_CC_REG_VEL_SENS               ( 0xF3U )
 #define SYNTH_CC_REG_NOT_FOUND              ( 0xFFU )
 
+/* Number of entries of velocity curves, one per midi velocity value */
+#define SYNTH_VEL_CURVE_SIZE                ( 128U )
+
+/* Note played on bench note on test */
+#define SYNTH_BENCH_NOTE                    ( 60U )
+
+/* Storage request context for saves, preset owned by midi sysex decoder or by synth */
+#define SYNTH_STORAGE_CTX_LIVE              ( 0x00U )
+#define SYNTH_STORAGE_CTX_SYSEX             ( 0x01U )
+
 /* Private typedef -----------------------------------------------------------*/
 
 /** Voice data structure */
@@ -61,6 +74,8 @@ typedef struct
 {
     uint8_t u8CcVoice;
     uint8_t u8CcOperator;
+    uint8_t u8VelCurve;
+    uint8_t u8VelSens[SYNTH_MAX_NUM_VOICE][YM2612_NUM_OP_CHANNEL];
     SynthVoice_t xVoice[SYNTH_MAX_NUM_VOICE];
     SynthCtrlMono_t xCtrlMono;
     SynthCtrlPoly_t xCtrlPoly;
@@ -69,15 +84,74 @@ typedef struct
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 
+/** Velocity to attenuation, TL steps (0.75 dB), amplitude proportional to velocity */
+const static uint8_t u8VelCurveLinear[SYNTH_VEL_CURVE_SIZE] = {
+    127,  56,  48,  43,  40,  37,  35,  34,  32,  31,  29,  28,  27,  26,  26,  25,
+     24,  23,  23,  22,  21,  21,  20,  20,  19,  19,  18,  18,  18,  17,  17,  16,
+     16,  16,  15,  15,  15,  14,  14,  14,  13,  13,  13,  13,  12,  12,  12,  12,
+     11,  11,  11,  11,  10,  10,  10,  10,   9,   9,   9,   9,   9,   8,   8,   8,
+      8,   8,   8,   7,   7,   7,   7,   7,   7,   6,   6,   6,   6,   6,   6,   5,
+      5,   5,   5,   5,   5,   5,   5,   4,   4,   4,   4,   4,   4,   4,   3,   3,
+      3,   3,   3,   3,   3,   3,   3,   2,   2,   2,   2,   2,   2,   2,   2,   2,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   0,   0,   0,   0,   0,   0
+};
+
+/** Velocity to attenuation, TL steps (0.75 dB), 48 dB range linear in dB */
+const static uint8_t u8VelCurveExp[SYNTH_VEL_CURVE_SIZE] = {
+     64,  63,  63,  62,  62,  61,  61,  60,  60,  59,  59,  58,  58,  57,  57,  56,
+     56,  55,  55,  54,  54,  53,  53,  52,  52,  51,  51,  50,  50,  49,  49,  48,
+     48,  47,  47,  46,  46,  45,  45,  44,  44,  43,  43,  42,  42,  41,  41,  40,
+     40,  39,  39,  38,  38,  37,  37,  36,  36,  35,  35,  34,  34,  33,  33,  32,
+     32,  31,  31,  30,  30,  29,  29,  28,  28,  27,  27,  26,  26,  25,  25,  24,
+     24,  23,  23,  22,  22,  21,  21,  20,  20,  19,  19,  18,  18,  17,  17,  16,
+     16,  15,  15,  14,  14,  13,  13,  12,  12,  11,  11,  10,  10,   9,   9,   8,
+      8,   7,   7,   6,   6,   5,   5,   4,   4,   3,   3,   2,   2,   1,   1,   0
+};
+
 /** Task handler */
 TaskHandle_t xSynthTaskHandle = NULL;
+static StaticTask_t xSynthTaskTcb;
+static StackType_t pxSynthTaskStack[SYNTH_TASK_STACK];
 
 /** Queue event handler */
 QueueHandle_t xSynthEventQueueHandle = NULL;
+static StaticQueue_t xSynthEventQueueCtrl;
+static uint8_t pu8SynthEventQueueStorage[SYNTH_EVENT_QUEUE_SIZE * SYNTH_EVENT_QUEUE_ELEMENT_SIZE];
 
 /** Synth device handler */
 SynthCtrl_t xSynthDevHandler = { 0U };
 
+/** Preset load buffer, owned by storage task while a load is running */
+static lfs_ym_data_t xSynthLoadBuffer = { 0U };
+static bool bSynthLoadBusy = false;
+/** Time running load was requested, waits behind other loads are counted */
+static uint32_t u32SynthLoadStartUs = 0U;
+
+/** Preset generation, changed by every full preset load, flash, ROM or SysEx */
+static uint32_t u32SynthPresetGen = 0U;
+static uint32_t u32SynthLoadGen = 0U;
+
+/** Loads requested while busy, one per part and one for full preset, last request of each wins */
+static bool bSynthLoadPendingPreset = false;
+static uint8_t u8SynthLoadPendingPresetSlot = 0U;
+static uint32_t u32SynthLoadPendingPresetUs = 0U;
+static uint8_t u8SynthLoadPendingParts = 0U;
+static uint8_t pu8SynthLoadPendingPartSlot[SYNTH_MAX_NUM_VOICE] = { 0U };
+
+/** Preset save buffer, owned by storage task while a save is running */
+static lfs_ym_data_t xSynthSaveBuffer = { 0U };
+static bool bSynthSaveBusy = false;
+
+/** FM chip state published for other tasks, guarded by version sequence, odd while writing */
+static xFmDevice_t xSynthFmSnapshot = { 0U };
+static volatile uint32_t u32SynthFmVersion = 0U;
+
+/** Gate edge to key on latency, written by synth task */
+static rtos_bench_t xSynthGateBench = { UINT32_MAX, 0U, 0U, 0U };
+
+/** Voice notes last notified to ui */
+static uint8_t pu8SynthShownNote[SYNTH_MAX_NUM_VOICE] = { 0U };
+
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -87,6 +161,13 @@ SynthCtrl_t xSynthDevHandler = { 0U };
   */
 static void vHandleCmdVoiceUpdateMono(SynthCmdPayloadVoiceUpdateMono_t * pxCmdData);
 
+/**
+  * @brief Handle synth cmd voice pitch, retune a sounding mono voice.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdVoicePitch(SynthCmdPayloadVoicePitch_t * pxCmdData);
+
 /**
   * @brief Handle synth cmd voice update poly.
   * @param pxCmdData pointer to event data.
@@ -124,26 +205,116 @@ static uint8_t u8CcToRegData(uint8_t u8CcId, uint8_t u8CcData);
 static void vHandleCmdPresetUpdate(SynthCmdPayloadPresetUpdate_t * pxCmdData);
 
 /**
-  * @brief  Init user preset.
-  * @retval True if preset has been initiated correctly, false inc.
+  * @brief Handle synth cmd part preset update.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdPartPresetUpdate(SynthCmdPayloadPartPresetUpdate_t * pxCmdData);
+
+/**
+  * @brief Handle synth cmd register data update, only changed channels are written.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdRegUpdate(SynthCmdPayloadRegUpdate_t * pxCmdData);
+
+/**
+  * @brief Handle storage request done, called on synth task.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdStorageDone(SynthCmdPayloadStorageDone_t * pxCmdData);
+
+/**
+  * @brief Handle FM parameter edit from other tasks.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdFmParamSet(SynthCmdPayloadFmParamSet_t * pxCmdData);
+
+/**
+  * @brief Handle copy of first voice / operator over the rest.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdFmCopy(SynthCmdPayloadFmCopy_t * pxCmdData);
+
+/**
+  * @brief Handle raw register write from other tasks.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdRegWrite(SynthCmdPayloadRegWrite_t * pxCmdData);
+
+/**
+  * @brief Run chip workloads once, adding measures to requester bench.
+  *        Chip and preset state are restored before returning.
+  * @param pxCmdData pointer to event data.
+  * @retval None
+  */
+static void vHandleCmdBench(SynthCmdPayloadBench_t * pxCmdData);
+
+/**
+  * @brief Publish FM chip state for readers and request ui refresh.
+  * @retval None
   */
-static bool bInitUserPreset(void);
+static void vPublishFmState(void);
 
 /**
-  * @brief Save preset on fixed position.
+  * @brief Request ui refresh if a voice note changed since last call.
+  * @retval None
+  */
+static void vPublishVoiceState(void);
+
+/**
+  * @brief Storage done callback, forward result to synth task queue.
+  * @param pxCmd finished request.
+  * @param bResult request result.
+  * @retval None
+  */
+static void vSynthStorageDoneCb(const StorageCmd_t * pxCmd, bool bResult);
+
+/**
+  * @brief Request save of a preset on fixed position.
   * @param u8Position Position where save the preset.
   * @param pu8Name Pointer with preset name.
   * @param pxRegData Preset reg data.
-  * @retval true, preset saved, false, error on saving.
+  * @retval true, save requested, false, error on request.
   */
 static bool bSavePresetFlash(uint8_t u8Position, uint8_t * pu8Name, xFmDevice_t * pxRegData);
 
 /**
-  * @brief Load preset.
-  * @param u8Position Position where save the preset.
-  * @retval true, preset loaded, false, error on loading.
+  * @brief Request a preset or a single channel load, applied when storage finishes.
+  * @param eCmd STORAGE_CMD_YM_LOAD or STORAGE_CMD_YM_LOAD_CHANNEL.
+  * @param u8Position Position of the preset.
+  * @param u8Part Part to update on channel load.
+  * @retval true, load requested, false, error on request.
   */
-static bool bLoadPresetFlash(uint8_t u8Position);
+static bool bLoadPresetFlash(StorageCmdType_t eCmd, uint8_t u8Position, uint8_t u8Part);
+
+/**
+  * @brief Send a load request to storage task, load buffer must be free.
+  * @param eCmd STORAGE_CMD_YM_LOAD or STORAGE_CMD_YM_LOAD_CHANNEL.
+  * @param u8Position Position of the preset.
+  * @param u8Part Part to update on channel load.
+  * @param u32RequestUs Time load was requested, microseconds.
+  * @retval true, load requested, false, error on request.
+  */
+static bool bStartLoadFlash(StorageCmdType_t eCmd, uint8_t u8Position, uint8_t u8Part, uint32_t u32RequestUs);
+
+/**
+  * @brief Start next pending load, full preset first, then parts.
+  * @retval None
+  */
+static void vStartLoadPending(void);
+
+/**
+  * @brief Load a single channel timbre into a part.
+  * @param u8Part part to update.
+  * @param pxChannelData channel register data.
+  * @retval None
+  */
+static void vLoadPartChannel(uint8_t u8Part, xFmChannel_t * pxChannelData);
 
 /**
   * @brief Load default preset.
@@ -164,6 +335,15 @@ static bool bInitPreset(void);
   */
 static void vCmdVoiceOffAll(void);
 
+/**
+  * @brief Play note on a voice applying velocity to carrier levels.
+  * @param u8Voice voice to play.
+  * @param u8Note note to play.
+  * @param u8Velocity velocity of action.
+  * @retval True if note played, false ioc.
+  */
+static bool bVoiceNoteOn(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity);
+
 /**
  * @brief Handle voice on in mono mode.
  * @param u8Voice Voice to update
@@ -233,7 +413,7 @@ static void vHandleCmdVoiceUpdatePoly(SynthCmdPayloadVoiceUpdatePoly_t * pxCmdDa
     ERR_ASSERT(pxCmdData);
 
 #ifdef SYNTH_DBG_VERBOSE
-    vCliPrintf(SYNTH_TASK_NAME, "VOICE_UPDATE_POLY: State %02X, Note %02X, Vel %02X, ", pxCmdData->u8VoiceState, pxCmdData->u8Note, pxCmdData->u8Velocity);
+    CLI_LOG(SYNTH_TASK_NAME, "VOICE_UPDATE_POLY: State %02X, Note %02X, Vel %02X, ", pxCmdData->u8VoiceState, pxCmdData->u8Note, pxCmdData->u8Velocity);
 #endif
 
     if ( pxCmdData->u8VoiceState == (uint8_t)SYNTH_VOICE_STATE_ON )
@@ -304,6 +484,24 @@ static void vHandleCmdParameterUpdate(SynthCmdPayloadParamUpdate_t * pxCmdData)
         }
         break;
 
+    case SYNTH_CC_REG_VEL_CURVE:
+        xSynthDevHandler.u8VelCurve = u8RegData;
+        break;
+
+    case SYNTH_CC_REG_VEL_SENS:
+        if (u8RegVoice < SYNTH_MAX_NUM_VOICE)
+        {
+            xSynthDevHandler.u8VelSens[u8RegVoice][u8RegOperator] = u8RegData;
+        }
+        else if (u8RegVoice == SYNTH_MAX_NUM_VOICE)
+        {
+            for (uint8_t u8Index = 0U; u8Index < SYNTH_MAX_NUM_VOICE; u8Index++)
+            {
+                xSynthDevHandler.u8VelSens[u8Index][u8RegOperator] = u8RegData;
+            }
+        }
+        break;
+
     case FM_VAR_LFO_FREQ:
         pxDevCfg->u8LfoFreq = u8RegData;
         bRegUpdate = true;
@@ -573,14 +771,14 @@ static void vHandleCmdParameterUpdate(SynthCmdPayloadParamUpdate_t * pxCmdData)
     if (bRegUpdate)
     {
 #ifdef SYNTH_DBG_VERBOSE
-        vCliPrintf(SYNTH_TASK_NAME, "Process parameter: CC %02X - %02X, REG %02X - %02X", pxCmdData->u8Id, pxCmdData->u8Data, u8RegId, u8RegData);
+        CLI_LOG(SYNTH_TASK_NAME, "Process parameter: CC %02X - %02X, REG %02X - %02X", pxCmdData->u8Id, pxCmdData->u8Data, u8RegId, u8RegData);
 #endif
         vYM2612_set_reg_preset(pxDevCfg);
     }
     else
     {
 #ifdef SYNTH_DBG_VERBOSE
-        vCliPrintf(SYNTH_TASK_NAME, "Process parameter: CC %02X - %02X, FAIL", pxCmdData->u8Id, pxCmdData->u8Data);
+        CLI_LOG(SYNTH_TASK_NAME, "Process parameter: CC %02X - %02X, FAIL", pxCmdData->u8Id, pxCmdData->u8Data);
 #endif
     }
 }
@@ -627,6 +825,10 @@ static uint8_t u8CcToRegId(uint8_t u8CcId)
         u8RegId = (uint8_t)FM_VAR_VOICE_PHA_MOD_SENS;
         break;
 
+    case MIDI_CC_C28:
+        u8RegId = SYNTH_CC_REG_VEL_CURVE;
+        break;
+
     case MIDI_CC_C52:
         u8RegId = (uint8_t)FM_VAR_OPERATOR_DETUNE;
         break;
@@ -671,6 +873,10 @@ static uint8_t u8CcToRegId(uint8_t u8CcId)
         u8RegId = (uint8_t)FM_VAR_OPERATOR_SSG_ENVELOPE;
         break;
 
+    case MIDI_CC_C63:
+        u8RegId = SYNTH_CC_REG_VEL_SENS;
+        break;
+
     default:
         u8RegId = SYNTH_CC_REG_NOT_FOUND;
         break;
@@ -721,6 +927,10 @@ static uint8_t u8CcToRegData(uint8_t u8CcId, uint8_t u8CcData)
         u8RegData = (u8CcData < MAX_VALUE_PHA_MOD_SENS) ? u8CcData : (MAX_VALUE_PHA_MOD_SENS - 1U);
         break;
 
+    case MIDI_CC_C28:
+        u8RegData = (u8CcData < SYNTH_VEL_CURVE_NUM) ? u8CcData : (SYNTH_VEL_CURVE_NUM - 1U);
+        break;
+
     case MIDI_CC_C52:
         u8RegData = (u8CcData < MAX_VALUE_DETUNE) ? u8CcData : (MAX_VALUE_DETUNE - 1U);
         break;
@@ -765,6 +975,10 @@ static uint8_t u8CcToRegData(uint8_t u8CcId, uint8_t u8CcData)
         u8RegData = (u8CcData < MAX_VALUE_SSG_ENVELOPE) ? u8CcData : (MAX_VALUE_SSG_ENVELOPE - 1U);
         break;
 
+    case MIDI_CC_C63:
+        u8RegData = (u8CcData <= SYNTH_VEL_SENS_MAX) ? u8CcData : SYNTH_VEL_SENS_MAX;
+        break;
+
     default:
         // Not CC found
         break;
@@ -785,7 +999,7 @@ static void vHandleCmdPresetUpdate(SynthCmdPayloadPresetUpdate_t * pxCmdData)
         }
         else if ( pxCmdData->u8Bank == (uint8_t)LFS_MIDI_BANK_FLASH )
         {
-            (void)bLoadPresetFlash(pxCmdData->u8Program);
+            (void)bLoadPresetFlash(STORAGE_CMD_YM_LOAD, pxCmdData->u8Program, 0U);
         }
         else
         {
@@ -808,134 +1022,339 @@ static void vHandleCmdPresetUpdate(SynthCmdPayloadPresetUpdate_t * pxCmdData)
     }
 }
 
-static bool bInitUserPreset(void)
+static void vHandleCmdPartPresetUpdate(SynthCmdPayloadPartPresetUpdate_t * pxCmdData)
 {
-    bool bRetVal = false;
+    ERR_ASSERT(pxCmdData);
+
+    uint8_t u8Part = pxCmdData->u8Part;
+    bool bLoadResult = false;
+    xFmChannel_t xChannelData = { 0U };
 
-    /* If init fails, data could be empty o corrupted so try to write default data on it */
-    if ( LFS_init() == LFS_OK)
+    if ( u8Part < SYNTH_MAX_NUM_VOICE )
     {
-        vCliPrintf(SYNTH_TASK_NAME, "User Preset Data Init: OK");
-        bRetVal = true;
+        if ( pxCmdData->u8Bank == (uint8_t)LFS_MIDI_BANK_ROM )
+        {
+            xFmDevice_t * pxPresetData = (xFmDevice_t *)pxSYNTH_APP_DATA_CONST_get(pxCmdData->u8Program);
+
+            if (pxPresetData != NULL)
+            {
+                xChannelData = pxPresetData->xChannel[SYNTH_PART_PRESET_SRC_CHANNEL];
+                bLoadResult = true;
+            }
+        }
+        else if ( pxCmdData->u8Bank == (uint8_t)LFS_MIDI_BANK_FLASH )
+        {
+            /* Channel is applied when storage task finishes the read */
+            if ( pxCmdData->u8Program < LFS_YM_SLOT_NUM )
+            {
+                if ( bLoadPresetFlash(STORAGE_CMD_YM_LOAD_CHANNEL, pxCmdData->u8Program, u8Part) )
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    if ( bLoadResult )
+    {
+        vLoadPartChannel(u8Part, &xChannelData);
+
+        vCliPrintf(SYNTH_TASK_NAME, "LOAD PART %d: BANK %d, PROGRAM %d - OK", u8Part, pxCmdData->u8Bank, pxCmdData->u8Program);
     }
     else
     {
-        vCliPrintf(SYNTH_TASK_NAME, "User Preset Data Init: ERROR");
-        ERR_ASSERT(0U);
+        vCliPrintf(SYNTH_TASK_NAME, "LOAD PART %d: BANK %d, PROGRAM %d - ERROR", u8Part, pxCmdData->u8Bank, pxCmdData->u8Program);
     }
+}
 
-    return bRetVal;
+static void vLoadPartChannel(uint8_t u8Part, xFmChannel_t * pxChannelData)
+{
+    /* Only the target part is released, notes on other parts keep sounding */
+    vYM2612_key_off(u8Part);
+
+    xSynthDevHandler.xVoice[u8Part].u8Note = MIDI_DATA_NOT_VALID;
+    xSynthDevHandler.xVoice[u8Part].u8Velocity = MIDI_DATA_NOT_VALID;
+    xSynthDevHandler.xCtrlMono.xVoiceTmp[u8Part].u8Note = MIDI_DATA_NOT_VALID;
+    xSynthDevHandler.xCtrlMono.xVoiceTmp[u8Part].u8Velocity = MIDI_DATA_NOT_VALID;
+
+    vYM2612_set_reg_channel(u8Part, pxChannelData);
 }
 
-static bool bSavePresetFlash(uint8_t u8Position, uint8_t * pu8Name, xFmDevice_t * pxRegData)
+static void vHandleCmdRegUpdate(SynthCmdPayloadRegUpdate_t * pxCmdData)
 {
-    bool bRetVal = false;
-    lfs_ym_data_t xPresetData = {0};
+    ERR_ASSERT(pxCmdData);
+    ERR_ASSERT(pxCmdData->pxPreset);
 
-    if (u8Position < LFS_YM_SLOT_NUM)
-    {
-        /* Copy name */
-        (void)memcpy(&xPresetData.pu8Name, pu8Name, LFS_YM_CF_NAME_MAX_LEN);
-        /* Copy reg */
-        (void)memcpy(&xPresetData.xPresetData, pxRegData, sizeof(xFmDevice_t));
+    xFmDevice_t * pxDevCfg = pxYM2612_get_reg_preset();
+    xFmDevice_t * pxNewCfg = &pxCmdData->pxPreset->xPresetData;
 
-        if ( LFS_write_ym_data(u8Position, &xPresetData) == LFS_OK )
-        {
-            vCliPrintf(SYNTH_TASK_NAME, "SAVE PRESET %d - %s: OK", u8Position, pu8Name);
-            bRetVal = true;
-        }
-        else
+    if ( (pxNewCfg->u8LfoOn != pxDevCfg->u8LfoOn) || (pxNewCfg->u8LfoFreq != pxDevCfg->u8LfoFreq) )
+    {
+        vYM2612_set_reg_preset(pxNewCfg);
+    }
+    else
+    {
+        for (uint8_t u8Voice = 0U; u8Voice < SYNTH_MAX_NUM_VOICE; u8Voice++)
         {
-            vCliPrintf(SYNTH_TASK_NAME, "SAVE PRESET %d - %s: ERROR", u8Position, pu8Name);
-            ERR_ASSERT(0U);
+            if ( memcmp(&pxNewCfg->xChannel[u8Voice], &pxDevCfg->xChannel[u8Voice], sizeof(xFmChannel_t)) != 0 )
+            {
+                vYM2612_set_reg_channel((YM2612_ch_id_t)u8Voice, &pxNewCfg->xChannel[u8Voice]);
+            }
         }
     }
-    else
+
+    /* Applied now, any flash load requested before is stale */
+    u32SynthPresetGen++;
+    bSynthLoadPendingPreset = false;
+    u8SynthLoadPendingParts = 0U;
+
+    bool bSaveRequested = false;
+
+    if ( (pxCmdData->u8Action == (uint8_t)SYNTH_PRESET_ACTION_SAVE) && (pxCmdData->u8Program < LFS_YM_SLOT_NUM) )
     {
-        vCliPrintf(SYNTH_TASK_NAME, "SAVE SLOT NOT VALID");
+        /* Written straight from sysex buffer, released when storage finishes */
+        StorageCmd_t xStorageCmd = { 0U };
+
+        xStorageCmd.eCmd = STORAGE_CMD_YM_SAVE;
+        xStorageCmd.u8Slot = pxCmdData->u8Program;
+        xStorageCmd.u32Ctx = SYNTH_STORAGE_CTX_SYSEX;
+        xStorageCmd.pvData = pxCmdData->pxPreset;
+        xStorageCmd.pxDoneCb = vSynthStorageDoneCb;
+
+        bSaveRequested = bStorageSendCmd(xStorageCmd);
     }
 
-    return bRetVal;
+    /* Preset data no longer used, release it */
+    if ( !bSaveRequested )
+    {
+        (void)bMidiTaskNotify(MIDI_SIGNAL_SYSEX_DONE);
+    }
 }
 
-static bool bLoadPresetFlash(uint8_t u8Position)
+static void vSynthStorageDoneCb(const StorageCmd_t * pxCmd, bool bResult)
 {
-    bool bRetVal = false;
-    lfs_ym_data_t xPresetData = {0};
+    SynthCmd_t xSynthCmd = { 0U };
+
+    xSynthCmd.eCmd = SYNTH_CMD_STORAGE_DONE;
+    xSynthCmd.uPayload.xStorageDone.u8Cmd = (uint8_t)pxCmd->eCmd;
+    xSynthCmd.uPayload.xStorageDone.u8Slot = pxCmd->u8Slot;
+    xSynthCmd.uPayload.xStorageDone.u8Ctx = (uint8_t)pxCmd->u32Ctx;
+    xSynthCmd.uPayload.xStorageDone.u8Result = (uint8_t)bResult;
 
-    if ( LFS_read_ym_data(u8Position, &xPresetData) == LFS_OK )
+    /* Buffers stay owned by storage until synth handles this command */
+    while ( !bSynthSendCmd(xSynthCmd) )
     {
-        vYM2612_set_reg_preset(&xPresetData.xPresetData);
+        vTaskDelay(pdMS_TO_TICKS(1U));
+    }
+}
 
-        vCliPrintf(SYNTH_TASK_NAME, "LOAD PRESET %d - %s: OK", u8Position, xPresetData.pu8Name);
-        bRetVal = true;
+static void vHandleCmdStorageDone(SynthCmdPayloadStorageDone_t * pxCmdData)
+{
+    ERR_ASSERT(pxCmdData);
+
+    uint8_t u8Position = pxCmdData->u8Slot;
+    bool bResult = (pxCmdData->u8Result != 0U);
+
+    switch ( pxCmdData->u8Cmd )
+    {
+        case STORAGE_CMD_YM_LOAD:
+        case STORAGE_CMD_YM_LOAD_CHANNEL:
+            bSynthLoadBusy = false;
+
+            /* Stale if a full preset was loaded meanwhile, or a newer load for the same part is pending */
+            if ( (u32SynthLoadGen != u32SynthPresetGen) ||
+                 ((pxCmdData->u8Cmd == (uint8_t)STORAGE_CMD_YM_LOAD_CHANNEL) && ((u8SynthLoadPendingParts & (1U << pxCmdData->u8Ctx)) != 0U)) )
+            {
+                vCliPrintf(SYNTH_TASK_NAME, "LOAD PRESET %d: SUPERSEDED", u8Position);
+            }
+            else if ( !bResult )
+            {
+                vCliPrintf(SYNTH_TASK_NAME, "LOAD PRESET %d: ERROR", u8Position);
+            }
+            else if ( pxCmdData->u8Cmd == (uint8_t)STORAGE_CMD_YM_LOAD_CHANNEL )
+            {
+                vLoadPartChannel(pxCmdData->u8Ctx, &xSynthLoadBuffer.xPresetData.xChannel[0U]);
+
+                vCliPrintf(SYNTH_TASK_NAME, "LOAD PART %d: BANK %d, PROGRAM %d - OK", pxCmdData->u8Ctx, LFS_MIDI_BANK_FLASH, u8Position);
+            }
+            else
+            {
+                lfs_ym_dir_entry_t xEntry;
+                uint32_t u32LoadUs = 0U;
+
+                vYM2612_set_reg_preset(&xSynthLoadBuffer.xPresetData);
+
+                /* Full path, request to registers written */
+                u32LoadUs = u32RtosGetTimeUs() - u32SynthLoadStartUs;
+
+                vCliPrintf(SYNTH_TASK_NAME, "LOAD PRESET %d - %s: OK, %d us%s", u8Position, xSynthLoadBuffer.pu8Name, u32LoadUs,
+                            LFS_set_ym_first_load(u8Position, u32LoadUs) ? ", FIRST" : "");
+
+                if ( LFS_get_ym_dir_entry(LFS_MIDI_BANK_FLASH, u8Position, &xEntry) == LFS_OK )
+                {
+                    if ( xEntry.u32Crc != LFS_get_ym_crc(&xSynthLoadBuffer.xPresetData) )
+                    {
+                        vCliPrintf(SYNTH_TASK_NAME, "LOAD PRESET %d: CRC MISMATCH", u8Position);
+                    }
+                }
+            }
+
+            vStartLoadPending();
+            break;
+
+        case STORAGE_CMD_YM_SAVE:
+            if ( pxCmdData->u8Ctx == SYNTH_STORAGE_CTX_SYSEX )
+            {
+                (void)bMidiTaskNotify(MIDI_SIGNAL_SYSEX_DONE);
+            }
+            else
+            {
+                bSynthSaveBusy = false;
+            }
+
+            vCliPrintf(SYNTH_TASK_NAME, "SAVE PRESET %d: %s", u8Position, bResult ? "OK" : "ERROR");
+            break;
+
+        default:
+            break;
+    }
+}
+
+static bool bSavePresetFlash(uint8_t u8Position, uint8_t * pu8Name, xFmDevice_t * pxRegData)
+{
+    bool bRetVal = false;
+
+    if ( u8Position >= LFS_YM_SLOT_NUM )
+    {
+        vCliPrintf(SYNTH_TASK_NAME, "SAVE SLOT NOT VALID");
+    }
+    else if ( bSynthSaveBusy )
+    {
+        vCliPrintf(SYNTH_TASK_NAME, "SAVE PRESET %d: BUSY", u8Position);
     }
     else
     {
-        vCliPrintf(SYNTH_TASK_NAME, "LOAD PRESET %d: ERROR", u8Position);
-        ERR_ASSERT(0U);
+        StorageCmd_t xStorageCmd = { 0U };
+
+        /* Copy name */
+        (void)memcpy(&xSynthSaveBuffer.pu8Name, pu8Name, LFS_YM_CF_NAME_MAX_LEN);
+        /* Copy reg */
+        (void)memcpy(&xSynthSaveBuffer.xPresetData, pxRegData, sizeof(xFmDevice_t));
+
+        xStorageCmd.eCmd = STORAGE_CMD_YM_SAVE;
+        xStorageCmd.u8Slot = u8Position;
+        xStorageCmd.u32Ctx = SYNTH_STORAGE_CTX_LIVE;
+        xStorageCmd.pvData = &xSynthSaveBuffer;
+        xStorageCmd.pxDoneCb = vSynthStorageDoneCb;
+
+        bRetVal = bStorageSendCmd(xStorageCmd);
+        bSynthSaveBusy = bRetVal;
     }
 
     return bRetVal;
 }
 
-static bool bLoadPresetRom(uint8_t u8Position)
+static bool bLoadPresetFlash(StorageCmdType_t eCmd, uint8_t u8Position, uint8_t u8Part)
 {
-    bool bRetVal = false;
-    xFmDevice_t * pxPresetData = (xFmDevice_t *)pxSYNTH_APP_DATA_CONST_get(u8Position);
+    bool bRetVal = true;
+    uint32_t u32RequestUs = u32RtosGetTimeUs();
 
-    if (pxPresetData != NULL)
+    if ( eCmd == STORAGE_CMD_YM_LOAD )
     {
-        vYM2612_set_reg_preset(pxPresetData);
+        /* Full preset overwrites every part, older part loads are dropped */
+        u32SynthPresetGen++;
+        u8SynthLoadPendingParts = 0U;
+    }
 
-        vCliPrintf(SYNTH_TASK_NAME, "LOAD DEFAULT PRESET %d", u8Position);
-        bRetVal = true;
+    if ( !bSynthLoadBusy )
+    {
+        bRetVal = bStartLoadFlash(eCmd, u8Position, u8Part, u32RequestUs);
+    }
+    else if ( eCmd == STORAGE_CMD_YM_LOAD )
+    {
+        bSynthLoadPendingPreset = true;
+        u8SynthLoadPendingPresetSlot = u8Position;
+        u32SynthLoadPendingPresetUs = u32RequestUs;
     }
     else
     {
-        vCliPrintf(SYNTH_TASK_NAME, "LOAD DEFAULT PRESET %d: ERROR", u8Position);
+        u8SynthLoadPendingParts |= (uint8_t)(1U << u8Part);
+        pu8SynthLoadPendingPartSlot[u8Part] = u8Position;
     }
 
     return bRetVal;
 }
 
-static bool bInitPreset(void)
+static bool bStartLoadFlash(StorageCmdType_t eCmd, uint8_t u8Position, uint8_t u8Part, uint32_t u32RequestUs)
 {
-    bool bRetval = false;
-    MidiParam_t xMidiTmpParam = { 0U };
-    xFmDevice_t * pxInitPreset = NULL;
+    StorageCmd_t xStorageCmd = { 0U };
 
-    /* Try to get las used preset */
-    xMidiTmpParam = xMidiGetParam( MIDI_PARAM_BANK );
+    xStorageCmd.eCmd = eCmd;
+    xStorageCmd.u8Slot = u8Position;
+    xStorageCmd.u8Channel = SYNTH_PART_PRESET_SRC_CHANNEL;
+    xStorageCmd.u32Ctx = u8Part;
+    xStorageCmd.pvData = (eCmd == STORAGE_CMD_YM_LOAD_CHANNEL) ? (void *)&xSynthLoadBuffer.xPresetData.xChannel[0U] : (void *)&xSynthLoadBuffer;
+    xStorageCmd.pxDoneCb = vSynthStorageDoneCb;
 
-    if ( xMidiTmpParam.uData.u8Bank == (uint8_t)LFS_MIDI_BANK_ROM )
+    u32SynthLoadGen = u32SynthPresetGen;
+    u32SynthLoadStartUs = u32RequestUs;
+    bSynthLoadBusy = bStorageSendCmd(xStorageCmd);
+
+    return bSynthLoadBusy;
+}
+
+static void vStartLoadPending(void)
+{
+    if ( bSynthLoadPendingPreset )
     {
-        xMidiTmpParam = xMidiGetParam( MIDI_PARAM_PROGRAM );
+        bSynthLoadPendingPreset = false;
+        (void)bStartLoadFlash(STORAGE_CMD_YM_LOAD, u8SynthLoadPendingPresetSlot, 0U, u32SynthLoadPendingPresetUs);
+    }
 
-        if ( xMidiTmpParam.uData.u8Program < LFS_MIDI_CFG_MAX_PROG_BANK_FIX )
+    /* Parts pending now were requested after last full preset */
+    for (uint8_t u8Part = 0U; !bSynthLoadBusy && (u8SynthLoadPendingParts != 0U); u8Part++)
+    {
+        if ( (u8SynthLoadPendingParts & (1U << u8Part)) != 0U )
         {
-            pxInitPreset = (xFmDevice_t *)pxSYNTH_APP_DATA_CONST_get( xMidiTmpParam.uData.u8Program );
+            u8SynthLoadPendingParts &= (uint8_t)~(1U << u8Part);
+            /* Part load time is not reported */
+            (void)bStartLoadFlash(STORAGE_CMD_YM_LOAD_CHANNEL, pu8SynthLoadPendingPartSlot[u8Part], u8Part, u32RtosGetTimeUs());
         }
     }
-    else if ( xMidiTmpParam.uData.u8Bank == (uint8_t)LFS_MIDI_BANK_FLASH )
-    {
-        xMidiTmpParam = xMidiGetParam( MIDI_PARAM_PROGRAM );
+}
 
-        if ( xMidiTmpParam.uData.u8Program < LFS_MIDI_CFG_MAX_PROG_BANK_FLASH )
-        {
-            lfs_ym_data_t xYmData = { 0U };
+static bool bLoadPresetRom(uint8_t u8Position)
+{
+    bool bRetVal = false;
+    xFmDevice_t * pxPresetData = (xFmDevice_t *)pxSYNTH_APP_DATA_CONST_get(u8Position);
 
-            (void)LFS_read_ym_data(xMidiTmpParam.uData.u8Program, &xYmData);
+    if (pxPresetData != NULL)
+    {
+        vYM2612_set_reg_preset(pxPresetData);
 
-            pxInitPreset = &xYmData.xPresetData;
-        }
+        /* Applied now, any flash load requested before is stale */
+        u32SynthPresetGen++;
+        bSynthLoadPendingPreset = false;
+        u8SynthLoadPendingParts = 0U;
+
+        vCliPrintf(SYNTH_TASK_NAME, "LOAD DEFAULT PRESET %d", u8Position);
+        bRetVal = true;
     }
     else
     {
-        // Get default preset
-        pxInitPreset = (xFmDevice_t *)pxSYNTH_APP_DATA_CONST_get( LFS_MIDI_CFG_DEFAULT_PROG );
+        vCliPrintf(SYNTH_TASK_NAME, "LOAD DEFAULT PRESET %d: ERROR", u8Position);
     }
 
+    return bRetVal;
+}
+
+static bool bInitPreset(void)
+{
+    bool bRetval = false;
+
+    /* Last used preset is restored later by midi task, once storage has read its config */
+    xFmDevice_t * pxInitPreset = (xFmDevice_t *)pxSYNTH_APP_DATA_CONST_get( LFS_MIDI_CFG_DEFAULT_PROG );
+
     if (pxInitPreset != NULL)
     {
         vCliPrintf(SYNTH_TASK_NAME, "Load initial preset: OK");
@@ -970,6 +1389,186 @@ static void vCmdVoiceOffAll(void)
     xSynthDevHandler.xCtrlPoly.xVoiceTmp.u8Velocity = MIDI_DATA_NOT_VALID;
 }
 
+static void vHandleCmdVoicePitch(SynthCmdPayloadVoicePitch_t * pxCmdData)
+{
+    ERR_ASSERT(pxCmdData);
+
+    uint8_t u8Voice = pxCmdData->u8VoiceDst;
+
+    /* Idle voices get the pitch on next note on */
+    if ( (u8Voice < SYNTH_MAX_NUM_VOICE) && (xSynthDevHandler.xVoice[u8Voice].u8Note != MIDI_DATA_NOT_VALID) )
+    {
+        if ( bYM2612_set_note_fine(u8Voice, pxCmdData->u8Note, pxCmdData->u8Cents) )
+        {
+            /* Note off has to match the new note */
+            xSynthDevHandler.xVoice[u8Voice].u8Note = pxCmdData->u8Note;
+        }
+    }
+}
+
+static void vHandleCmdFmParamSet(SynthCmdPayloadFmParamSet_t * pxCmdData)
+{
+    ERR_ASSERT(pxCmdData);
+
+    uint8_t u8VoiceFirst = pxCmdData->u8Voice;
+    uint8_t u8VoiceLast = pxCmdData->u8Voice;
+    uint8_t u8OpFirst = pxCmdData->u8Operator;
+    uint8_t u8OpLast = pxCmdData->u8Operator;
+
+    if ( pxCmdData->u8Voice >= SYNTH_FM_VOICE_ALL )
+    {
+        u8VoiceFirst = 0U;
+        u8VoiceLast = SYNTH_MAX_NUM_VOICE - 1U;
+    }
+
+    if ( pxCmdData->u8Operator >= SYNTH_FM_OPERATOR_ALL )
+    {
+        u8OpFirst = 0U;
+        u8OpLast = YM2612_NUM_OP_CHANNEL - 1U;
+    }
+
+    /* Targeted update, only registers holding the parameter are written */
+    for (uint8_t u8Voice = u8VoiceFirst; u8Voice <= u8VoiceLast; u8Voice++)
+    {
+        for (uint8_t u8Op = u8OpFirst; u8Op <= u8OpLast; u8Op++)
+        {
+            (void)bYM2612_set_param((eFmParameter_t)pxCmdData->u8Param, (YM2612_ch_id_t)u8Voice, (YM2612_op_id_t)u8Op, pxCmdData->u8Value);
+        }
+    }
+}
+
+static void vHandleCmdFmCopy(SynthCmdPayloadFmCopy_t * pxCmdData)
+{
+    ERR_ASSERT(pxCmdData);
+
+    xFmDevice_t * pxDevCfg = pxYM2612_get_reg_preset();
+
+    /* Copy first operator over the rest of the voice */
+    if ( pxCmdData->u8Operator >= SYNTH_FM_OPERATOR_ALL )
+    {
+        uint8_t u8Voice = (pxCmdData->u8Voice >= SYNTH_FM_VOICE_ALL) ? 0U : pxCmdData->u8Voice;
+
+        for (uint32_t u32Index = 1U; u32Index < YM2612_NUM_OP_CHANNEL; u32Index++)
+        {
+            pxDevCfg->xChannel[u8Voice].xOperator[u32Index] = pxDevCfg->xChannel[u8Voice].xOperator[0U];
+        }
+    }
+
+    /* Copy first voice over the rest */
+    if ( pxCmdData->u8Voice >= SYNTH_FM_VOICE_ALL )
+    {
+        for (uint32_t u32Index = 1U; u32Index < YM2612_NUM_CHANNEL; u32Index++)
+        {
+            pxDevCfg->xChannel[u32Index] = pxDevCfg->xChannel[0U];
+        }
+    }
+
+    /* Apply changes to register */
+    vYM2612_set_reg_preset(pxDevCfg);
+}
+
+static void vHandleCmdRegWrite(SynthCmdPayloadRegWrite_t * pxCmdData)
+{
+    ERR_ASSERT(pxCmdData);
+
+    YM2612_bank_t xBank = (pxCmdData->u8Bank == YM2612_BANK_0) ? YM2612_BANK_0 : YM2612_BANK_1;
+
+    vYM2612_write_reg(pxCmdData->u8Addr, pxCmdData->u8Data, xBank);
+}
+
+static void vHandleCmdBench(SynthCmdPayloadBench_t * pxCmdData)
+{
+    ERR_ASSERT(pxCmdData);
+    ERR_ASSERT(pxCmdData->pxBench);
+
+    SynthBench_t * pxBench = pxCmdData->pxBench;
+    const uint8_t pu8TlOffset[YM2612_NUM_OP] = { 0U };
+    xFmDevice_t xPreset = *pxYM2612_get_reg_preset();
+    uint8_t u8RegData = 0U;
+    uint32_t u32StartCycles = 0U;
+
+    /* Same value written back, chip and register mirror do not change */
+    (void)bYM2612_get_reg((uint8_t)YM2612_ADDR_LR_AMS_PMS, YM2612_BANK_0, &u8RegData);
+
+    u32StartCycles = u32RtosGetCycles();
+    vYM2612_write_reg((uint8_t)YM2612_ADDR_LR_AMS_PMS, u8RegData, YM2612_BANK_0);
+    vRtosBenchAdd(&pxBench->xReg, u32RtosGetCycles() - u32StartCycles);
+
+    u32StartCycles = u32RtosGetCycles();
+    vYM2612_set_reg_preset(&xPreset);
+    vRtosBenchAdd(&pxBench->xPreset, u32RtosGetCycles() - u32StartCycles);
+
+    u32StartCycles = u32RtosGetCycles();
+    (void)bYM2612_note_on(YM2612_CH_1, SYNTH_BENCH_NOTE, pu8TlOffset);
+    vRtosBenchAdd(&pxBench->xNote, u32RtosGetCycles() - u32StartCycles);
+
+    /* Release bench note and restore channel as it was before */
+    vLoadPartChannel((uint8_t)YM2612_CH_1, &xPreset.xChannel[YM2612_CH_1]);
+
+    if ( pxBench->pxDoneCb != NULL )
+    {
+        pxBench->pxDoneCb(pxBench);
+    }
+}
+
+static void vPublishFmState(void)
+{
+    /* Single writer, readers detect an update in progress by odd or changed version */
+    u32SynthFmVersion++;
+    portMEMORY_BARRIER();
+    xSynthFmSnapshot = *pxYM2612_get_reg_preset();
+    portMEMORY_BARRIER();
+    u32SynthFmVersion++;
+
+    (void)bUiTaskNotify(UI_SIGNAL_SCREEN_REFRESH);
+}
+
+static void vPublishVoiceState(void)
+{
+    bool bChanged = false;
+
+    for (uint8_t u8Voice = 0U; u8Voice < SYNTH_MAX_NUM_VOICE; u8Voice++)
+    {
+        if ( pu8SynthShownNote[u8Voice] != xSynthDevHandler.xVoice[u8Voice].u8Note )
+        {
+            pu8SynthShownNote[u8Voice] = xSynthDevHandler.xVoice[u8Voice].u8Note;
+            bChanged = true;
+        }
+    }
+
+    /* Idle screen shows voice notes, only redrawn on change */
+    if ( bChanged )
+    {
+        (void)bUiTaskNotify(UI_SIGNAL_SCREEN_REFRESH);
+    }
+}
+
+static bool bVoiceNoteOn(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity)
+{
+    uint8_t u8TlOffset[YM2612_NUM_OP_CHANNEL] = { 0U };
+    uint8_t u8Attenuation = 0U;
+
+    if (u8Velocity < SYNTH_VEL_CURVE_SIZE)
+    {
+        if (xSynthDevHandler.u8VelCurve == (uint8_t)SYNTH_VEL_CURVE_LINEAR)
+        {
+            u8Attenuation = u8VelCurveLinear[u8Velocity];
+        }
+        else if (xSynthDevHandler.u8VelCurve == (uint8_t)SYNTH_VEL_CURVE_EXP)
+        {
+            u8Attenuation = u8VelCurveExp[u8Velocity];
+        }
+    }
+
+    /* Scale attenuation with operator sensitivity, only carriers are used by driver */
+    for (uint32_t u32IndexOp = 0U; u32IndexOp < YM2612_NUM_OP_CHANNEL; u32IndexOp++)
+    {
+        u8TlOffset[u32IndexOp] = (u8Attenuation * xSynthDevHandler.u8VelSens[u8Voice][u32IndexOp]) / SYNTH_VEL_SENS_MAX;
+    }
+
+    return bYM2612_note_on(u8Voice, u8Note, u8TlOffset);
+}
+
 static void vHandleVoiceMonoOn(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Velocity)
 {
     /* Check if voice is in use */
@@ -978,16 +1577,14 @@ static void vHandleVoiceMonoOn(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Veloci
         /* Build synth NOTE ON command */
         if ( u8Voice < SYNTH_MAX_NUM_VOICE )
         {
-            if ( bYM2612_set_note(u8Voice, u8Note) )
+            if ( bVoiceNoteOn(u8Voice, u8Note, u8Velocity) )
             {
-                vYM2612_key_on(u8Voice);
-
                 /* Update control structure */
                 xSynthDevHandler.xVoice[u8Voice].u8Note = u8Note;
                 xSynthDevHandler.xVoice[u8Voice].u8Velocity = u8Velocity;
 
 #ifdef SYNTH_DBG_VERBOSE
-                vCliPrintf(SYNTH_TASK_NAME, "Key  ON : %02d - %03d", u8Voice, u8Note);
+                CLI_LOG(SYNTH_TASK_NAME, "Key  ON : %02d - %03d", u8Voice, u8Note);
 #endif
             }
         }
@@ -1013,7 +1610,7 @@ static void vHandleVoiceMonoOff(uint8_t u8Voice, uint8_t u8Note, uint8_t u8Veloc
         vYM2612_key_off(u8Voice);
 
 #ifdef SYNTH_DBG_VERBOSE
-        vCliPrintf(SYNTH_TASK_NAME, "Key  OFF: %02d - %03d", u8Voice, u8Note);
+        CLI_LOG(SYNTH_TASK_NAME, "Key  OFF: %02d - %03d", u8Voice, u8Note);
 #endif
 
         /* Update control structure */
@@ -1069,16 +1666,14 @@ static void vHandleVoicePolyOn(uint8_t u8Note, uint8_t u8Velocity)
     /* Same note not found and free voice found */
     if ( (u8Voice != MIDI_DATA_NOT_VALID) && (u8Voice < SYNTH_MAX_NUM_VOICE) )
     {
-        if ( bYM2612_set_note(u8Voice, u8Note) )
+        if ( bVoiceNoteOn(u8Voice, u8Note, u8Velocity) )
         {
-            vYM2612_key_on(u8Voice);
-
             /* Update control structure */
             xSynthDevHandler.xVoice[u8Voice].u8Note = u8Note;
             xSynthDevHandler.xVoice[u8Voice].u8Velocity = u8Velocity;
 
 #ifdef SYNTH_DBG_VERBOSE
-            vCliPrintf(SYNTH_TASK_NAME, "Key  ON : %02d - %03d", u8Voice, u8Note);
+            CLI_LOG(SYNTH_TASK_NAME, "Key  ON : %02d - %03d", u8Voice, u8Note);
 #endif
         }
     }
@@ -1103,7 +1698,7 @@ static void vHandleVoicePolyOff(uint8_t u8Note, uint8_t u8Velocity)
             vYM2612_key_off(u32IndexVoice);
 
 #ifdef SYNTH_DBG_VERBOSE
-            vCliPrintf(SYNTH_TASK_NAME, "Key  OFF: %02d - %03d", u32IndexVoice, u8Note);
+            CLI_LOG(SYNTH_TASK_NAME, "Key  OFF: %02d - %03d", u32IndexVoice, u8Note);
 #endif
 
             xSynthDevHandler.xVoice[u32IndexVoice].u8Note = MIDI_DATA_NOT_VALID;
@@ -1153,14 +1748,13 @@ static void vSynthTaskMain( void *pvParameters )
     /* Clear and init all voices */
     vCmdVoiceOffAll();
 
-    /* Init user preset */
-    if ( !bInitUserPreset() )
-    {
-        vCliPrintf(SYNTH_TASK_NAME, "User preset init ERROR");
-    }
+    /* Default velocity response, full sensitivity on all operators */
+    xSynthDevHandler.u8VelCurve = (uint8_t)SYNTH_VEL_CURVE_LINEAR;
+    memset(xSynthDevHandler.u8VelSens, SYNTH_VEL_SENS_MAX, sizeof(xSynthDevHandler.u8VelSens));
 
     /* Basic register init */
     (void)bInitPreset();
+    vPublishFmState();
 
     for(;;)
     {
@@ -1169,12 +1763,23 @@ static void vSynthTaskMain( void *pvParameters )
         if (xQueueReceive(xSynthEventQueueHandle, &xSynthCmd, portMAX_DELAY) == pdPASS)
         {
 #ifdef SYNTH_DBG_VERBOSE
-            vCliPrintf(SYNTH_TASK_NAME, "Synth CMD: x%02X", xSynthCmd.eCmd);
+            CLI_LOG(SYNTH_TASK_NAME, "Synth CMD: x%02X", xSynthCmd.eCmd);
 #endif
             switch (xSynthCmd.eCmd)
             {
                 case SYNTH_CMD_VOICE_UPDATE_MONO:
                     vHandleCmdVoiceUpdateMono(&xSynthCmd.uPayload.xVoiceUpdateMono);
+
+                    /* Key on from gate input, queue wait included */
+                    if ( (xSynthCmd.uPayload.xVoiceUpdateMono.u32GateStamp != 0U) &&
+                         (xSynthCmd.uPayload.xVoiceUpdateMono.u8VoiceState == (uint8_t)SYNTH_VOICE_STATE_ON) )
+                    {
+                        uint32_t u32Cycles = (u32RtosStatsTimerGet() - xSynthCmd.uPayload.xVoiceUpdateMono.u32GateStamp) * RTOS_STATS_CLOCK_CYCLES;
+
+                        taskENTER_CRITICAL();
+                        vRtosBenchAdd(&xSynthGateBench, u32Cycles);
+                        taskEXIT_CRITICAL();
+                    }
                     break;
 
                 case SYNTH_CMD_VOICE_UPDATE_POLY:
@@ -1183,20 +1788,61 @@ static void vSynthTaskMain( void *pvParameters )
 
                 case SYNTH_CMD_PARAM_UPDATE:
                     vHandleCmdParameterUpdate(&xSynthCmd.uPayload.xParamUpdate);
+                    vPublishFmState();
                     break;
 
                 case SYNTH_CMD_PRESET_UPDATE:
                     vHandleCmdPresetUpdate(&xSynthCmd.uPayload.xPresetUpdate);
+                    vPublishFmState();
                     break;
 
                 case SYNTH_CMD_VOICE_MUTE:
                     vCmdVoiceOffAll();
                     break;
 
+                case SYNTH_CMD_PART_PRESET_UPDATE:
+                    vHandleCmdPartPresetUpdate(&xSynthCmd.uPayload.xPartPresetUpdate);
+                    vPublishFmState();
+                    break;
+
+                case SYNTH_CMD_REG_UPDATE:
+                    vHandleCmdRegUpdate(&xSynthCmd.uPayload.xRegUpdate);
+                    vPublishFmState();
+                    break;
+
+                case SYNTH_CMD_STORAGE_DONE:
+                    vHandleCmdStorageDone(&xSynthCmd.uPayload.xStorageDone);
+                    vPublishFmState();
+                    break;
+
+                case SYNTH_CMD_VOICE_PITCH:
+                    vHandleCmdVoicePitch(&xSynthCmd.uPayload.xVoicePitch);
+                    break;
+
+                case SYNTH_CMD_FM_PARAM_SET:
+                    vHandleCmdFmParamSet(&xSynthCmd.uPayload.xFmParamSet);
+                    vPublishFmState();
+                    break;
+
+                case SYNTH_CMD_FM_COPY:
+                    vHandleCmdFmCopy(&xSynthCmd.uPayload.xFmCopy);
+                    vPublishFmState();
+                    break;
+
+                case SYNTH_CMD_REG_WRITE:
+                    vHandleCmdRegWrite(&xSynthCmd.uPayload.xRegWrite);
+                    break;
+
+                case SYNTH_CMD_BENCH:
+                    vHandleCmdBench(&xSynthCmd.uPayload.xBench);
+                    break;
+
                 default:
                     vCliPrintf(SYNTH_TASK_NAME, "Not defined command: x%02X", xSynthCmd.eCmd);
                     break;
             }
+
+            vPublishVoiceState();
         }
     }
 }
@@ -1206,11 +1852,11 @@ static void vSynthTaskMain( void *pvParameters )
 void vSynthTaskInit(void)
 {
     /* Create task */
-    xTaskCreate(vSynthTaskMain, SYNTH_TASK_NAME, SYNTH_TASK_STACK, NULL, SYNTH_TASK_PRIO, &xSynthTaskHandle);
+    xSynthTaskHandle = xTaskCreateStatic(vSynthTaskMain, SYNTH_TASK_NAME, SYNTH_TASK_STACK, NULL, SYNTH_TASK_PRIO, pxSynthTaskStack, &xSynthTaskTcb);
     ERR_ASSERT(xSynthTaskHandle);
 
     /* Create task queue */
-    xSynthEventQueueHandle = xQueueCreate(SYNTH_EVENT_QUEUE_SIZE, SYNTH_EVENT_QUEUE_ELEMENT_SIZE);
+    xSynthEventQueueHandle = xQueueCreateStatic(SYNTH_EVENT_QUEUE_SIZE, SYNTH_EVENT_QUEUE_ELEMENT_SIZE, pu8SynthEventQueueStorage, &xSynthEventQueueCtrl);
     ERR_ASSERT(xSynthEventQueueHandle);
 }
 
@@ -1233,6 +1879,26 @@ bool bSynthSendCmd(SynthCmd_t xSynthCmd)
     return bRetval;
 }
 
+bool bSynthSendCmdFromISR(SynthCmd_t xSynthCmd)
+{
+    bool bRetval = false;
+
+    if ( xSynthEventQueueHandle != NULL )
+    {
+        BaseType_t xWakeTask = pdFALSE;
+
+        /* No log on error, cli print is not allowed from interrupts */
+        if ( xQueueSendFromISR(xSynthEventQueueHandle, &xSynthCmd, &xWakeTask) == pdPASS )
+        {
+            bRetval = true;
+        }
+
+        portYIELD_FROM_ISR(xWakeTask);
+    }
+
+    return bRetval;
+}
+
 SynthParam_t xSynthGetParam(uint8_t u8ParamId)
 {
     SynthParam_t xRetParam = { .u8ParamId = SYNTH_PARAM_NOT_DEF, .u32ParamValue = 0U };
@@ -1246,4 +1912,60 @@ SynthParam_t xSynthGetParam(uint8_t u8ParamId)
     return xRetParam;
 }
 
+bool bSynthGetFmSnapshot(xFmDevice_t * pxDevice, uint32_t * pu32Version)
+{
+    bool bRetval = false;
+
+    if ( pxDevice != NULL )
+    {
+        for (uint32_t u32Retry = 0U; (u32Retry < SYNTH_SNAPSHOT_RETRY) && !bRetval; u32Retry++)
+        {
+            uint32_t u32Version = u32SynthFmVersion;
+
+            if ( (u32Version & 1U) == 0U )
+            {
+                portMEMORY_BARRIER();
+                *pxDevice = xSynthFmSnapshot;
+                portMEMORY_BARRIER();
+
+                if ( u32Version == u32SynthFmVersion )
+                {
+                    if ( pu32Version != NULL )
+                    {
+                        *pu32Version = u32Version;
+                    }
+
+                    bRetval = true;
+                }
+            }
+
+            /* Let synth task finish publishing */
+            if ( !bRetval )
+            {
+                taskYIELD();
+            }
+        }
+    }
+
+    return bRetval;
+}
+
+uint32_t u32SynthGetFmVersion(void)
+{
+    return u32SynthFmVersion;
+}
+
+void vSynthGetGateBench(rtos_bench_t * pxBench, bool bReset)
+{
+    ERR_ASSERT(pxBench != NULL);
+
+    taskENTER_CRITICAL();
+    *pxBench = xSynthGateBench;
+    if ( bReset )
+    {
+        vRtosBenchReset(&xSynthGateBench);
+    }
+    taskEXIT_CRITICAL();
+}
+
 /* EOF */
\ No newline at end of file
@@ -31,6 +31,15 @@
 #define UI_DISPLAY_INIT_DELAY_MS            ( pdMS_TO_TICKS(500U) )
 #define UI_DISPLAY_FIRST_MSG_DELAY_MS       ( pdMS_TO_TICKS(2000U) )
 
+/* Encoder acceleration, ms between detents and step multiplier */
+#define UI_ENC_ACCEL_SLOW_MS                ( 60U )
+#define UI_ENC_ACCEL_MID_MS                 ( 30U )
+#define UI_ENC_ACCEL_FAST_MS                ( 15U )
+#define UI_ENC_ACCEL_SLOW_MULT              ( 1U )
+#define UI_ENC_ACCEL_MID_MULT               ( 2U )
+#define UI_ENC_ACCEL_FAST_MULT              ( 4U )
+#define UI_ENC_ACCEL_MAX_MULT               ( 8U )
+
 /* Private macro -------------------------------------------------------------*/
 
 /* Display initial msg  */
@@ -46,18 +55,25 @@
 
 /* Task handler */
 TaskHandle_t ui_task_handle = NULL;
+static StaticTask_t xUiTaskTcb;
+static StackType_t pxUiTaskStack[UI_TASK_STACK];
 
 /* Timer to handle screen refresh */
 TimerHandle_t xUpdateTimer = NULL;
+static StaticTimer_t xUpdateTimerCtrl;
 
 /* Timer to handle idle event */
 TimerHandle_t xIdleTimer = NULL;
+static StaticTimer_t xIdleTimerCtrl;
 
 /* Timer to handle CC idle message */
 TimerHandle_t xCcCmdTimer = NULL;
+static StaticTimer_t xCcCmdTimerCtrl;
 
 /* Queue event handler */
 QueueHandle_t xUiCmdQueueHandle = NULL;
+static StaticQueue_t xUiCmdQueueCtrl;
+static uint8_t pu8UiCmdQueueStorage[UI_CMD_QUEUE_SIZE * UI_CMD_QUEUE_ELEMENT_SIZE];
 
 /* Pointer to display lib handler */
 static u8g2_t xDisplayHandler = {0};
@@ -68,6 +84,9 @@ static ui_menu_t xUiMenuHandler = {0};
 /* Return screen from idle */
 static uint32_t u32ReturnScreen = MENU_LAST_SCREEN_POSITION;
 
+/* Cycles of full renders requested by bench */
+static rtos_bench_t xUiRenderBench = { UINT32_MAX, 0U, 0U, 0U };
+
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -112,6 +131,13 @@ static void vScreenInitMsg( u8g2_t * pxDisplayHandler);
   */
 static void __ui_main(void *pvParameters);
 
+/**
+  * @brief Consume encoder delta and translate it to accelerated steps.
+  * @param pu32Event pending events, encoder bits updated with net direction.
+  * @retval Number of steps to apply, 0 if movement already consumed.
+  */
+static uint32_t u32EncoderSteps(uint32_t * pu32Event);
+
 /* Private fuctions ----------------------------------------------------------*/
 
 static void encoder_cb(encoder_event_t event, uint32_t eventData)
@@ -150,6 +176,45 @@ static void encoder_cb(encoder_event_t event, uint32_t eventData)
     }
 }
 
+static uint32_t u32EncoderSteps(uint32_t * pu32Event)
+{
+    int32_t i32Delta = 0;
+    uint32_t u32StepPeriod = UINT32_MAX;
+    uint32_t u32Steps = 0U;
+
+    (void)ENCODER_getDelta(ENCODER_ID_0, &i32Delta, &u32StepPeriod);
+
+    /* Several detents between wakeups are merged on a single event */
+    *pu32Event &= ~(UI_SIGNAL_ENC_UPDATE_CW | UI_SIGNAL_ENC_UPDATE_CCW);
+
+    if (i32Delta != 0)
+    {
+        uint32_t u32Mult = UI_ENC_ACCEL_MAX_MULT;
+
+        if (u32StepPeriod > UI_ENC_ACCEL_SLOW_MS)
+        {
+            u32Mult = UI_ENC_ACCEL_SLOW_MULT;
+        }
+        else if (u32StepPeriod > UI_ENC_ACCEL_MID_MS)
+        {
+            u32Mult = UI_ENC_ACCEL_MID_MULT;
+        }
+        else if (u32StepPeriod > UI_ENC_ACCEL_FAST_MS)
+        {
+            u32Mult = UI_ENC_ACCEL_FAST_MULT;
+        }
+
+        *pu32Event |= (i32Delta > 0) ? UI_SIGNAL_ENC_UPDATE_CW : UI_SIGNAL_ENC_UPDATE_CCW;
+        u32Steps = (uint32_t)((i32Delta > 0) ? i32Delta : -i32Delta) * u32Mult;
+    }
+
+#ifdef UI_DBG_VERBOSE
+    vCliPrintf(UI_TASK_NAME, "Encoder: delta %d, period %d ms, steps %d", i32Delta, u32StepPeriod, u32Steps);
+#endif
+
+    return u32Steps;
+}
+
 static void vScreenUpdateCallback(TimerHandle_t xTimer)
 {
     xTaskNotify(ui_task_handle, UI_SIGNAL_SCREEN_UPDATE, eSetBits);
@@ -243,6 +308,7 @@ static void __ui_main( void *pvParameters )
                         case UI_CMD_CC_UPDATE:
                             /* Notify change of CC var in system */
                             vUI_screen_idle_set_cc_data(xUiCmd.uPayload.xCcUpdate.u8CcId, xUiCmd.uPayload.xCcUpdate.u8Data);
+                            UI_set_dirty(&xUiMenuHandler);
                             bUiTaskNotify(UI_SIGNAL_MIDI_CC);
                             break;
 
@@ -255,6 +321,11 @@ static void __ui_main( void *pvParameters )
 
             /* --- Events to feed to ui screens --- */
 
+            if ( RTOS_CHECK_SIGNAL(u32TmpEvent, UI_SIGNAL_ENC_UPDATE_CW) || RTOS_CHECK_SIGNAL(u32TmpEvent, UI_SIGNAL_ENC_UPDATE_CCW) )
+            {
+                xUiMenuHandler.u32EncoderSteps = u32EncoderSteps(&u32TmpEvent);
+            }
+
             if (u32TmpEvent & ( UI_SIGNAL_ENC_UPDATE_CW | 
                                 UI_SIGNAL_ENC_UPDATE_CCW | 
                                 UI_SIGNAL_ENC_UPDATE_SW_SET | 
@@ -309,10 +380,38 @@ static void __ui_main( void *pvParameters )
                 }
             }
 
-            /* Periodic render signal */
+            /* Data shown on screen changed outside ui */
+            if (RTOS_CHECK_SIGNAL(u32TmpEvent, UI_SIGNAL_SCREEN_REFRESH))
+            {
+                UI_set_dirty(&xUiMenuHandler);
+            }
+
+            /* Periodic render signal, only dirty tiles are sent */
             if (RTOS_CHECK_SIGNAL(u32TmpEvent, UI_SIGNAL_SCREEN_UPDATE))
             {
+#ifdef UI_DBG_VERBOSE
+                uint32_t u32RenderStartUs = u32RtosGetTimeUs();
+                UI_render(&xDisplayHandler, &xUiMenuHandler);
+                vCliPrintf(UI_TASK_NAME, "Render: %d us", u32RtosGetTimeUs() - u32RenderStartUs);
+#else
+                UI_render(&xDisplayHandler, &xUiMenuHandler);
+#endif
+            }
+
+            /* Full render requested by bench, only changed tiles are sent, so on a static
+               screen it measures drawing and tile compare, frame push is kept by ui_sys */
+            if (RTOS_CHECK_SIGNAL(u32TmpEvent, UI_SIGNAL_BENCH))
+            {
+                uint32_t u32StartCycles = u32RtosGetCycles();
+
+                UI_set_dirty(&xUiMenuHandler);
                 UI_render(&xDisplayHandler, &xUiMenuHandler);
+
+                u32StartCycles = u32RtosGetCycles() - u32StartCycles;
+
+                taskENTER_CRITICAL();
+                vRtosBenchAdd(&xUiRenderBench, u32StartCycles);
+                taskEXIT_CRITICAL();
             }
         }
     }
@@ -323,33 +422,36 @@ static void __ui_main( void *pvParameters )
 void vUiTaskInit(void)
 {
     /* Create task */
-    xTaskCreate(__ui_main, UI_TASK_NAME, UI_TASK_STACK, NULL, UI_TASK_PRIO, &ui_task_handle);
+    ui_task_handle = xTaskCreateStatic(__ui_main, UI_TASK_NAME, UI_TASK_STACK, NULL, UI_TASK_PRIO, pxUiTaskStack, &xUiTaskTcb);
     ERR_ASSERT(ui_task_handle);
 
     /* Create timer resources */
-    xUpdateTimer = xTimerCreate("ScreenUpdateTimer",
+    xUpdateTimer = xTimerCreateStatic("ScreenUpdateTimer",
                                 UI_DISPLAY_UPDATE_RATE_MS,
                                 pdTRUE,
                                 (void *)0U,
-                                vScreenUpdateCallback);
+                                vScreenUpdateCallback,
+                                &xUpdateTimerCtrl);
     ERR_ASSERT(xUpdateTimer);
 
-    xIdleTimer = xTimerCreate("ScreenIdleTimer", 
+    xIdleTimer = xTimerCreateStatic("ScreenIdleTimer",
                                 UI_DISPLAY_IDLE_MS,
                                 pdFALSE,
                                 (void *)0U,
-                                vScreenIdleCallback);
+                                vScreenIdleCallback,
+                                &xIdleTimerCtrl);
     ERR_ASSERT(xIdleTimer);
 
-    xCcCmdTimer = xTimerCreate("ScreenCcRestoreTimer", 
+    xCcCmdTimer = xTimerCreateStatic("ScreenCcRestoreTimer",
                                 UI_DISPLAY_CC_RESTORE_MS,
                                 pdFALSE,
                                 (void *)0U,
-                                vScreenCcCmdTimeoutCallback);
+                                vScreenCcCmdTimeoutCallback,
+                                &xCcCmdTimerCtrl);
     ERR_ASSERT(xCcCmdTimer);
 
     /* Create queue */
-    xUiCmdQueueHandle = xQueueCreate(UI_CMD_QUEUE_SIZE, UI_CMD_QUEUE_ELEMENT_SIZE);
+    xUiCmdQueueHandle = xQueueCreateStatic(UI_CMD_QUEUE_SIZE, UI_CMD_QUEUE_ELEMENT_SIZE, pu8UiCmdQueueStorage, &xUiCmdQueueCtrl);
     ERR_ASSERT(xUiCmdQueueHandle);
 }
 
@@ -367,6 +469,19 @@ bool bUiTaskNotify(uint32_t u32Event)
     return bRetval;
 }
 
+void vUiGetRenderBench(rtos_bench_t * pxBench, bool bReset)
+{
+    ERR_ASSERT(pxBench != NULL);
+
+    taskENTER_CRITICAL();
+    *pxBench = xUiRenderBench;
+    if (bReset)
+    {
+        vRtosBenchReset(&xUiRenderBench);
+    }
+    taskEXIT_CRITICAL();
+}
+
 bool bUiSendCmd(UiCmd_t xUiTaskCmd)
 {
     bool bRetval = false;
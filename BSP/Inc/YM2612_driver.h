@@ -33,6 +33,14 @@ extern "C"
 /** Number of total parameters */
 #define YM2612_NUM_PARAMETERS   (FM_VAR_SIZE_NUMBER)
 
+/** Number of register banks */
+#define YM2612_NUM_BANK         (2U)
+
+/** Register range kept on write mirror, same range on both banks */
+#define YM2612_REG_FIRST        (0x21U)
+#define YM2612_REG_LAST         (0xB6U)
+#define YM2612_REG_NUM          (YM2612_REG_LAST - YM2612_REG_FIRST + 1U)
+
 /* Bit position in shift reg */
 #define YM_POS_Dx               (0U)
 #define YM_POS_REG              (8U)
@@ -214,11 +222,64 @@ void vYM2612_write_reg(uint8_t u8RegAddr, uint8_t u8RegData, YM2612_bank_t xBank
 void vYM2612_set_reg_preset(xFmDevice_t * pxRegPreset);
 
 /**
-  * @brief Get reg preset.
+  * @brief Set reg preset of a single channel, other channels are not modified.
+  * @param xChannel synth channel to update.
+  * @param pxRegChannel pointer with channel reg preset to set.
+  * @retval None
+  */
+void vYM2612_set_reg_channel(YM2612_ch_id_t xChannel, xFmChannel_t * pxRegChannel);
+
+/**
+  * @brief Get reg preset, only the task driving the chip may modify it.
   * @retval address of actual reg preset.
   */
 xFmDevice_t * pxYM2612_get_reg_preset(void);
 
+/**
+  * @brief Get register mirror, last value written on each register since init.
+  * @retval address of mirror, YM2612_NUM_BANK blocks of YM2612_REG_NUM registers from YM2612_REG_FIRST.
+  */
+const uint8_t * pu8YM2612_get_reg_mirror(void);
+
+/**
+  * @brief Get last value written on a register.
+  * @param u8RegAddr register address.
+  * @param xBank register bank.
+  * @param pu8RegData pointer where store register value.
+  * @retval True if register is on mirror range, False ioc.
+  */
+bool bYM2612_get_reg(uint8_t u8RegAddr, YM2612_bank_t xBank, uint8_t * pu8RegData);
+
+/**
+  * @brief Get value a reg preset sets on a register.
+  * @param pxDevice preset to encode.
+  * @param u8RegAddr register address.
+  * @param xBank register bank.
+  * @param pu8RegData pointer where store register value.
+  * @retval True if register is set by presets, False ioc.
+  */
+bool bYM2612_get_preset_reg(const xFmDevice_t * pxDevice, uint8_t u8RegAddr, YM2612_bank_t xBank, uint8_t * pu8RegData);
+
+/**
+  * @brief Get a single parameter from a reg preset.
+  * @param pxDevice preset to read, NULL for actual reg preset.
+  * @param eParam parameter to get.
+  * @param xChannel synth channel, not used on LFO parameters.
+  * @param xOperator channel operator, only used on operator parameters.
+  * @retval Parameter value, 0 if not valid.
+  */
+uint8_t u8YM2612_get_param(xFmDevice_t * pxDevice, eFmParameter_t eParam, YM2612_ch_id_t xChannel, YM2612_op_id_t xOperator);
+
+/**
+  * @brief Set a single parameter, only the register holding it is written.
+  * @param eParam parameter to set.
+  * @param xChannel synth channel, not used on LFO parameters.
+  * @param xOperator channel operator, only used on operator parameters.
+  * @param u8Value new parameter value.
+  * @retval True if parameter has been applied, false ioc.
+  */
+bool bYM2612_set_param(eFmParameter_t eParam, YM2612_ch_id_t xChannel, YM2612_op_id_t xOperator, uint8_t u8Value);
+
 /**
   * @brief Set midi note into channel
   * @param xChannel synth channel
@@ -227,6 +288,32 @@ xFmDevice_t * pxYM2612_get_reg_preset(void);
   */
 bool bYM2612_set_note(YM2612_ch_id_t xChannel, uint8_t u8MidiNote);
 
+/**
+  * @brief Set midi note with fine pitch into channel, no key on
+  * @param xChannel synth channel
+  * @param u8MidiNote Midi note to set on channel
+  * @param u8Cents cents over the note, 0-99
+  * @retval True if freq has been applied, false ioc.
+  */
+bool bYM2612_set_note_fine(YM2612_ch_id_t xChannel, uint8_t u8MidiNote, uint8_t u8Cents);
+
+/**
+  * @brief Set midi note, carrier levels and key on in a single register sequence.
+  * @param xChannel synth channel
+  * @param u8MidiNote Midi note to set on channel
+  * @param pu8TlOffset attenuation added to each operator TL, only applied on
+  *        carriers of the current algorithm. NULL to keep preset levels.
+  * @retval True if note has been played, false ioc.
+  */
+bool bYM2612_note_on(YM2612_ch_id_t xChannel, uint8_t u8MidiNote, const uint8_t * pu8TlOffset);
+
+/**
+  * @brief Get carrier operators of an algorithm.
+  * @param u8Algorithm algorithm number (0-7).
+  * @retval Mask with bit N set if xOperator[N] is a carrier.
+  */
+uint8_t u8YM2612_get_carrier_mask(uint8_t u8Algorithm);
+
 /**
   * @brief Set key on on specified channel
   * @param xChannel synth channel
@@ -19,6 +19,19 @@ extern "C"
 #include "stm32g0xx_hal.h"
 
 /* Private defines -----------------------------------------------------------*/
+
+/* Full sequence scans stored on DMA buffer, half of them processed on each DMA callback */
+#define ADC_DMA_SCAN_NUM                ( 2U )
+
+/* Fractional bits kept on filtered values */
+#define ADC_FILTER_FRAC_BITS            ( 4U )
+
+/* IIR filter coefficient as shift, y += (x - y) / 2^N */
+#define ADC_FILTER_IIR_SHIFT            ( 2U )
+
+/* Default change in counts that reports a channel update */
+#define ADC_THRESHOLD_DEFAULT           ( 8U )
+
 /* Exported types ------------------------------------------------------------*/
 
 /* List of devices*/
@@ -51,11 +64,13 @@ typedef enum
 typedef enum
 {
     ADC_EVENT_UPDATE = 0U,
+    ADC_EVENT_GATE_ON,
+    ADC_EVENT_GATE_OFF,
     ADC_EVENT_NOTDEF = 0xFFU,
 } adc_event_t;
 
-/* Driver event callback */
-typedef void (* adc_event_cb)(adc_event_t event);
+/* Driver event callback, mask with one bit per channel updated, called from ISR */
+typedef void (* adc_event_cb)(adc_event_t event, uint32_t u32ChMask);
 
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
@@ -91,7 +106,7 @@ adc_status_t ADC_start(adc_port_t dev);
 adc_status_t ADC_stop(adc_port_t dev);
 
 /**
-  * @brief  Init ADC interface.
+  * @brief  Get filtered ADC value.
   * @param  dev interface number to init.
   * @param  xChId adc channel to check.
   * @param  pu16AdcData pointer where store ADC read.
@@ -99,6 +114,47 @@ adc_status_t ADC_stop(adc_port_t dev);
 */
 adc_status_t ADC_get_value(adc_port_t dev, adc_ch_id_t xChId, uint16_t * pu16AdcData);
 
+/**
+  * @brief  Get last unfiltered ADC value.
+  * @note   Called from event callback it is the sample of the same sequence
+  *         that raised the event.
+  * @param  dev interface number to init.
+  * @param  xChId adc channel to check.
+  * @param  pu16AdcData pointer where store ADC read.
+  * @retval Operation status.
+*/
+adc_status_t ADC_get_raw_value(adc_port_t dev, adc_ch_id_t xChId, uint16_t * pu16AdcData);
+
+/**
+  * @brief  Set minimal change to report a channel update.
+  * @param  dev interface number.
+  * @param  xChId adc channel to configure.
+  * @param  u16Threshold change in ADC counts, 0 reports every scan.
+  * @retval Operation status.
+*/
+adc_status_t ADC_set_threshold(adc_port_t dev, adc_ch_id_t xChId, uint16_t u16Threshold);
+
+/**
+  * @brief  Handle a channel as gate input, edges reported with ADC_EVENT_GATE_ON/OFF.
+  * @note   Gate is active below u16OnLevel and released above u16OffLevel,
+  *         compared on each unfiltered sequence. Gate channels are not
+  *         reported with ADC_EVENT_UPDATE.
+  * @param  dev interface number.
+  * @param  xChId adc channel to configure.
+  * @param  u16OnLevel level in counts to activate gate.
+  * @param  u16OffLevel level in counts to release gate, higher than u16OnLevel.
+  * @retval Operation status.
+*/
+adc_status_t ADC_gate_enable(adc_port_t dev, adc_ch_id_t xChId, uint16_t u16OnLevel, uint16_t u16OffLevel);
+
+/**
+  * @brief  Stop gate detection on a channel.
+  * @param  dev interface number.
+  * @param  xChId adc channel to configure.
+  * @retval Operation status.
+*/
+adc_status_t ADC_gate_disable(adc_port_t dev, adc_ch_id_t xChId);
+
 #ifdef __cplusplus
 }
 #endif
@@ -40,8 +40,10 @@ extern "C"
 #define ENCODER_0_VALUE_CCW           ( 0U )
 #define ENCODER_0_VALUE_NONE          ( 255U )
 
+/* Timer counts per detent, TI12 mode counts every edge of both channels */
+#define ENCODER_0_CNT_PER_STEP        ( 4U )
+
 /* Encoder tick guard */
-#define ENCODER_0_TICK_CNT_GUARD_EC   ( 40U )
 #define ENCODER_0_TICK_CNT_GUARD_SW   ( 500U )
 
 /* Exported types ------------------------------------------------------------*/
@@ -106,6 +108,15 @@ encoder_status_t ENCODER_deinit(encoder_id_t xDevId);
 */
 encoder_status_t ENCODER_getCount(encoder_id_t xDevId, uint32_t * pu32Count);
 
+/**
+  * @brief  Get and clear steps accumulated since last call, safe against encoder irq.
+  * @param  xDevId id of encoder.
+  * @param  pi32Delta Pointer where store net steps, positive is CW.
+  * @param  pu32StepPeriod Pointer where store ms between the last two steps, NULL if not needed.
+  * @retval Operation status
+*/
+encoder_status_t ENCODER_getDelta(encoder_id_t xDevId, int32_t * pi32Delta, uint32_t * pu32StepPeriod);
+
 /**
   * @brief  Get switch state
   * @param  xDevId id of encoder.
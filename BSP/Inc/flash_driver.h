@@ -2,6 +2,9 @@
  * @file    flash_driver.h
  * @author  Sebastian Del Moral Gallardo.
  * @brief   Basic funtionality for use flash write/read.
+ * @note    Erase and program run from RAM, but interrupts stay enabled and
+ *          ISRs still run from flash, any IRQ served meanwhile stalls until
+ *          flash is ready again.
  *
  */
 
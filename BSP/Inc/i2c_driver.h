@@ -80,6 +80,16 @@ i2c_status_t I2C_deinit(i2c_port_t dev);
   */
 i2c_status_t I2C_master_send(i2c_port_t dev, uint16_t i2c_addr, uint8_t *pdata, uint16_t len);
 
+/**
+  * @brief  Send data through defined interface using DMA directly from caller buffer.
+  * @param  dev i2c interface to use.
+  * @param  i2c_addr slave address.
+  * @param  pdata pointer of data to send, must be kept until I2C_EVENT_MASTER_TX_DONE.
+  * @param  len number of bytes to send.
+  * @retval Operation status.
+  */
+i2c_status_t I2C_master_send_dma(i2c_port_t dev, uint16_t i2c_addr, uint8_t *pdata, uint16_t len);
+
 /**
   * @brief  Read data through defined interface.
   * @param  dev i2c interface to use.
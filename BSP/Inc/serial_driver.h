@@ -20,13 +20,15 @@ extern "C"
 
 /* Private defines -----------------------------------------------------------*/
 
-/* Data rx buffer size */
-#define SERIAL_0_CBUF_SIZE  (512U)
-#define SERIAL_0_RX_SIZE    (64U)
+/* Data rx buffer size, ring size must be a power of two */
+#define SERIAL_0_RX_SIZE    (256U)  /* No ring, read in place from DMA buffer (span mode) */
 
 #define SERIAL_1_CBUF_SIZE  (128U)
 #define SERIAL_1_RX_SIZE    (16U)
 
+/* Max number of spans to read a DMA rx buffer, two on wrap */
+#define SERIAL_RX_SPAN_MAX  (2U)
+
 /* Exported types ------------------------------------------------------------*/
 
 /* List of serial devices*/
@@ -59,6 +61,22 @@ typedef enum
 /* Data reception callback */
 typedef void (* serial_event_cb)(serial_event_t event);
 
+/* Serial rx buffer statistics */
+typedef struct
+{
+    uint16_t size;
+    uint16_t high_water;
+    uint32_t drop_count;
+    uint32_t overrun_count;
+} serial_rx_stats_t;
+
+/* Contiguous block of received data, valid until released */
+typedef struct
+{
+    const uint8_t *data;
+    uint16_t len;
+} serial_span_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions prototypes ---------------------------------------------*/
@@ -105,6 +123,32 @@ uint16_t SERIAL_read(serial_port_t dev, uint8_t *pdata, uint16_t max_len);
   */
 uint16_t SERIAL_get_read_count(serial_port_t dev);
 
+/**
+  * @brief  Get received data in place from DMA buffer, only for ports without rx ring
+  * @param  dev serial interface number to use
+  * @param  spans array of SERIAL_RX_SPAN_MAX spans where store pending data
+  * @retval number of valid spans, data must be consumed before DMA wraps over it
+  */
+uint8_t SERIAL_get_rx_spans(serial_port_t dev, serial_span_t *spans);
+
+/**
+  * @brief  Release data read through SERIAL_get_rx_spans
+  * @note   If DMA wrapped over the spans while they were read, all pending
+  *         data is dropped and data read from them must be discarded.
+  * @param  dev serial interface number to use
+  * @param  len number of bytes consumed
+  * @retval SERIAL_STATUS_OK data read was valid, SERIAL_STATUS_ERROR DMA overrun
+  */
+serial_status_t SERIAL_release_rx(serial_port_t dev, uint16_t len);
+
+/**
+  * @brief  Get rx buffer usage statistics
+  * @param  dev serial interface number to use
+  * @param  pstats pointer where store buffer size, high water mark, dropped bytes and overruns
+  * @retval Operation status
+  */
+serial_status_t SERIAL_get_rx_stats(serial_port_t dev, serial_rx_stats_t *pstats);
+
 #ifdef __cplusplus
 }
 #endif
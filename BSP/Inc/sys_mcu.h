@@ -23,6 +23,10 @@ extern "C"
 
 /* Exported defines ---------------------------------------------------------*/
 /* Exported macro -----------------------------------------------------------*/
+
+/* Function copied to RAM at startup, keeps running while flash is erased or programmed.
+   Linker adds a veneer on calls from flash, RAM is out of branch range */
+#define RAM_FUNC    __attribute__((section(".ramfunc"), noinline))
 /* Exported functions prototypes --------------------------------------------*/
 
 /**
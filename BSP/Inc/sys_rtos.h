@@ -28,13 +28,69 @@ extern "C"
 #include "FreeRTOSConfig.h"
 
 /* Exported defines ---------------------------------------------------------*/
+
+/* Run time stats clock frequency */
+#define RTOS_STATS_CLOCK_HZ             ( 100000U )
+
+/* Core cycles per run time stats clock count */
+#define RTOS_STATS_CLOCK_CYCLES         ( configCPU_CLOCK_HZ / RTOS_STATS_CLOCK_HZ )
 /* Exported macro -----------------------------------------------------------*/
 
 /* RTOS check signal */
 #define RTOS_CHECK_SIGNAL(VAR, SIG)     (((VAR) & (SIG)) == (SIG))
 
+/* Exported types -----------------------------------------------------------*/
+
+/** Min, max and sum of cycle measurements */
+typedef struct
+{
+    uint32_t u32Min;
+    uint32_t u32Max;
+    uint32_t u32Sum;
+    uint32_t u32Count;
+} rtos_bench_t;
+
 /* Exported functions prototypes --------------------------------------------*/
 
+/**
+ * @brief Get time since scheduler start with sub tick resolution, task context only.
+ * @return uint32_t time in microseconds, wraps around every ~71 minutes.
+ */
+uint32_t u32RtosGetTimeUs(void);
+
+/**
+ * @brief Get core cycles since scheduler start, SysTick counter extended by tick count.
+ *        Valid with scheduler suspended, tick hook keeps running.
+ * @return uint32_t cycle count, wraps around every 2^32 cycles.
+ */
+uint32_t u32RtosGetCycles(void);
+
+/**
+ * @brief Clear a cycle measurement accumulator.
+ * @param pxBench accumulator to clear.
+ */
+void vRtosBenchReset(rtos_bench_t * pxBench);
+
+/**
+ * @brief Add a cycle measurement to an accumulator.
+ * @param pxBench accumulator to update.
+ * @param u32Cycles measured cycles.
+ */
+void vRtosBenchAdd(rtos_bench_t * pxBench, uint32_t u32Cycles);
+
+/**
+ * @brief Start timer used as run time stats clock, called by scheduler start.
+ */
+void vRtosStatsTimerInit(void);
+
+/**
+ * @brief Get run time stats clock, RTOS_STATS_CLOCK_HZ resolution.
+ *        Hardware counter keeps running while core is stalled, valid if tick hook
+ *        does not run for less than 655 ms.
+ * @return uint32_t counter value, wraps around.
+ */
+uint32_t u32RtosStatsTimerGet(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,6 +7,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "YM2612_driver.h"
 #include "user_error.h"
 
@@ -33,6 +35,12 @@
 /* Max block range */
 #define MAX_BLOCK           (8U)
 
+/* Number of cents per semitone */
+#define NUM_CENTS_NOTE      (100U)
+
+/* Max total level value (max attenuation) */
+#define MAX_TOTAL_LEVEL     (0x7FU)
+
 /* Internal peripheral assignation */
 #define YM2612_SPI          ( SPI_1 )
 
@@ -53,9 +61,19 @@ const static uint16_t u16OctaveBaseValues[] = {
     980, 1038, 1100, 1165
 };
 
+/* Carrier operators by algorithm, bit N set for xOperator[N].
+ * Operator array follows register order: S1, S3, S2, S4. */
+const static uint8_t u8CarrierMask[MAX_VALUE_ALGORITHM] = {
+    0x08U, 0x08U, 0x08U, 0x08U,
+    0x0CU, 0x0EU, 0x0EU, 0x0FU
+};
+
 /* Chip control structure */
 static xFmDevice_t xYmDevice = {0};
 
+/* Last value written on each register, chip registers can not be read back */
+static uint8_t pu8YmRegMirror[YM2612_NUM_BANK][YM2612_REG_NUM] = {0};
+
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -65,7 +83,7 @@ static xFmDevice_t xYmDevice = {0};
   * @param  pu8RegData pointer where store register value.
   * @retval True if registere has been extracted, False ioc.
 */
-static bool _get_device_register_value(xFmDevice_t * pxDevice, uint8_t u8RegAddr, uint8_t * pu8RegData);
+static bool _get_device_register_value(const xFmDevice_t * pxDevice, uint8_t u8RegAddr, uint8_t * pu8RegData);
 
 /**
   * @brief  Get chanbel register value from device structure.
@@ -74,7 +92,7 @@ static bool _get_device_register_value(xFmDevice_t * pxDevice, uint8_t u8RegAddr
   * @param  pu8RegData pointer where store register value.
   * @retval True if registere has been extracted, False ioc.
 */
-static bool _get_channel_register_value(xFmChannel_t * pxChannel, uint8_t u8RegAddr, uint8_t * pu8RegData);
+static bool _get_channel_register_value(const xFmChannel_t * pxChannel, uint8_t u8RegAddr, uint8_t * pu8RegData);
 
 /**
   * @brief  Get channel operator register value from device structure.
@@ -83,7 +101,54 @@ static bool _get_channel_register_value(xFmChannel_t * pxChannel, uint8_t u8RegA
   * @param  pu8RegData pointer where store register value.
   * @retval True if registere has been extracted, False ioc.
 */
-static bool _get_operator_register_value(xFmOperator_t * pxOperator, uint8_t u8RegAddr, uint8_t * pu8RegData);
+static bool _get_operator_register_value(const xFmOperator_t * pxOperator, uint8_t u8RegAddr, uint8_t * pu8RegData);
+
+/**
+  * @brief  Write all registers of one channel into the chip.
+  * @param  xChannel synth channel to update.
+  * @param  pxChannel pointer to channel control structure.
+  * @retval None.
+*/
+static void _set_channel_registers(YM2612_ch_id_t xChannel, xFmChannel_t * pxChannel);
+
+/**
+  * @brief  Get location of a parameter on device structure.
+  * @param  pxDevice device structure to look into.
+  * @param  eParam parameter to look for.
+  * @param  xChannel synth channel.
+  * @param  xOperator channel operator.
+  * @param  pu8RegAddr pointer where store base address of register holding the parameter.
+  * @retval Pointer to parameter, NULL if not valid.
+*/
+static uint8_t * _get_param_ptr(xFmDevice_t * pxDevice, eFmParameter_t eParam, YM2612_ch_id_t xChannel, YM2612_op_id_t xOperator, uint8_t * pu8RegAddr);
+
+/**
+  * @brief  Get F-num and block values for a midi note.
+  * @param  u8MidiNote Midi note to convert.
+  * @param  pu16Fnum pointer where store F-num value.
+  * @param  pu8Block pointer where store block value.
+  * @retval True if note is in chip range, False ioc.
+*/
+static bool _get_note_freq(uint8_t u8MidiNote, uint16_t * pu16Fnum, uint8_t * pu8Block);
+
+/**
+  * @brief  Get F-num and block values for a midi note plus cents.
+  * @param  u8MidiNote Midi note to convert.
+  * @param  u8Cents Cents over the note, 0-99.
+  * @param  pu16Fnum pointer to store F-num value.
+  * @param  pu8Block pointer to store block value.
+  * @retval True if note is in chip range, False ioc.
+  */
+static bool _get_note_freq_fine(uint8_t u8MidiNote, uint8_t u8Cents, uint16_t * pu16Fnum, uint8_t * pu8Block);
+
+/**
+  * @brief  Write F-num and block of a channel into the chip.
+  * @param  xChannel synth channel to update.
+  * @param  u16Fnum F-num value.
+  * @param  u8Block block value.
+  * @retval None.
+*/
+static void _set_channel_freq(YM2612_ch_id_t xChannel, uint16_t u16Fnum, uint8_t u8Block);
 
 /* Low level implementation  -------------------------------------------------*/
 
@@ -123,7 +188,7 @@ static void _low_level_SetRegData(uint16_t u16DxData);
 
 /* Private user code ---------------------------------------------------------*/
 
-static bool _get_device_register_value(xFmDevice_t * pxDevice, uint8_t u8RegAddr, uint8_t * pu8RegData)
+static bool _get_device_register_value(const xFmDevice_t * pxDevice, uint8_t u8RegAddr, uint8_t * pu8RegData)
 {
     ERR_ASSERT(pxDevice != NULL);
     ERR_ASSERT(pu8RegData != NULL);
@@ -141,7 +206,7 @@ static bool _get_device_register_value(xFmDevice_t * pxDevice, uint8_t u8RegAddr
     return bRetVal;
 }
 
-static bool _get_channel_register_value(xFmChannel_t * pxChannel, uint8_t u8RegAddr, uint8_t * pu8RegData)
+static bool _get_channel_register_value(const xFmChannel_t * pxChannel, uint8_t u8RegAddr, uint8_t * pu8RegData)
 {
     ERR_ASSERT(pxChannel != NULL);
     ERR_ASSERT(pu8RegData != NULL);
@@ -167,7 +232,7 @@ static bool _get_channel_register_value(xFmChannel_t * pxChannel, uint8_t u8RegA
     return bRetVal;
 }
 
-static bool _get_operator_register_value(xFmOperator_t * pxOperator, uint8_t u8RegAddr, uint8_t * pu8RegData)
+static bool _get_operator_register_value(const xFmOperator_t * pxOperator, uint8_t u8RegAddr, uint8_t * pu8RegData)
 {
     ERR_ASSERT(pxOperator != NULL);
     ERR_ASSERT(pu8RegData != NULL);
@@ -183,7 +248,7 @@ static bool _get_operator_register_value(xFmOperator_t * pxOperator, uint8_t u8R
     }
     else if (u8RegAddr == YM2612_ADDR_TOT_LVL)
     {
-        u8RegData = pxOperator->u8TotalLevel & 0x1F;
+        u8RegData = pxOperator->u8TotalLevel & 0x7F;
         *pu8RegData = u8RegData;
         bRetVal = true;
     }
@@ -221,6 +286,203 @@ static bool _get_operator_register_value(xFmOperator_t * pxOperator, uint8_t u8R
     return bRetVal;
 }
 
+static void _set_channel_registers(YM2612_ch_id_t xChannel, xFmChannel_t * pxChannel)
+{
+    ERR_ASSERT(pxChannel != NULL);
+
+    uint8_t u8RegValue = 0U;
+    uint8_t u8BankOffset = xChannel / 3U;
+    uint8_t u8ChannelOffset = xChannel % 3U;
+
+    (void)_get_channel_register_value(pxChannel, YM2612_ADDR_FB_ALG, &u8RegValue);
+    vYM2612_write_reg(YM2612_ADDR_FB_ALG + u8ChannelOffset, u8RegValue, u8BankOffset);
+
+    (void)_get_channel_register_value(pxChannel, YM2612_ADDR_LR_AMS_PMS, &u8RegValue);
+    vYM2612_write_reg(YM2612_ADDR_LR_AMS_PMS + u8ChannelOffset, u8RegValue, u8BankOffset);
+
+    for (uint32_t u32IOperator = 0U; u32IOperator < YM2612_NUM_OP_CHANNEL; u32IOperator++)
+    {
+        xFmOperator_t * pxOperator = &pxChannel->xOperator[u32IOperator];
+        uint8_t u8OpOffset = u32IOperator * 4;
+
+        (void)_get_operator_register_value(pxOperator, YM2612_ADDR_DET_MULT, &u8RegValue);
+        vYM2612_write_reg(YM2612_ADDR_DET_MULT + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+
+        (void)_get_operator_register_value(pxOperator, YM2612_ADDR_TOT_LVL, &u8RegValue);
+        vYM2612_write_reg(YM2612_ADDR_TOT_LVL + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+
+        (void)_get_operator_register_value(pxOperator, YM2612_ADDR_KS_AR, &u8RegValue);
+        vYM2612_write_reg(YM2612_ADDR_KS_AR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+
+        (void)_get_operator_register_value(pxOperator, YM2612_ADDR_AM_DR, &u8RegValue);
+        vYM2612_write_reg(YM2612_ADDR_AM_DR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+
+        (void)_get_operator_register_value(pxOperator, YM2612_ADDR_SR, &u8RegValue);
+        vYM2612_write_reg(YM2612_ADDR_SR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+
+        (void)_get_operator_register_value(pxOperator, YM2612_ADDR_SL_RR, &u8RegValue);
+        vYM2612_write_reg(YM2612_ADDR_SL_RR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+
+        (void)_get_operator_register_value(pxOperator, YM2612_ADDR_SSG_EG, &u8RegValue);
+        vYM2612_write_reg(YM2612_ADDR_SSG_EG + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+    }
+}
+
+static uint8_t * _get_param_ptr(xFmDevice_t * pxDevice, eFmParameter_t eParam, YM2612_ch_id_t xChannel, YM2612_op_id_t xOperator, uint8_t * pu8RegAddr)
+{
+    ERR_ASSERT(pxDevice != NULL);
+    ERR_ASSERT(pu8RegAddr != NULL);
+
+    uint8_t * pu8Param = NULL;
+    xFmChannel_t * pxChannel = &pxDevice->xChannel[xChannel % YM2612_NUM_CHANNEL];
+    xFmOperator_t * pxOperator = &pxChannel->xOperator[xOperator % YM2612_NUM_OP_CHANNEL];
+
+    switch (eParam)
+    {
+        case FM_VAR_LFO_ON:
+            pu8Param = &pxDevice->u8LfoOn;
+            *pu8RegAddr = YM2612_ADDR_LFO;
+            break;
+        case FM_VAR_LFO_FREQ:
+            pu8Param = &pxDevice->u8LfoFreq;
+            *pu8RegAddr = YM2612_ADDR_LFO;
+            break;
+        case FM_VAR_VOICE_FEEDBACK:
+            pu8Param = &pxChannel->u8Feedback;
+            *pu8RegAddr = YM2612_ADDR_FB_ALG;
+            break;
+        case FM_VAR_VOICE_ALGORITHM:
+            pu8Param = &pxChannel->u8Algorithm;
+            *pu8RegAddr = YM2612_ADDR_FB_ALG;
+            break;
+        case FM_VAR_VOICE_AUDIO_OUT:
+            pu8Param = &pxChannel->u8AudioOut;
+            *pu8RegAddr = YM2612_ADDR_LR_AMS_PMS;
+            break;
+        case FM_VAR_VOICE_AMP_MOD_SENS:
+            pu8Param = &pxChannel->u8AmpModSens;
+            *pu8RegAddr = YM2612_ADDR_LR_AMS_PMS;
+            break;
+        case FM_VAR_VOICE_PHA_MOD_SENS:
+            pu8Param = &pxChannel->u8PhaseModSens;
+            *pu8RegAddr = YM2612_ADDR_LR_AMS_PMS;
+            break;
+        case FM_VAR_OPERATOR_DETUNE:
+            pu8Param = &pxOperator->u8Detune;
+            *pu8RegAddr = YM2612_ADDR_DET_MULT;
+            break;
+        case FM_VAR_OPERATOR_MULTIPLE:
+            pu8Param = &pxOperator->u8Multiple;
+            *pu8RegAddr = YM2612_ADDR_DET_MULT;
+            break;
+        case FM_VAR_OPERATOR_TOTAL_LEVEL:
+            pu8Param = &pxOperator->u8TotalLevel;
+            *pu8RegAddr = YM2612_ADDR_TOT_LVL;
+            break;
+        case FM_VAR_OPERATOR_KEY_SCALE:
+            pu8Param = &pxOperator->u8KeyScale;
+            *pu8RegAddr = YM2612_ADDR_KS_AR;
+            break;
+        case FM_VAR_OPERATOR_ATTACK_RATE:
+            pu8Param = &pxOperator->u8AttackRate;
+            *pu8RegAddr = YM2612_ADDR_KS_AR;
+            break;
+        case FM_VAR_OPERATOR_AMP_MOD:
+            pu8Param = &pxOperator->u8AmpMod;
+            *pu8RegAddr = YM2612_ADDR_AM_DR;
+            break;
+        case FM_VAR_OPERATOR_DECAY_RATE:
+            pu8Param = &pxOperator->u8DecayRate;
+            *pu8RegAddr = YM2612_ADDR_AM_DR;
+            break;
+        case FM_VAR_OPERATOR_SUSTAIN_RATE:
+            pu8Param = &pxOperator->u8SustainRate;
+            *pu8RegAddr = YM2612_ADDR_SR;
+            break;
+        case FM_VAR_OPERATOR_SUSTAIN_LEVEL:
+            pu8Param = &pxOperator->u8SustainLevel;
+            *pu8RegAddr = YM2612_ADDR_SL_RR;
+            break;
+        case FM_VAR_OPERATOR_RELEASE_RATE:
+            pu8Param = &pxOperator->u8ReleaseRate;
+            *pu8RegAddr = YM2612_ADDR_SL_RR;
+            break;
+        case FM_VAR_OPERATOR_SSG_ENVELOPE:
+            pu8Param = &pxOperator->u8SsgEg;
+            *pu8RegAddr = YM2612_ADDR_SSG_EG;
+            break;
+        default:
+            break;
+    }
+
+    return pu8Param;
+}
+
+static bool _get_note_freq(uint8_t u8MidiNote, uint16_t * pu16Fnum, uint8_t * pu8Block)
+{
+    ERR_ASSERT(pu16Fnum != NULL);
+    ERR_ASSERT(pu8Block != NULL);
+
+    bool bRetval = false;
+    uint8_t u8NoteIndex = u8MidiNote % NUM_NOTES_OCTAVE;
+    uint8_t u8OctaveIndex = u8MidiNote / NUM_NOTES_OCTAVE;
+    uint8_t u8BlockOffset = BASE_BLOCK;
+
+    if (BASE_BLOCK > u8OctaveIndex)
+    {
+        u8BlockOffset -= BASE_BLOCK - u8OctaveIndex;
+    }
+    else if (BASE_BLOCK < u8OctaveIndex)
+    {
+        u8BlockOffset += u8OctaveIndex - BASE_BLOCK;
+    }
+
+    if (u8BlockOffset < MAX_BLOCK)
+    {
+        *pu16Fnum = u16OctaveBaseValues[u8NoteIndex];
+        *pu8Block = u8BlockOffset;
+        bRetval = true;
+    }
+
+    return bRetval;
+}
+
+static bool _get_note_freq_fine(uint8_t u8MidiNote, uint8_t u8Cents, uint16_t * pu16Fnum, uint8_t * pu8Block)
+{
+    bool bRetval = _get_note_freq(u8MidiNote, pu16Fnum, pu8Block);
+
+    if (bRetval && (u8Cents != 0U))
+    {
+        /* Next note on the same block, last note of the table wraps to double F-num */
+        uint8_t u8NoteIndex = u8MidiNote % NUM_NOTES_OCTAVE;
+        uint16_t u16NextFnum = (u8NoteIndex < (NUM_NOTES_OCTAVE - 1U)) ? u16OctaveBaseValues[u8NoteIndex + 1U] : (uint16_t)(u16OctaveBaseValues[0U] * 2U);
+
+        /* Linear step inside a semitone, up to 0.7 cents sharp mid semitone, F-num step is about 3 cents */
+        *pu16Fnum += (uint16_t)((((uint32_t)(u16NextFnum - *pu16Fnum) * u8Cents) + (NUM_CENTS_NOTE / 2U)) / NUM_CENTS_NOTE);
+    }
+
+    return bRetval;
+}
+
+static void _set_channel_freq(YM2612_ch_id_t xChannel, uint16_t u16Fnum, uint8_t u8Block)
+{
+    uint8_t u8BankOffset = xChannel / 3U;
+    uint8_t u8ChannelOffset = xChannel % 3U;
+    uint8_t u8Data = 0U;
+
+#ifdef YM2612_DEBUG
+    vCliPrintf("DBG", "Fnum %d, Block %d", u16Fnum, u8Block);
+#endif
+
+    /* FNUM_2 must be written first, it is latched with FNUM_1 write */
+    u8Data = (u16Fnum >> 8U) & 0x07U;
+    u8Data |= (u8Block & 0x07U) << 3U;
+    vYM2612_write_reg(YM2612_ADDR_FNUM_2 + u8ChannelOffset, u8Data, u8BankOffset);
+
+    u8Data = u16Fnum & 0xFFU;
+    vYM2612_write_reg(YM2612_ADDR_FNUM_1 + u8ChannelOffset, u8Data, u8BankOffset);
+}
+
 static void _low_level_init(void)
 {
     (void)SPI_init(YM2612_SPI, NULL);
@@ -331,6 +593,9 @@ YM2612_status_t xYM2612_init(void)
 
     _low_level_resetDevice();
 
+    /* Chip registers are cleared on reset */
+    memset(pu8YmRegMirror, 0, sizeof(pu8YmRegMirror));
+
     return (retval);
 }
 
@@ -347,6 +612,11 @@ void vYM2612_write_reg(uint8_t u8RegAddr, uint8_t u8RegData, YM2612_bank_t xBank
 {
     /* Wrapper for low level abstraction */
     _low_level_writeRegister(u8RegAddr, u8RegData, xBank);
+
+    if ((u8RegAddr >= YM2612_REG_FIRST) && (u8RegAddr <= YM2612_REG_LAST) && (xBank < YM2612_NUM_BANK))
+    {
+        pu8YmRegMirror[xBank][u8RegAddr - YM2612_REG_FIRST] = u8RegData;
+    }
 }
 
 void vYM2612_set_reg_preset(xFmDevice_t * pxRegPreset)
@@ -364,46 +634,140 @@ void vYM2612_set_reg_preset(xFmDevice_t * pxRegPreset)
 
     for (uint32_t u32IVoice = 0U; u32IVoice < YM2612_NUM_CHANNEL; u32IVoice++)
     {
-        uint8_t u8BankOffset = u32IVoice / 3U;
-        uint8_t u8ChannelOffset = u32IVoice % 3U;
+        _set_channel_registers((YM2612_ch_id_t)u32IVoice, &xYmDevice.xChannel[u32IVoice]);
+    }
+}
 
-        (void)_get_channel_register_value(&xYmDevice.xChannel[u32IVoice], YM2612_ADDR_FB_ALG, &u8RegValue);
-        vYM2612_write_reg(YM2612_ADDR_FB_ALG + u8ChannelOffset, u8RegValue, u8BankOffset);
+void vYM2612_set_reg_channel(YM2612_ch_id_t xChannel, xFmChannel_t * pxRegChannel)
+{
+    ERR_ASSERT(xChannel < YM2612_NUM_CH);
+    ERR_ASSERT(pxRegChannel != NULL);
 
-        (void)_get_channel_register_value(&xYmDevice.xChannel[u32IVoice], YM2612_ADDR_LR_AMS_PMS, &u8RegValue);
-        vYM2612_write_reg(YM2612_ADDR_LR_AMS_PMS + u8ChannelOffset, u8RegValue, u8BankOffset);
+    /* Copy channel preset, rest of the device is not modified */
+    xYmDevice.xChannel[xChannel] = *pxRegChannel;
 
-        for (uint32_t u32IOperator = 0U; u32IOperator < YM2612_NUM_OP_CHANNEL; u32IOperator++)
-        {
-            uint8_t u8OpOffset = u32IOperator * 4;
+    /* Set values on chip */
+    _set_channel_registers(xChannel, &xYmDevice.xChannel[xChannel]);
+}
 
-            (void)_get_operator_register_value(&xYmDevice.xChannel[u32IVoice].xOperator[u32IOperator], YM2612_ADDR_DET_MULT, &u8RegValue);
-            vYM2612_write_reg(YM2612_ADDR_DET_MULT + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+xFmDevice_t * pxYM2612_get_reg_preset (void)
+{
+    return &xYmDevice;
+}
 
-            (void)_get_operator_register_value(&xYmDevice.xChannel[u32IVoice].xOperator[u32IOperator], YM2612_ADDR_TOT_LVL, &u8RegValue);
-            vYM2612_write_reg(YM2612_ADDR_TOT_LVL + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+const uint8_t * pu8YM2612_get_reg_mirror(void)
+{
+    return &pu8YmRegMirror[0U][0U];
+}
 
-            (void)_get_operator_register_value(&xYmDevice.xChannel[u32IVoice].xOperator[u32IOperator], YM2612_ADDR_KS_AR, &u8RegValue);
-            vYM2612_write_reg(YM2612_ADDR_KS_AR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+bool bYM2612_get_reg(uint8_t u8RegAddr, YM2612_bank_t xBank, uint8_t * pu8RegData)
+{
+    ERR_ASSERT(pu8RegData != NULL);
 
-            (void)_get_operator_register_value(&xYmDevice.xChannel[u32IVoice].xOperator[u32IOperator], YM2612_ADDR_AM_DR, &u8RegValue);
-            vYM2612_write_reg(YM2612_ADDR_AM_DR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+    bool bRetVal = false;
 
-            (void)_get_operator_register_value(&xYmDevice.xChannel[u32IVoice].xOperator[u32IOperator], YM2612_ADDR_SR, &u8RegValue);
-            vYM2612_write_reg(YM2612_ADDR_SR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+    if ((u8RegAddr >= YM2612_REG_FIRST) && (u8RegAddr <= YM2612_REG_LAST) && (xBank < YM2612_NUM_BANK))
+    {
+        *pu8RegData = pu8YmRegMirror[xBank][u8RegAddr - YM2612_REG_FIRST];
+        bRetVal = true;
+    }
 
-            (void)_get_operator_register_value(&xYmDevice.xChannel[u32IVoice].xOperator[u32IOperator], YM2612_ADDR_SL_RR, &u8RegValue);
-            vYM2612_write_reg(YM2612_ADDR_SL_RR + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+    return bRetVal;
+}
 
-            (void)_get_operator_register_value(&xYmDevice.xChannel[u32IVoice].xOperator[u32IOperator], YM2612_ADDR_SSG_EG, &u8RegValue);
-            vYM2612_write_reg(YM2612_ADDR_SSG_EG + u8ChannelOffset + u8OpOffset, u8RegValue, u8BankOffset);
+bool bYM2612_get_preset_reg(const xFmDevice_t * pxDevice, uint8_t u8RegAddr, YM2612_bank_t xBank, uint8_t * pu8RegData)
+{
+    ERR_ASSERT(pxDevice != NULL);
+    ERR_ASSERT(pu8RegData != NULL);
+
+    bool bRetVal = false;
+    uint8_t u8ChannelOffset = u8RegAddr & 0x03U;
+    uint32_t u32Channel = (xBank * 3U) + u8ChannelOffset;
+
+    if (u8RegAddr == YM2612_ADDR_LFO)
+    {
+        bRetVal = (xBank == YM2612_BANK_0) && _get_device_register_value(pxDevice, u8RegAddr, pu8RegData);
+    }
+    else if ((xBank >= YM2612_NUM_BANK) || (u8ChannelOffset == 0x03U))
+    {
+        /* Fourth slot of each register group is not used */
+    }
+    else if ((u8RegAddr >= YM2612_ADDR_DET_MULT) && (u8RegAddr < YM2612_ADDR_FNUM_1))
+    {
+        /* Operator registers follow S1, S3, S2, S4 order, same as preset array */
+        const xFmOperator_t * pxOperator = &pxDevice->xChannel[u32Channel].xOperator[(u8RegAddr >> 2U) & 0x03U];
+
+        bRetVal = _get_operator_register_value(pxOperator, u8RegAddr & 0xF0U, pu8RegData);
+    }
+    else if ((u8RegAddr >= YM2612_ADDR_FB_ALG) && (u8RegAddr <= YM2612_REG_LAST))
+    {
+        bRetVal = _get_channel_register_value(&pxDevice->xChannel[u32Channel], u8RegAddr & 0xFCU, pu8RegData);
+    }
+
+    return bRetVal;
+}
+
+uint8_t u8YM2612_get_param(xFmDevice_t * pxDevice, eFmParameter_t eParam, YM2612_ch_id_t xChannel, YM2612_op_id_t xOperator)
+{
+    uint8_t u8RetVal = 0U;
+    uint8_t u8RegAddr = 0U;
+
+    if (pxDevice == NULL)
+    {
+        pxDevice = &xYmDevice;
+    }
+
+    if ((xChannel < YM2612_NUM_CH) && (xOperator < YM2612_NUM_OP))
+    {
+        uint8_t * pu8Param = _get_param_ptr(pxDevice, eParam, xChannel, xOperator, &u8RegAddr);
+
+        if (pu8Param != NULL)
+        {
+            u8RetVal = *pu8Param;
         }
     }
+
+    return u8RetVal;
 }
 
-xFmDevice_t * pxYM2612_get_reg_preset (void)
+bool bYM2612_set_param(eFmParameter_t eParam, YM2612_ch_id_t xChannel, YM2612_op_id_t xOperator, uint8_t u8Value)
 {
-    return &xYmDevice;
+    bool bRetval = false;
+    uint8_t u8RegAddr = 0U;
+    uint8_t * pu8Param = NULL;
+
+    if ((xChannel < YM2612_NUM_CH) && (xOperator < YM2612_NUM_OP))
+    {
+        pu8Param = _get_param_ptr(&xYmDevice, eParam, xChannel, xOperator, &u8RegAddr);
+    }
+
+    if (pu8Param != NULL)
+    {
+        uint8_t u8RegValue = 0U;
+        uint8_t u8BankOffset = xChannel / 3U;
+        uint8_t u8ChannelOffset = xChannel % 3U;
+        xFmChannel_t * pxChannel = &xYmDevice.xChannel[xChannel];
+
+        *pu8Param = u8Value;
+
+        /* Write only the register holding the parameter */
+        if (_get_device_register_value(&xYmDevice, u8RegAddr, &u8RegValue))
+        {
+            vYM2612_write_reg(u8RegAddr, u8RegValue, YM2612_BANK_0);
+        }
+        else if (_get_channel_register_value(pxChannel, u8RegAddr, &u8RegValue))
+        {
+            vYM2612_write_reg(u8RegAddr + u8ChannelOffset, u8RegValue, u8BankOffset);
+        }
+        else if (_get_operator_register_value(&pxChannel->xOperator[xOperator], u8RegAddr, &u8RegValue))
+        {
+            vYM2612_write_reg(u8RegAddr + u8ChannelOffset + (xOperator * 4U), u8RegValue, u8BankOffset);
+        }
+
+        bRetval = true;
+    }
+
+    return bRetval;
 }
 
 bool bYM2612_set_note(YM2612_ch_id_t xChannel, uint8_t u8MidiNote)
@@ -411,51 +775,88 @@ bool bYM2612_set_note(YM2612_ch_id_t xChannel, uint8_t u8MidiNote)
     ERR_ASSERT(xChannel < YM2612_NUM_CH);
 
     bool bRetval = false;
-    bool bBankSelection = xChannel / 3;
-    uint8_t u8Addr = 0U;
-    uint8_t u8Data = 0U;
-    uint8_t u8ChannelOffset = xChannel % 3U;
-    uint8_t u8NoteIndex = u8MidiNote % NUM_NOTES_OCTAVE;
-    uint8_t u8OctaveIndex = u8MidiNote / NUM_NOTES_OCTAVE;
-    uint16_t u16fnum = u16OctaveBaseValues[u8NoteIndex];
-    uint8_t u8BlockOffset = BASE_BLOCK;
+    uint16_t u16Fnum = 0U;
+    uint8_t u8Block = 0U;
 
-    if (BASE_BLOCK > u8OctaveIndex)
-    {
-        u8BlockOffset -= BASE_BLOCK - u8OctaveIndex;
-    }
-    else if (BASE_BLOCK < u8OctaveIndex)
+    if (_get_note_freq(u8MidiNote, &u16Fnum, &u8Block))
     {
-        u8BlockOffset += u8OctaveIndex - BASE_BLOCK;
+        _set_channel_freq(xChannel, u16Fnum, u8Block);
+        bRetval = true;
     }
-
-    if (u8BlockOffset < MAX_BLOCK)
+    else
     {
 #ifdef YM2612_DEBUG
-        vCliPrintf("DBG", "Fnum %d, Block %d", u16fnum, u8BlockOffset);
+        vCliPrintf("DBG", "Note %d Out of range", u8MidiNote);
 #endif
+    }
 
-        u8Addr = YM2612_ADDR_FNUM_2 + u8ChannelOffset;
-        u8Data = (u16fnum >> 8U) & 0x07U;
-        u8Data |= (u8BlockOffset & 0x07U) << 3U;
-        vYM2612_write_reg(u8Addr, u8Data, bBankSelection);
+    return bRetval;
+}
 
-        u8Addr = YM2612_ADDR_FNUM_1 + u8ChannelOffset;
-        u8Data = u16fnum & 0xFFU;
-        vYM2612_write_reg(u8Addr, u8Data, bBankSelection);
+bool bYM2612_set_note_fine(YM2612_ch_id_t xChannel, uint8_t u8MidiNote, uint8_t u8Cents)
+{
+    ERR_ASSERT(xChannel < YM2612_NUM_CH);
 
+    bool bRetval = false;
+    uint16_t u16Fnum = 0U;
+    uint8_t u8Block = 0U;
+
+    if ((u8Cents < NUM_CENTS_NOTE) && _get_note_freq_fine(u8MidiNote, u8Cents, &u16Fnum, &u8Block))
+    {
+        _set_channel_freq(xChannel, u16Fnum, u8Block);
         bRetval = true;
     }
-    else
+
+    return bRetval;
+}
+
+bool bYM2612_note_on(YM2612_ch_id_t xChannel, uint8_t u8MidiNote, const uint8_t * pu8TlOffset)
+{
+    ERR_ASSERT(xChannel < YM2612_NUM_CH);
+
+    bool bRetval = false;
+    uint16_t u16Fnum = 0U;
+    uint8_t u8Block = 0U;
+
+    if (_get_note_freq(u8MidiNote, &u16Fnum, &u8Block))
     {
-#ifdef YM2612_DEBUG
-        vCliPrintf("DBG", "Block %d Out of range", u8BlockOffset);
-#endif
+        /* Carrier levels are written just before frequency and key on */
+        if (pu8TlOffset != NULL)
+        {
+            xFmChannel_t * pxChannel = &xYmDevice.xChannel[xChannel];
+            uint8_t u8Mask = u8YM2612_get_carrier_mask(pxChannel->u8Algorithm);
+            uint8_t u8BankOffset = xChannel / 3U;
+            uint8_t u8ChannelOffset = xChannel % 3U;
+
+            for (uint32_t u32IOperator = 0U; u32IOperator < YM2612_NUM_OP_CHANNEL; u32IOperator++)
+            {
+                if ((u8Mask & (1U << u32IOperator)) != 0U)
+                {
+                    uint16_t u16Level = (uint16_t)(pxChannel->xOperator[u32IOperator].u8TotalLevel & MAX_TOTAL_LEVEL) + pu8TlOffset[u32IOperator];
+
+                    if (u16Level > MAX_TOTAL_LEVEL)
+                    {
+                        u16Level = MAX_TOTAL_LEVEL;
+                    }
+
+                    vYM2612_write_reg(YM2612_ADDR_TOT_LVL + u8ChannelOffset + (u32IOperator * 4U), (uint8_t)u16Level, u8BankOffset);
+                }
+            }
+        }
+
+        _set_channel_freq(xChannel, u16Fnum, u8Block);
+        vYM2612_key_on(xChannel);
+        bRetval = true;
     }
 
     return bRetval;
 }
 
+uint8_t u8YM2612_get_carrier_mask(uint8_t u8Algorithm)
+{
+    return u8CarrierMask[u8Algorithm & 0x07U];
+}
+
 void vYM2612_key_on(YM2612_ch_id_t xChannel)
 {
     ERR_ASSERT(xChannel < YM2612_NUM_CH);
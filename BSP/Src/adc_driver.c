@@ -7,13 +7,37 @@
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <stdbool.h>
+
 #include "adc_driver.h"
 #include "user_error.h"
 
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
+
+/* Per channel filter state */
+typedef struct
+{
+    uint16_t u16Raw[2U];            /* Last two raw samples for median */
+    uint16_t u16Reported;           /* Last value reported through callback */
+    uint16_t u16Threshold;          /* Change needed to report */
+    uint32_t u32Filtered;           /* IIR output, ADC_FILTER_FRAC_BITS fractional bits */
+    uint16_t u16GateOn;             /* Gate activation level */
+    uint16_t u16GateOff;            /* Gate release level */
+    volatile bool bGate;            /* Channel handled as gate */
+    bool bGateActive;               /* Current gate state */
+} adc_filter_t;
+
 /* Private define ------------------------------------------------------------*/
+
+/* Samples on each DMA half buffer */
+#define ADC_DMA_HALF_SIZE           ( (ADC_DMA_SCAN_NUM / 2U) * ADC_CH_NUM )
+
 /* Private macro -------------------------------------------------------------*/
+
+/* Filtered value rounded to ADC counts */
+#define ADC_FILTER_OUT(F)           ( (uint16_t)( ( (F) + (1UL << (ADC_FILTER_FRAC_BITS - 1U)) ) >> ADC_FILTER_FRAC_BITS ) )
+
 /* Private variables ---------------------------------------------------------*/
 
 /* ADC 0 peripheral control variables */
@@ -23,8 +47,14 @@ DMA_HandleTypeDef hdma_adc1;
 /* Callback handler */
 static adc_event_cb adc_0_event_cb = NULL;
 
-/* ADC group regular conversion data (array of data) */
-volatile uint16_t pu16AdcConvertedData[ADC_CH_NUM] = { 0U };
+/* ADC group regular conversion data, ADC_DMA_SCAN_NUM full sequences */
+volatile uint16_t pu16AdcConvertedData[ADC_DMA_SCAN_NUM * ADC_CH_NUM] = { 0U };
+
+/* Filter state, only written from DMA callbacks */
+static adc_filter_t xAdcFilter[ADC_CH_NUM] = { 0U };
+
+/* Filter state needs to be loaded from first scan */
+static bool bAdcFilterInit = false;
 
 /* Private function prototypes -----------------------------------------------*/
 
@@ -46,6 +76,20 @@ static void __adc_0_low_level_init(void);
 */
 static void __adc_0_low_level_deinit(void);
 
+/**
+  * @brief  Median of three samples
+  * @retval Median value
+*/
+static inline uint16_t __adc_median3(uint16_t a, uint16_t b, uint16_t c);
+
+/**
+  * @brief  Filter a block of sequences, detect gate edges and report channels that moved
+  * @param  pu16Data first sample of the block.
+  * @param  u32Size number of samples, multiple of ADC_CH_NUM.
+  * @retval None
+*/
+static void __adc_0_process(volatile uint16_t * pu16Data, uint32_t u32Size);
+
 /* Private user code ---------------------------------------------------------*/
 
 static void __adc_error_handler(void)
@@ -60,7 +104,7 @@ static void __adc_0_low_level_init(void)
 
     /** Configure the global features of the ADC (Clock, Resolution, Data Alignment and number of conversion) */
     hadc1.Instance = ADC1;
-    hadc1.Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV64;
+    hadc1.Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV8;
     hadc1.Init.Resolution = ADC_RESOLUTION_12B;
     hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
     hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;
@@ -76,7 +120,11 @@ static void __adc_0_low_level_init(void)
     hadc1.Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
     hadc1.Init.SamplingTimeCommon1 = ADC_SAMPLETIME_160CYCLES_5;
     hadc1.Init.SamplingTimeCommon2 = ADC_SAMPLETIME_160CYCLES_5;
-    hadc1.Init.OversamplingMode = DISABLE;
+    /* 8x hardware oversampling, result kept on 12 bits, aprox 0.7 ms per sequence */
+    hadc1.Init.OversamplingMode = ENABLE;
+    hadc1.Init.Oversampling.Ratio = ADC_OVERSAMPLING_RATIO_8;
+    hadc1.Init.Oversampling.RightBitShift = ADC_RIGHTBITSHIFT_3;
+    hadc1.Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
     hadc1.Init.TriggerFrequencyMode = ADC_TRIGGER_FREQ_HIGH;
     if (HAL_ADC_Init(&hadc1) != HAL_OK)
     {
@@ -130,23 +178,119 @@ static void __adc_0_low_level_deinit(void)
     HAL_ADC_DeInit(&hadc1);
 }
 
+static inline uint16_t __adc_median3(uint16_t a, uint16_t b, uint16_t c)
+{
+    uint16_t u16Max = (a > b) ? a : b;
+    uint16_t u16Min = (a > b) ? b : a;
+
+    return (c > u16Max) ? u16Max : ((c < u16Min) ? u16Min : c);
+}
+
+static void __adc_0_process(volatile uint16_t * pu16Data, uint32_t u32Size)
+{
+    uint32_t u32ChMask = 0U;
+    uint32_t u32GateOnMask = 0U;
+    uint32_t u32GateOffMask = 0U;
+
+    for (uint32_t u32Index = 0U; u32Index < u32Size; u32Index += ADC_CH_NUM)
+    {
+        for (uint32_t u32Ch = 0U; u32Ch < ADC_CH_NUM; u32Ch++)
+        {
+            adc_filter_t * pxFilter = &xAdcFilter[u32Ch];
+            uint16_t u16Sample = pu16Data[u32Index + u32Ch];
+
+            /* Gates use raw samples, hysteresis gives the noise immunity */
+            if (pxFilter->bGate)
+            {
+                if (!pxFilter->bGateActive && (u16Sample < pxFilter->u16GateOn))
+                {
+                    pxFilter->bGateActive = true;
+                    u32GateOnMask |= (1UL << u32Ch);
+                }
+                else if (pxFilter->bGateActive && (u16Sample > pxFilter->u16GateOff))
+                {
+                    pxFilter->bGateActive = false;
+                    u32GateOffMask |= (1UL << u32Ch);
+                }
+            }
+
+            if (!bAdcFilterInit)
+            {
+                pxFilter->u16Raw[0U] = u16Sample;
+                pxFilter->u16Raw[1U] = u16Sample;
+                pxFilter->u32Filtered = (uint32_t)u16Sample << ADC_FILTER_FRAC_BITS;
+            }
+
+            /* Median removes single sample spikes, IIR smooths remaining noise */
+            uint32_t u32Median = __adc_median3(pxFilter->u16Raw[0U], pxFilter->u16Raw[1U], u16Sample);
+            pxFilter->u16Raw[0U] = pxFilter->u16Raw[1U];
+            pxFilter->u16Raw[1U] = u16Sample;
+
+            int32_t i32Diff = (int32_t)(u32Median << ADC_FILTER_FRAC_BITS) - (int32_t)pxFilter->u32Filtered;
+            pxFilter->u32Filtered = (uint32_t)((int32_t)pxFilter->u32Filtered + (i32Diff >> ADC_FILTER_IIR_SHIFT));
+        }
+
+        bAdcFilterInit = true;
+    }
+
+    /* Report only channels that moved beyond its threshold */
+    for (uint32_t u32Ch = 0U; u32Ch < ADC_CH_NUM; u32Ch++)
+    {
+        adc_filter_t * pxFilter = &xAdcFilter[u32Ch];
+        uint16_t u16Value = ADC_FILTER_OUT(pxFilter->u32Filtered);
+        uint16_t u16Delta = (u16Value > pxFilter->u16Reported) ? (u16Value - pxFilter->u16Reported) : (pxFilter->u16Reported - u16Value);
+
+        if ((u16Delta >= pxFilter->u16Threshold) && !pxFilter->bGate)
+        {
+            pxFilter->u16Reported = u16Value;
+            u32ChMask |= (1UL << u32Ch);
+        }
+    }
+
+    if (adc_0_event_cb != NULL)
+    {
+        if (u32GateOffMask != 0U)
+        {
+            adc_0_event_cb(ADC_EVENT_GATE_OFF, u32GateOffMask);
+        }
+
+        if (u32GateOnMask != 0U)
+        {
+            adc_0_event_cb(ADC_EVENT_GATE_ON, u32GateOnMask);
+        }
+
+        if (u32ChMask != 0U)
+        {
+            adc_0_event_cb(ADC_EVENT_UPDATE, u32ChMask);
+        }
+    }
+}
+
 /* Callback ------------------------------------------------------------------*/
 
 /**
-  * @brief  Conversion complete callback in non blocking mode 
+  * @brief  Conversion half complete callback, first half of DMA buffer ready
+  * @param  hadc: ADC handle
+  * @retval None
+  */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1)
+    {
+        __adc_0_process(&pu16AdcConvertedData[0U], ADC_DMA_HALF_SIZE);
+    }
+}
+
+/**
+  * @brief  Conversion complete callback, second half of DMA buffer ready
   * @param  hadc: ADC handle
-  * @note   This example shows a simple way to report end of conversion
-  *         and get conversion result. You can add your own implementation.
   * @retval None
   */
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
     if (hadc->Instance == ADC1)
     {
-        if (adc_0_event_cb != NULL)
-        {
-            adc_0_event_cb(ADC_EVENT_UPDATE);
-        }
+        __adc_0_process(&pu16AdcConvertedData[ADC_DMA_HALF_SIZE], ADC_DMA_HALF_SIZE);
     }
 }
 
@@ -161,6 +305,13 @@ adc_status_t ADC_init(adc_port_t dev, adc_event_cb event_cb)
         {
             adc_0_event_cb = event_cb;
         }
+
+        for (uint32_t u32Ch = 0U; u32Ch < ADC_CH_NUM; u32Ch++)
+        {
+            xAdcFilter[u32Ch].u16Threshold = ADC_THRESHOLD_DEFAULT;
+        }
+        bAdcFilterInit = false;
+
         __adc_0_low_level_init();
         xRetval = ADC_STATUS_OK;
     }
@@ -191,7 +342,7 @@ adc_status_t ADC_start(adc_port_t dev)
         /* Start ADC group regular conversion with DMA */
         if (HAL_ADC_Start_DMA(&hadc1, 
                             (uint32_t *)&pu16AdcConvertedData, 
-                            ADC_CH_NUM
+                            ADC_DMA_SCAN_NUM * ADC_CH_NUM
                             ) != HAL_OK)
         {
             xRetval = ADC_STATUS_BUSY;
@@ -229,8 +380,68 @@ adc_status_t ADC_get_value(adc_port_t dev, adc_ch_id_t xChId, uint16_t * pu16Adc
 
     if ((dev == ADC_0) && (xChId < ADC_CH_NUM) && (pu16AdcData != NULL))
     {
-        uint16_t u16TmpDataValue = pu16AdcConvertedData[xChId];
-        *pu16AdcData = u16TmpDataValue;
+        uint32_t u32TmpDataValue = xAdcFilter[xChId].u32Filtered;
+        *pu16AdcData = ADC_FILTER_OUT(u32TmpDataValue);
+        xRetval = ADC_STATUS_OK;
+    }
+
+    return xRetval;
+}
+
+adc_status_t ADC_get_raw_value(adc_port_t dev, adc_ch_id_t xChId, uint16_t * pu16AdcData)
+{
+    adc_status_t xRetval = ADC_STATUS_ERROR;
+
+    if ((dev == ADC_0) && (xChId < ADC_CH_NUM) && (pu16AdcData != NULL))
+    {
+        *pu16AdcData = xAdcFilter[xChId].u16Raw[1U];
+        xRetval = ADC_STATUS_OK;
+    }
+
+    return xRetval;
+}
+
+adc_status_t ADC_set_threshold(adc_port_t dev, adc_ch_id_t xChId, uint16_t u16Threshold)
+{
+    adc_status_t xRetval = ADC_STATUS_ERROR;
+
+    if ((dev == ADC_0) && (xChId < ADC_CH_NUM))
+    {
+        xAdcFilter[xChId].u16Threshold = u16Threshold;
+        xRetval = ADC_STATUS_OK;
+    }
+
+    return xRetval;
+}
+
+adc_status_t ADC_gate_enable(adc_port_t dev, adc_ch_id_t xChId, uint16_t u16OnLevel, uint16_t u16OffLevel)
+{
+    adc_status_t xRetval = ADC_STATUS_ERROR;
+
+    if ((dev == ADC_0) && (xChId < ADC_CH_NUM) && (u16OnLevel < u16OffLevel))
+    {
+        adc_filter_t * pxFilter = &xAdcFilter[xChId];
+
+        /* Disable while levels change, DMA callback only reads them with bGate set */
+        pxFilter->bGate = false;
+        pxFilter->u16GateOn = u16OnLevel;
+        pxFilter->u16GateOff = u16OffLevel;
+        pxFilter->bGateActive = false;
+        pxFilter->bGate = true;
+
+        xRetval = ADC_STATUS_OK;
+    }
+
+    return xRetval;
+}
+
+adc_status_t ADC_gate_disable(adc_port_t dev, adc_ch_id_t xChId)
+{
+    adc_status_t xRetval = ADC_STATUS_ERROR;
+
+    if ((dev == ADC_0) && (xChId < ADC_CH_NUM))
+    {
+        xAdcFilter[xChId].bGate = false;
         xRetval = ADC_STATUS_OK;
     }
 
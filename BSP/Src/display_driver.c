@@ -7,6 +7,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <stdbool.h>
+
 #include "display_driver.h"
 #include "i2c_driver.h"
 #include "user_error.h"
@@ -16,6 +18,7 @@
 #ifdef DISPLAY_USE_RTOS
 #include "FreeRTOS.h"
 #include "task.h"
+#include "semphr.h"
 #endif
 
 /* Private includes ----------------------------------------------------------*/
@@ -34,8 +37,37 @@
 /* I2C transfer delay */
 #define I2C_BUSY_DELAY      (0U)
 
+/* I2C transfer buffer len, control byte plus a full page of 128 columns */
+#define I2C_BUFF_LEN        (132U)
+
+/* Number of transfer buffers, one filled while the other is sent */
+#define I2C_BUFF_NUM        (2U)
+
+/* Max wait for previous transfer, ms */
+#define I2C_TX_TIMEOUT      (50U)
+
+/* SSD13xx control bytes */
+#define SSD13XX_CTRL_CMD    (0x00U)
+#define SSD13XX_CTRL_DATA   (0x40U)
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+
+/* Transfer buffers, DMA reads them directly */
+static uint8_t pu8I2cBuffer[I2C_BUFF_NUM][I2C_BUFF_LEN] = { 0U };
+
+/* Buffer being filled and its len */
+static uint8_t u8I2cBufferIdx = 0U;
+static uint16_t u16I2cBufferLen = 0U;
+
+#ifdef DISPLAY_USE_RTOS
+/* Given when no transfer is in flight */
+static SemaphoreHandle_t xI2cTxDone = NULL;
+static StaticSemaphore_t xI2cTxDoneCtrl;
+#else
+/* Transfer in flight */
+static volatile bool bI2cTxBusy = false;
+#endif
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -59,7 +91,29 @@ static void __HardwareDeInit(void);
   */
 static void __LL_Delay(uint32_t u32TickCount);
 
+/**
+  * @brief Wait until previous I2C transfer is done, blocking the caller task.
+  * @param None
+  * @retval None
+  */
+static void __I2cWaitTxDone(void);
+
+/**
+  * @brief Release transfer lock, called from I2C interrupt.
+  * @param None
+  * @retval None
+  */
+static void __I2cTxDoneFromISR(void);
+
+/**
+  * @brief I2C driver event callback.
+  * @param event type of event.
+  * @retval None
+  */
+static void __I2cEventCb(i2c_event_t event);
+
 /* Callbacks required by u8g2 lib */
+uint8_t u8x8_cad_ssd13xx_dma_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_byte_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 uint8_t u8x8_gpio_and_delay(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr);
 
@@ -67,7 +121,7 @@ uint8_t u8x8_gpio_and_delay(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *ar
 
 static void __HardwareInit(void)
 {
-    if (I2C_init(I2C_0, NULL) != I2C_STATUS_OK)
+    if (I2C_init(I2C_0, __I2cEventCb) != I2C_STATUS_OK)
     {
         ERR_ASSERT(0U);
     }
@@ -107,6 +161,44 @@ static void __LL_Delay(uint32_t u32TickCount)
 #endif
 }
 
+static void __I2cWaitTxDone(void)
+{
+#ifdef DISPLAY_USE_RTOS
+    /* Task sleeps while DMA sends previous buffer, on timeout transfer is considered lost */
+    (void)xSemaphoreTake(xI2cTxDone, pdMS_TO_TICKS(I2C_TX_TIMEOUT));
+#else
+    while (bI2cTxBusy)
+    {
+        __LL_Delay(I2C_BUSY_DELAY);
+    }
+    bI2cTxBusy = true;
+#endif
+}
+
+static void __I2cTxDoneFromISR(void)
+{
+#ifdef DISPLAY_USE_RTOS
+    BaseType_t xWakeTask = pdFALSE;
+
+    if (xI2cTxDone != NULL)
+    {
+        xSemaphoreGiveFromISR(xI2cTxDone, &xWakeTask);
+    }
+
+    portYIELD_FROM_ISR(xWakeTask);
+#else
+    bI2cTxBusy = false;
+#endif
+}
+
+static void __I2cEventCb(i2c_event_t event)
+{
+    if ((event == I2C_EVENT_MASTER_TX_DONE) || (event == I2C_EVENT_ERROR))
+    {
+        __I2cTxDoneFromISR();
+    }
+}
+
 /* Public user code ----------------------------------------------------------*/
 
 display_status_t DISPLAY_init(display_port_t dev, u8g2_t * pxDisplayHandler)
@@ -115,13 +207,24 @@ display_status_t DISPLAY_init(display_port_t dev, u8g2_t * pxDisplayHandler)
 
     if (dev == DISPLAY_0)
     {
+        uint8_t u8TileBufHeight = 0U;
+        uint8_t * pu8Buf = NULL;
+
+#ifdef DISPLAY_USE_RTOS
+        xI2cTxDone = xSemaphoreCreateBinaryStatic(&xI2cTxDoneCtrl);
+        ERR_ASSERT(xI2cTxDone);
+        xSemaphoreGive(xI2cTxDone);
+#endif
+
         __HardwareInit();
 
         // Set display I2C addr
         u8g2_SetI2CAddress(pxDisplayHandler, DISPLAY_ADDRESS);
 
-        // Init grapfic library
-        u8g2_Setup_ssd1306_i2c_128x64_noname_f(pxDisplayHandler, U8G2_R0, u8x8_byte_hw_i2c, u8x8_gpio_and_delay);
+        // Init grapfic library, same as u8g2_Setup_ssd1306_i2c_128x64_noname_f with page sized I2C transfers
+        u8g2_SetupDisplay(pxDisplayHandler, u8x8_d_ssd1306_128x64_noname, u8x8_cad_ssd13xx_dma_i2c, u8x8_byte_hw_i2c, u8x8_gpio_and_delay);
+        pu8Buf = u8g2_m_16_8_f(&u8TileBufHeight);
+        u8g2_SetupBuffer(pxDisplayHandler, pu8Buf, u8TileBufHeight, u8g2_ll_hvline_vertical_top_lsb, U8G2_R0);
 
         // Init sequence to display
         u8g2_InitDisplay(pxDisplayHandler);
@@ -152,11 +255,73 @@ display_status_t DISPLAY_deinit(display_port_t dev)
 
 /* Callback ------------------------------------------------------------------*/
 
+uint8_t u8x8_cad_ssd13xx_dma_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
+{
+    /* Based on u8x8_cad_ssd13xx_fast_i2c, data is not split in 24 bytes chunks */
+    static uint8_t u8InTransfer = 0U;
+    uint8_t u8RetVal = 1U;
+
+    switch (msg)
+    {
+        case U8X8_MSG_CAD_SEND_CMD:
+            if (u8InTransfer != 0U)
+            {
+                u8x8_byte_EndTransfer(u8x8);
+            }
+            u8x8_byte_StartTransfer(u8x8);
+            u8x8_byte_SendByte(u8x8, SSD13XX_CTRL_CMD);
+            u8x8_byte_SendByte(u8x8, arg_int);
+            u8InTransfer = 1U;
+            break;
+
+        case U8X8_MSG_CAD_SEND_ARG:
+            u8x8_byte_SendByte(u8x8, arg_int);
+            break;
+
+        case U8X8_MSG_CAD_SEND_DATA:
+            if (u8InTransfer != 0U)
+            {
+                u8x8_byte_EndTransfer(u8x8);
+            }
+            /* Whole tile row on a single transfer */
+            u8x8_byte_StartTransfer(u8x8);
+            u8x8_byte_SendByte(u8x8, SSD13XX_CTRL_DATA);
+            u8x8_byte_SendBytes(u8x8, arg_int, (uint8_t *)arg_ptr);
+            u8x8_byte_EndTransfer(u8x8);
+            u8InTransfer = 0U;
+            break;
+
+        case U8X8_MSG_CAD_INIT:
+            /* Apply default address if required, setup resets it */
+            if (u8x8->i2c_address == 255U)
+            {
+                u8x8->i2c_address = DISPLAY_ADDRESS;
+            }
+            u8RetVal = u8x8->byte_cb(u8x8, msg, arg_int, arg_ptr);
+            break;
+
+        case U8X8_MSG_CAD_START_TRANSFER:
+            u8InTransfer = 0U;
+            break;
+
+        case U8X8_MSG_CAD_END_TRANSFER:
+            if (u8InTransfer != 0U)
+            {
+                u8x8_byte_EndTransfer(u8x8);
+            }
+            u8InTransfer = 0U;
+            break;
+
+        default:
+            u8RetVal = 0U;
+            break;
+    }
+
+    return u8RetVal;
+}
+
 uint8_t u8x8_byte_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_ptr)
 {
-    /* u8g2/u8x8 will never send more than 32 bytes between START_TRANSFER and END_TRANSFER */
-    static uint8_t u8Buffer[32U];
-    static uint8_t u8BufIdx = 0U;
     uint8_t *pu8Data;
     uint8_t u8RetVal = 1U;
 
@@ -164,9 +329,10 @@ uint8_t u8x8_byte_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_p
     {
         case U8X8_MSG_BYTE_SEND:
             pu8Data = (uint8_t *)arg_ptr;
+            ERR_ASSERT((u16I2cBufferLen + arg_int) <= I2C_BUFF_LEN);
             while(arg_int > 0)
             {
-                u8Buffer[u8BufIdx++] = *pu8Data;
+                pu8I2cBuffer[u8I2cBufferIdx][u16I2cBufferLen++] = *pu8Data;
                 pu8Data++;
                 arg_int--;
             }
@@ -179,16 +345,34 @@ uint8_t u8x8_byte_hw_i2c(u8x8_t *u8x8, uint8_t msg, uint8_t arg_int, void *arg_p
             break;
 
         case U8X8_MSG_BYTE_START_TRANSFER:
-            u8BufIdx = 0;
+            u16I2cBufferLen = 0U;
             break;
 
         case U8X8_MSG_BYTE_END_TRANSFER:
             {
                 uint16_t u16DevAddr = u8g2_GetI2CAddress(u8x8);
-                while (I2C_master_send(DISPLAY_I2C, u16DevAddr, u8Buffer, u8BufIdx) != I2C_STATUS_OK)
+                i2c_status_t eStatus = I2C_STATUS_BUSY;
+
+                /* Previous buffer must be sent before starting the new one */
+                __I2cWaitTxDone();
+
+                while ((eStatus = I2C_master_send_dma(DISPLAY_I2C, u16DevAddr, pu8I2cBuffer[u8I2cBufferIdx], u16I2cBufferLen)) == I2C_STATUS_BUSY)
                 {
                     __LL_Delay(I2C_BUSY_DELAY);
                 }
+
+                if (eStatus != I2C_STATUS_OK)
+                {
+                    /* Nothing in flight, release lock */
+#ifdef DISPLAY_USE_RTOS
+                    xSemaphoreGive(xI2cTxDone);
+#else
+                    bI2cTxBusy = false;
+#endif
+                }
+
+                /* Fill the other buffer while this one is sent */
+                u8I2cBufferIdx = (u8I2cBufferIdx + 1U) % I2C_BUFF_NUM;
             }
             break;
 
@@ -26,6 +26,15 @@ volatile uint32_t u32Encoder0Cnt = 0U;
 volatile uint32_t u32Encoder0EcTick = 0U;
 volatile uint32_t u32Encoder0SwTick = 0U;
 
+/* Net steps not yet consumed, positive is CW */
+volatile int32_t i32Encoder0Delta = 0;
+
+/* Counts not reaching a full step */
+volatile int32_t i32Encoder0Partial = 0;
+
+/* Time between the last two steps */
+volatile uint32_t u32Encoder0StepPeriod = UINT32_MAX;
+
 /* Callback handler */
 static encoder_event_cb encoder_0_event_cb = NULL;
 
@@ -118,6 +127,7 @@ static void __enc_0_low_level_init(void)
 
     /* Init encoder */
     (&htim3)->Instance->CNT = ENCODER_0_REF_VALUE;
+    u32Encoder0Cnt = ENCODER_0_REF_VALUE;
 }
 
 static void __enc_0_low_level_deinit(void)
@@ -169,6 +179,31 @@ encoder_status_t ENCODER_getCount(encoder_id_t xDevId, uint32_t * pu32Count)
     return retval;
 }
 
+encoder_status_t ENCODER_getDelta(encoder_id_t xDevId, int32_t * pi32Delta, uint32_t * pu32StepPeriod)
+{
+    encoder_status_t retval = ENCODER_STATUS_NOTDEF;
+
+    if ((xDevId == ENCODER_ID_0) && (pi32Delta != NULL))
+    {
+        uint32_t u32PriMask = __get_PRIMASK();
+        __disable_irq();
+
+        *pi32Delta = i32Encoder0Delta;
+        i32Encoder0Delta = 0;
+
+        if (pu32StepPeriod != NULL)
+        {
+            *pu32StepPeriod = u32Encoder0StepPeriod;
+        }
+
+        __set_PRIMASK(u32PriMask);
+
+        retval = ENCODER_STATUS_OK;
+    }
+
+    return retval;
+}
+
 encoder_sw_state_t ENCODER_getSwState(encoder_id_t xDevId)
 {
     encoder_sw_state_t xSwitchState = ENCODER_SW_NOTDEF;
@@ -207,35 +242,42 @@ void ENCODER_irqEncHandler(encoder_id_t xDevId, uint32_t u32IrqCount)
     {
         uint32_t u32EventTick = __enc_0_low_level_get_time();
 
-        /* Filter event by time */
-        if ((u32EventTick - u32Encoder0EcTick) > ENCODER_0_TICK_CNT_GUARD_EC)
-        {
-            uint32_t u32EncEvent = ENCODER_0_VALUE_NONE;
+        /* Count decreases on CW rotation */
+        int32_t i32Counts = i32Encoder0Partial + ((int32_t)u32Encoder0Cnt - (int32_t)u32IrqCount);
+        int32_t i32Steps = i32Counts / (int32_t)ENCODER_0_CNT_PER_STEP;
+
+        u32Encoder0Cnt = u32IrqCount;
+        i32Encoder0Partial = i32Counts - (i32Steps * (int32_t)ENCODER_0_CNT_PER_STEP);
 
-            /* Check encoder direction and generate event */
-            if ((u32IrqCount > u32Encoder0Cnt) || (u32IrqCount == ENCODER_0_CNT_MAX))
+        /* Counter clamped on range limits, keep reporting movement direction */
+        if ((i32Steps == 0) && (i32Encoder0Partial == 0))
+        {
+            if (u32IrqCount == ENCODER_0_CNT_MAX)
             {
-                u32EncEvent = ENCODER_0_VALUE_CCW;
+                i32Steps = -1;
             }
-            else if ((u32IrqCount < u32Encoder0Cnt) || (u32IrqCount == ENCODER_0_CNT_MIN))
+            else if (u32IrqCount == ENCODER_0_CNT_MIN)
             {
-                u32EncEvent = ENCODER_0_VALUE_CW;
+                i32Steps = 1;
             }
+        }
 
-            if (u32EncEvent != ENCODER_0_VALUE_NONE)
-            {
-                /* Update internal CNT value */
-                u32Encoder0Cnt = u32IrqCount;
+        if (i32Steps != 0)
+        {
+            uint32_t u32EncEvent = (i32Steps > 0) ? ENCODER_0_VALUE_CW : ENCODER_0_VALUE_CCW;
 
-                /* Report event */
-                if (encoder_0_event_cb != NULL)
-                {
-                    encoder_0_event_cb(ENCODER_EVENT_UPDATE, u32EncEvent);
-                }
+            /* Accumulate until consumed, several steps may arrive between reads */
+            i32Encoder0Delta += i32Steps;
+            u32Encoder0StepPeriod = (u32EventTick - u32Encoder0EcTick) / (uint32_t)((i32Steps > 0) ? i32Steps : -i32Steps);
 
-                /* Register tick event */
-                u32Encoder0EcTick = u32EventTick;
+            /* Report event */
+            if (encoder_0_event_cb != NULL)
+            {
+                encoder_0_event_cb(ENCODER_EVENT_UPDATE, u32EncEvent);
             }
+
+            /* Register tick event */
+            u32Encoder0EcTick = u32EventTick;
         }
     }
 }
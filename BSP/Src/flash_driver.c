@@ -8,12 +8,120 @@
 /* Includes -----------------------------------------------------------------*/
 
 #include "flash_driver.h"
+#include "sys_mcu.h"
 
 /* Private defines ----------------------------------------------------------*/
 /* Private constants  -------------------------------------------------------*/
 /* Private variables --------------------------------------------------------*/
+
 /* Private functions definitions --------------------------------------------*/
+
+/**
+  * @brief  Erase a page, runs from RAM while flash is busy.
+  * @param  u32PageNumber Number of flash page to erase.
+  * @retval Operation status.
+  */
+static RAM_FUNC flash_status_t _flash_erase_page(uint32_t u32PageNumber);
+
+/**
+  * @brief  Program a double word, runs from RAM while flash is busy.
+  * @param  u32Addr Address where store data, double word aligned.
+  * @param  u64Data Data to store.
+  * @retval Operation status.
+  */
+static RAM_FUNC flash_status_t _flash_program(uint32_t u32Addr, uint64_t u64Data);
+
+/**
+  * @brief  Unlock control register and clear previous errors.
+  * @retval None.
+  */
+static RAM_FUNC void _flash_unlock(void);
+
+/**
+  * @brief  Wait end of operation and lock control register.
+  * @retval Operation status.
+  */
+static RAM_FUNC flash_status_t _flash_wait_and_lock(void);
+
+/**
+  * @brief  Reset instruction cache, may hold lines of an erased page.
+  * @retval None.
+  */
+static void _flash_flush_cache(void);
+
 /* Private functions declaration --------------------------------------------*/
+
+static RAM_FUNC void _flash_unlock(void)
+{
+    /* Previous operation still running */
+    while ((FLASH->SR & FLASH_SR_BSY1) != 0U)
+    {
+    }
+
+    if ((FLASH->CR & FLASH_CR_LOCK) != 0U)
+    {
+        FLASH->KEYR = FLASH_KEY1;
+        FLASH->KEYR = FLASH_KEY2;
+    }
+
+    FLASH->SR = FLASH_FLAG_SR_CLEAR;
+}
+
+static RAM_FUNC flash_status_t _flash_wait_and_lock(void)
+{
+    flash_status_t xRetVal = FLASH_DRIVER_OK;
+
+    /* No code is fetched from flash while it is busy */
+    while ((FLASH->SR & (FLASH_SR_BSY1 | FLASH_SR_CFGBSY)) != 0U)
+    {
+    }
+
+    if ((FLASH->SR & FLASH_FLAG_SR_ERROR) != 0U)
+    {
+        xRetVal = FLASH_DRIVER_ERROR;
+    }
+
+    FLASH->SR = FLASH_FLAG_SR_CLEAR;
+    FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PNB | FLASH_CR_PG);
+    FLASH->CR |= FLASH_CR_LOCK;
+
+    return xRetVal;
+}
+
+static RAM_FUNC flash_status_t _flash_erase_page(uint32_t u32PageNumber)
+{
+    _flash_unlock();
+
+    FLASH->CR = (FLASH->CR & ~FLASH_CR_PNB) | (u32PageNumber << FLASH_CR_PNB_Pos) | FLASH_CR_PER;
+    FLASH->CR |= FLASH_CR_STRT;
+
+    return _flash_wait_and_lock();
+}
+
+static RAM_FUNC flash_status_t _flash_program(uint32_t u32Addr, uint64_t u64Data)
+{
+    _flash_unlock();
+
+    FLASH->CR |= FLASH_CR_PG;
+
+    /* Both words back to back, program starts on second one */
+    *(volatile uint32_t *)u32Addr = (uint32_t)u64Data;
+    __ISB();
+    *(volatile uint32_t *)(u32Addr + 4U) = (uint32_t)(u64Data >> 32U);
+
+    return _flash_wait_and_lock();
+}
+
+static void _flash_flush_cache(void)
+{
+    if ((FLASH->ACR & FLASH_ACR_ICEN) != 0U)
+    {
+        __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+        __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+        __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+    }
+}
+
 /* HAL callbacks ------------------------------------------------------------*/
 /* Exported functions -------------------------------------------------------*/
 
@@ -27,7 +135,7 @@ flash_status_t xFLASH_init(void)
     return xRetVal;
 }
 
-flash_status_t xFLASH_deini(void)
+flash_status_t xFLASH_deinit(void)
 {
     flash_status_t xRetVal = FLASH_DRIVER_ERROR;
 
@@ -43,22 +151,8 @@ flash_status_t xFLASH_ErasePage(uint32_t u32PageNumber)
 
     if (u32PageNumber < FLASH_PAGE_NB)
     {
-        uint32_t u32PageError = 0;
-
-        HAL_FLASH_Unlock();
-
-        /* Fill EraseInit structure*/
-        FLASH_EraseInitTypeDef EraseInitStruct = {0};
-        EraseInitStruct.TypeErase = FLASH_TYPEERASE_PAGES;
-        EraseInitStruct.Page = u32PageNumber;
-        EraseInitStruct.NbPages = 1;
-
-        if (HAL_FLASHEx_Erase(&EraseInitStruct, &u32PageError) == HAL_OK)
-        {
-            xRetVal = FLASH_DRIVER_OK;
-        }
-
-        HAL_FLASH_Lock();
+        xRetVal = _flash_erase_page(u32PageNumber);
+        _flash_flush_cache();
     }
 
     return xRetVal;
@@ -68,15 +162,11 @@ flash_status_t xFLASH_WriteDoubleWord(uint32_t u32Addr, uint64_t u64Data)
 {
     flash_status_t xRetVal = FLASH_DRIVER_ERROR;
 
-    HAL_FLASH_Unlock();
-
-    if (HAL_OK == HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, u32Addr, u64Data))
+    if (((u32Addr % sizeof(uint64_t)) == 0U) && (u32Addr >= FLASH_BASE) && (u32Addr < (FLASH_BASE + (FLASH_PAGE_NB * FLASH_PAGE_SIZE))))
     {
-        xRetVal = FLASH_DRIVER_OK;
+        xRetVal = _flash_program(u32Addr, u64Data);
     }
 
-    HAL_FLASH_Lock();
-
     return xRetVal;
 }
 
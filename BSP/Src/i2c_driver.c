@@ -218,6 +218,35 @@ i2c_status_t I2C_master_send(i2c_port_t dev, uint16_t i2c_addr, uint8_t *pdata,
     return xRetval;
 }
 
+i2c_status_t I2C_master_send_dma(i2c_port_t dev, uint16_t i2c_addr, uint8_t *pdata, uint16_t len)
+{
+    ERR_ASSERT(pdata != NULL);
+
+    i2c_status_t xRetval = I2C_STATUS_NOTDEF;
+
+    if (dev == I2C_0)
+    {
+        if (HAL_I2C_GetState(&hi2c1) == HAL_I2C_STATE_READY)
+        {
+            /* Send data */
+            if (HAL_I2C_Master_Transmit_DMA(&hi2c1, i2c_addr, pdata, len) != HAL_OK)
+            {
+                xRetval = I2C_STATUS_ERROR;
+            }
+            else
+            {
+                xRetval = I2C_STATUS_OK;
+            }
+        }
+        else
+        {
+            xRetval = I2C_STATUS_BUSY;
+        }
+    }
+
+    return xRetval;
+}
+
 i2c_status_t I2C_master_read(i2c_port_t dev, uint16_t i2c_addr, uint8_t *pdata, uint16_t len)
 {
     ERR_ASSERT(pdata != NULL);
@@ -7,8 +7,10 @@
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "serial_driver.h"
-#include "circular_buffer.h"
+#include "spsc_ring.h"
 #include "user_error.h"
 
 /* Private includes ----------------------------------------------------------*/
@@ -19,10 +21,15 @@ typedef struct SerialDevHandler
 {
     serial_port_t xSerialId;
     UART_HandleTypeDef *pxHalPeriphHandler;
-    circular_buf_t *pxAppCircularBuffer;
+    spsc_ring_t *pxAppRing;
     uint8_t *pu8LowLevelBuffer;
     uint32_t u32LowLevelBufferSize;
     uint32_t u32LowLevelBufferPos;
+    volatile uint32_t u32RxHead;
+    uint32_t u32RxTail;
+    uint32_t u32RxHighWater;
+    uint32_t u32RxDropCount;
+    uint32_t u32RxOverrunCount;
     serial_event_cb pxEventCb;
 } SerialDevHandler_t;
 
@@ -34,19 +41,10 @@ typedef struct SerialDevHandler
 UART_HandleTypeDef huart2;
 DMA_HandleTypeDef hdma_usart2_rx;
 static uint8_t rx_buf_uart2[SERIAL_0_RX_SIZE] = {0};
-static uint8_t rx_cbuf_uart2[SERIAL_0_CBUF_SIZE] = {0};
-static circular_buf_t cbuff_uart2 = {
-    .buffer = rx_cbuf_uart2,
-    .head = 0U,
-    .tail = 0U,
-    .max = SERIAL_0_CBUF_SIZE,
-    .full = false,
-};
-
 static SerialDevHandler_t xSerial0Handler = {
     .xSerialId = SERIAL_0,
     .pxHalPeriphHandler = &huart2,
-    .pxAppCircularBuffer = &cbuff_uart2,
+    .pxAppRing = NULL,
     .pu8LowLevelBuffer = rx_buf_uart2,
     .u32LowLevelBufferSize = SERIAL_0_RX_SIZE,
     .pxEventCb = NULL
@@ -58,18 +56,18 @@ DMA_HandleTypeDef hdma_usart4_tx;
 DMA_HandleTypeDef hdma_usart4_rx;
 static uint8_t rx_buf_uart4[SERIAL_1_RX_SIZE] = {0};
 static uint8_t rx_cbuf_uart4[SERIAL_1_CBUF_SIZE] = {0};
-static circular_buf_t cbuff_uart4 = {
+static spsc_ring_t ring_uart4 = {
     .buffer = rx_cbuf_uart4,
+    .mask = SERIAL_1_CBUF_SIZE - 1U,
     .head = 0U,
     .tail = 0U,
-    .max = SERIAL_1_CBUF_SIZE,
-    .full = false,
+    .high_water = 0U,
 };
 
 static SerialDevHandler_t xSerial1Handler = {
     .xSerialId = SERIAL_1,
     .pxHalPeriphHandler = &huart4,
-    .pxAppCircularBuffer = &cbuff_uart4,
+    .pxAppRing = &ring_uart4,
     .pu8LowLevelBuffer = rx_buf_uart4,
     .u32LowLevelBufferSize = SERIAL_1_RX_SIZE,
     .pxEventCb = NULL
@@ -83,6 +81,11 @@ static void BSP_DeInit_Serial_0(void);
 static void BSP_Init_Serial_1(void);
 static void BSP_DeInit_Serial_1(void);
 
+static void vSerialResetRxSpan(SerialDevHandler_t * pxSerialHandler);
+static void vSerialRestartRxSpan(SerialDevHandler_t * pxSerialHandler);
+static uint32_t u32SerialGetRxHead(SerialDevHandler_t * pxSerialHandler);
+static SerialDevHandler_t * pxSerialGetRxHandler(serial_port_t dev);
+
 /* Private function prototypes -----------------------------------------------*/
 
 /**
@@ -131,7 +134,10 @@ static void BSP_Init_Serial_1(void)
     }
 
     /* Init additional resurces */
-    circular_buf_init(&cbuff_uart4, rx_cbuf_uart4, SERIAL_1_CBUF_SIZE);
+    if (!spsc_ring_init(&ring_uart4, rx_cbuf_uart4, SERIAL_1_CBUF_SIZE))
+    {
+        ERR_ASSERT(0U);
+    }
 
     /* Enable idle irq */
     __HAL_UART_ENABLE_IT(&huart4, UART_IT_IDLE);
@@ -151,7 +157,7 @@ static void BSP_DeInit_Serial_1(void)
     }
 
     /* Init additional resurces */
-    circular_buf_free(&cbuff_uart4);
+    spsc_ring_reset(&ring_uart4);
 
     /* Disable idle irq */
     __HAL_UART_DISABLE_IT(&huart4, UART_IT_IDLE);
@@ -176,8 +182,8 @@ static void BSP_Init_Serial_0(void)
         ERR_ASSERT(0U);
     }
 
-    /* Init additional resurces */
-    circular_buf_init(&cbuff_uart2, rx_cbuf_uart2, SERIAL_0_CBUF_SIZE);
+    /* Init additional resurces, rx is read in place from DMA buffer */
+    vSerialResetRxSpan(&xSerial0Handler);
 
     /* Enable idle irq */
     __HAL_UART_ENABLE_IT(&huart2, UART_IT_IDLE);
@@ -192,12 +198,79 @@ static void BSP_DeInit_Serial_0(void)
     }
 
     /* Init additional resurces */
-    circular_buf_free(&cbuff_uart2);
+    vSerialResetRxSpan(&xSerial0Handler);
 
     /* Disable idle irq */
     __HAL_UART_DISABLE_IT(&huart2, UART_IT_IDLE);
 }
 
+/**
+  * @brief Reset read and write counters used on DMA span mode.
+  * @param pxSerialHandler serial handler to reset.
+  * @retval None
+  */
+static void vSerialResetRxSpan(SerialDevHandler_t * pxSerialHandler)
+{
+    ERR_ASSERT((pxSerialHandler->u32LowLevelBufferSize & (pxSerialHandler->u32LowLevelBufferSize - 1U)) == 0U);
+
+    pxSerialHandler->u32RxHead = 0U;
+    pxSerialHandler->u32RxTail = 0U;
+    pxSerialHandler->u32RxHighWater = 0U;
+    pxSerialHandler->u32RxDropCount = 0U;
+    pxSerialHandler->u32RxOverrunCount = 0U;
+}
+
+/**
+  * @brief Move write counter after a DMA restart, reader sees a lap and drops pending data.
+  * @param pxSerialHandler serial handler to restart.
+  * @retval None
+  */
+static void vSerialRestartRxSpan(SerialDevHandler_t * pxSerialHandler)
+{
+    if (pxSerialHandler->pxAppRing == NULL)
+    {
+        uint32_t u32Size = pxSerialHandler->u32LowLevelBufferSize;
+
+        pxSerialHandler->u32RxHead = (pxSerialHandler->u32RxHead | (u32Size - 1U)) + 1U + u32Size;
+    }
+}
+
+/**
+  * @brief Get write counter at current DMA position, u32RxHead only moves on HT/TC/IDLE events.
+  * @param pxSerialHandler serial handler on span mode.
+  * @retval live write counter.
+  */
+static uint32_t u32SerialGetRxHead(SerialDevHandler_t * pxSerialHandler)
+{
+    uint32_t u32Size = pxSerialHandler->u32LowLevelBufferSize;
+    uint32_t u32Head = pxSerialHandler->u32RxHead;
+    uint32_t u32Pos = u32Size - __HAL_DMA_GET_COUNTER(pxSerialHandler->pxHalPeriphHandler->hdmarx);
+
+    /* Published counter is always at last event DMA position, add bytes written since then */
+    return u32Head + ((u32Pos - u32Head) & (u32Size - 1U));
+}
+
+/**
+  * @brief Get handler of a serial port with rx enabled.
+  * @param dev serial interface number.
+  * @retval serial handler, NULL if not valid.
+  */
+static SerialDevHandler_t * pxSerialGetRxHandler(serial_port_t dev)
+{
+    SerialDevHandler_t * pxSerialHandler = NULL;
+
+    if (dev == SERIAL_0)
+    {
+        pxSerialHandler = &xSerial0Handler;
+    }
+    else if (dev == SERIAL_1)
+    {
+        pxSerialHandler = &xSerial1Handler;
+    }
+
+    return pxSerialHandler;
+}
+
 /* Callback ------------------------------------------------------------------*/
 
 void HAL_UART_HandleRxEvent(UART_HandleTypeDef *huart)
@@ -221,31 +294,48 @@ void HAL_UART_HandleRxEvent(UART_HandleTypeDef *huart)
         /* Detect change on buffer */
         if (u32CurrentPos != pxSerialHandler->u32LowLevelBufferPos)
         {
-            uint32_t u32RxData = 0U;
-
-            /* Case without overflow in circular buffer */
-            if (u32CurrentPos > pxSerialHandler->u32LowLevelBufferPos)
+            if (pxSerialHandler->pxAppRing == NULL)
             {
-                u32RxData = u32CurrentPos - pxSerialHandler->u32LowLevelBufferPos;
-                while (u32RxData-- != 0U)
+                /* Span mode, only publish new write position, data is read in place */
+                if (u32CurrentPos > pxSerialHandler->u32LowLevelBufferPos)
                 {
-                    circular_buf_put2(pxSerialHandler->pxAppCircularBuffer, *pdata++);
+                    pxSerialHandler->u32RxHead += u32CurrentPos - pxSerialHandler->u32LowLevelBufferPos;
+                }
+                else
+                {
+                    pxSerialHandler->u32RxHead += pxSerialHandler->u32LowLevelBufferSize - pxSerialHandler->u32LowLevelBufferPos + u32CurrentPos;
                 }
             }
             else
             {
-                /* Case with overflow in circular buffer */
-                u32RxData = pxSerialHandler->u32LowLevelBufferSize - pxSerialHandler->u32LowLevelBufferPos;
-                while (u32RxData-- != 0U)
+                uint32_t u32RxData = 0U;
+                uint32_t u32Stored = 0U;
+
+                /* Case without overflow in circular buffer */
+                if (u32CurrentPos > pxSerialHandler->u32LowLevelBufferPos)
                 {
-                    circular_buf_put2(pxSerialHandler->pxAppCircularBuffer, *pdata++);
+                    u32RxData = u32CurrentPos - pxSerialHandler->u32LowLevelBufferPos;
+                    u32Stored = spsc_ring_push(pxSerialHandler->pxAppRing, pdata, u32RxData);
                 }
+                else
+                {
+                    /* Case with overflow in circular buffer */
+                    u32RxData = pxSerialHandler->u32LowLevelBufferSize - pxSerialHandler->u32LowLevelBufferPos;
+                    u32Stored = spsc_ring_push(pxSerialHandler->pxAppRing, pdata, u32RxData);
 
-                pdata = pxSerialHandler->pu8LowLevelBuffer;
-                u32RxData = u32CurrentPos;
-                while (u32RxData-- != 0U)
+                    u32RxData += u32CurrentPos;
+                    u32Stored += spsc_ring_push(pxSerialHandler->pxAppRing, pxSerialHandler->pu8LowLevelBuffer, u32CurrentPos);
+                }
+
+                /* Ring full, new data is dropped and reader is notified */
+                if (u32Stored != u32RxData)
                 {
-                    circular_buf_put2(pxSerialHandler->pxAppCircularBuffer, *pdata++);
+                    pxSerialHandler->u32RxDropCount += u32RxData - u32Stored;
+
+                    if (pxSerialHandler->pxEventCb != NULL)
+                    {
+                        pxSerialHandler->pxEventCb(SERIAL_EVENT_RX_BUF_FULL);
+                    }
                 }
             }
 
@@ -325,6 +415,7 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
         }
 
         pxSerialHandler->u32LowLevelBufferPos = 0U;
+        vSerialRestartRxSpan(pxSerialHandler);
         HAL_UART_Receive_DMA(huart,
                             pxSerialHandler->pu8LowLevelBuffer,
                             pxSerialHandler->u32LowLevelBufferSize);
@@ -347,6 +438,7 @@ void HAL_UART_AbortCpltCallback(UART_HandleTypeDef *huart)
     if (pxSerialHandler != NULL)
     {
         pxSerialHandler->u32LowLevelBufferPos = 0U;
+        vSerialRestartRxSpan(pxSerialHandler);
         HAL_UART_Receive_DMA(huart,
                             pxSerialHandler->pu8LowLevelBuffer,
                             pxSerialHandler->u32LowLevelBufferSize);
@@ -458,28 +550,37 @@ uint16_t SERIAL_read(serial_port_t dev, uint8_t *pdata, uint16_t max_len)
     ERR_ASSERT(pdata != NULL);
 
     uint16_t n_read = 0;
-    SerialDevHandler_t * pxSerialHandler = NULL;
-
-    if (dev == SERIAL_0)
-    {
-        pxSerialHandler = &xSerial0Handler;
-    }
-    else if (dev == SERIAL_1)
-    {
-        pxSerialHandler = &xSerial1Handler;
-    }
+    SerialDevHandler_t * pxSerialHandler = pxSerialGetRxHandler(dev);
 
     if (pxSerialHandler != NULL)
     {
-        for (uint32_t i_data = 0; i_data < max_len; i_data++)
+        if (pxSerialHandler->pxAppRing != NULL)
+        {
+            n_read = (uint16_t)spsc_ring_pop(pxSerialHandler->pxAppRing, pdata, max_len);
+        }
+        else
         {
-            if (circular_buf_get(pxSerialHandler->pxAppCircularBuffer, pdata + i_data) == 0)
+            /* Span mode, copy out of DMA buffer */
+            serial_span_t spans[SERIAL_RX_SPAN_MAX];
+            uint8_t n_span = SERIAL_get_rx_spans(dev, spans);
+
+            for (uint8_t i_span = 0U; (i_span < n_span) && (n_read < max_len); i_span++)
             {
-                n_read++;
+                uint16_t len = spans[i_span].len;
+
+                if (len > (max_len - n_read))
+                {
+                    len = max_len - n_read;
+                }
+
+                memcpy(&pdata[n_read], spans[i_span].data, len);
+                n_read += len;
             }
-            else
+
+            /* Copied data is not valid if DMA lapped the copy */
+            if (SERIAL_release_rx(dev, n_read) != SERIAL_STATUS_OK)
             {
-                break;
+                n_read = 0U;
             }
         }
     }
@@ -490,23 +591,130 @@ uint16_t SERIAL_read(serial_port_t dev, uint8_t *pdata, uint16_t max_len)
 uint16_t SERIAL_get_read_count(serial_port_t dev)
 {
     uint16_t n_read = 0;
-    SerialDevHandler_t * pxSerialHandler = NULL;
+    SerialDevHandler_t * pxSerialHandler = pxSerialGetRxHandler(dev);
 
-    if (dev == SERIAL_0)
+    if (pxSerialHandler != NULL)
     {
-        pxSerialHandler = &xSerial0Handler;
+        if (pxSerialHandler->pxAppRing != NULL)
+        {
+            n_read = (uint16_t)spsc_ring_size(pxSerialHandler->pxAppRing);
+        }
+        else
+        {
+            n_read = (uint16_t)(u32SerialGetRxHead(pxSerialHandler) - pxSerialHandler->u32RxTail);
+        }
     }
-    else if (dev == SERIAL_1)
+
+    return n_read;
+}
+
+uint8_t SERIAL_get_rx_spans(serial_port_t dev, serial_span_t *spans)
+{
+    ERR_ASSERT(spans != NULL);
+
+    uint8_t n_span = 0U;
+    SerialDevHandler_t * pxSerialHandler = pxSerialGetRxHandler(dev);
+
+    if ((pxSerialHandler != NULL) && (pxSerialHandler->pxAppRing == NULL))
     {
-        pxSerialHandler = &xSerial1Handler;
+        uint32_t u32Size = pxSerialHandler->u32LowLevelBufferSize;
+        uint32_t u32Used = u32SerialGetRxHead(pxSerialHandler) - pxSerialHandler->u32RxTail;
+
+        /* A full buffer is a lap too, DMA next byte goes over the oldest one */
+        if (u32Used >= u32Size)
+        {
+            /* DMA has lapped the reader, pending data is lost */
+            pxSerialHandler->u32RxDropCount += u32Used;
+            pxSerialHandler->u32RxOverrunCount++;
+            pxSerialHandler->u32RxTail += u32Used;
+            u32Used = 0U;
+        }
+
+        if (u32Used > pxSerialHandler->u32RxHighWater)
+        {
+            pxSerialHandler->u32RxHighWater = u32Used;
+        }
+
+        if (u32Used != 0U)
+        {
+            uint32_t u32Pos = pxSerialHandler->u32RxTail & (u32Size - 1U);
+            uint32_t u32First = u32Size - u32Pos;
+
+            if (u32First > u32Used)
+            {
+                u32First = u32Used;
+            }
+
+            spans[0].data = &pxSerialHandler->pu8LowLevelBuffer[u32Pos];
+            spans[0].len = (uint16_t)u32First;
+            n_span = 1U;
+
+            /* Second span on DMA buffer wrap */
+            if (u32Used > u32First)
+            {
+                spans[1].data = pxSerialHandler->pu8LowLevelBuffer;
+                spans[1].len = (uint16_t)(u32Used - u32First);
+                n_span = 2U;
+            }
+        }
     }
 
+    return n_span;
+}
+
+serial_status_t SERIAL_release_rx(serial_port_t dev, uint16_t len)
+{
+    serial_status_t retval = SERIAL_STATUS_ERROR;
+    SerialDevHandler_t * pxSerialHandler = pxSerialGetRxHandler(dev);
+
+    if ((pxSerialHandler != NULL) && (pxSerialHandler->pxAppRing == NULL))
+    {
+        uint32_t u32Used = u32SerialGetRxHead(pxSerialHandler) - pxSerialHandler->u32RxTail;
+
+        ERR_ASSERT(len <= u32Used);
+
+        if (u32Used >= pxSerialHandler->u32LowLevelBufferSize)
+        {
+            /* DMA lapped the reader while spans were read, consumed bytes may be overwritten */
+            pxSerialHandler->u32RxDropCount += u32Used;
+            pxSerialHandler->u32RxOverrunCount++;
+            pxSerialHandler->u32RxTail += u32Used;
+        }
+        else
+        {
+            pxSerialHandler->u32RxTail += len;
+            retval = SERIAL_STATUS_OK;
+        }
+    }
+
+    return retval;
+}
+
+serial_status_t SERIAL_get_rx_stats(serial_port_t dev, serial_rx_stats_t *pstats)
+{
+    ERR_ASSERT(pstats != NULL);
+
+    serial_status_t retval = SERIAL_STATUS_ERROR;
+    SerialDevHandler_t * pxSerialHandler = pxSerialGetRxHandler(dev);
+
     if (pxSerialHandler != NULL)
     {
-        n_read = circular_buf_size(pxSerialHandler->pxAppCircularBuffer);
+        if (pxSerialHandler->pxAppRing != NULL)
+        {
+            pstats->size = (uint16_t)spsc_ring_capacity(pxSerialHandler->pxAppRing);
+            pstats->high_water = (uint16_t)spsc_ring_high_water(pxSerialHandler->pxAppRing);
+        }
+        else
+        {
+            pstats->size = (uint16_t)pxSerialHandler->u32LowLevelBufferSize;
+            pstats->high_water = (uint16_t)pxSerialHandler->u32RxHighWater;
+        }
+        pstats->drop_count = pxSerialHandler->u32RxDropCount;
+        pstats->overrun_count = pxSerialHandler->u32RxOverrunCount;
+        retval = SERIAL_STATUS_OK;
     }
 
-    return n_read;
+    return retval;
 }
 
 /*****END OF FILE****/
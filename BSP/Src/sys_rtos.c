@@ -17,15 +17,36 @@
 #include "task.h"
 
 /* Private variables --------------------------------------------------------*/
+
+/* Idle and timer service task memory */
+static StaticTask_t xIdleTaskTcb;
+static StackType_t pxIdleTaskStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t xTimerTaskTcb;
+static StackType_t pxTimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+
+/* Run time stats clock, 16 bit timer extended on tick hook */
+static volatile uint32_t u32StatsBase = 0U;
+static volatile uint16_t u16StatsLast = 0U;
+
 /* Private macro -----------------------------------------------------------*/
 /* Private defines -----------------------------------------------------------*/
+
+/* Spare timer used as run time stats clock */
+#define RTOS_STATS_TIM                  TIM6
+#define RTOS_STATS_TIM_CLK_ENABLE       __HAL_RCC_TIM6_CLK_ENABLE
 /* Private declarations -----------------------------------------------------*/
 /* Private definitions ------------------------------------------------------*/
 /* RTOS app hook ------------------------------------------------------------*/
 
 void vApplicationTickHook(void)
 {
+    uint16_t u16Count = (uint16_t)RTOS_STATS_TIM->CNT;
+
     HAL_IncTick();
+
+    /* Timer wraps every 655 ms, extend it before it does */
+    u32StatsBase += (uint16_t)(u16Count - u16StatsLast);
+    u16StatsLast = u16Count;
 }
 
 void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
@@ -33,6 +54,118 @@ void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
     ERR_ASSERT(0U);
 }
 
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTcb;
+    *ppxIdleTaskStackBuffer = pxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTcb;
+    *ppxTimerTaskStackBuffer = pxTimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
 /* Public functions ---------------------------------------------------------*/
 
+uint32_t u32RtosGetTimeUs(void)
+{
+    TickType_t xTick = 0U;
+    uint32_t u32SubTick = 0U;
+
+    /* Read again if tick irq happens between both reads */
+    do
+    {
+        xTick = xTaskGetTickCount();
+        u32SubTick = SysTick->LOAD - SysTick->VAL;
+    } while (xTick != xTaskGetTickCount());
+
+    return (xTick * (1000000U / configTICK_RATE_HZ)) + (u32SubTick / (configCPU_CLOCK_HZ / 1000000U));
+}
+
+uint32_t u32RtosGetCycles(void)
+{
+    uint32_t u32Tick = 0U;
+    uint32_t u32Value = 0U;
+    uint32_t u32Pending = 0U;
+
+    /* Read again if tick irq happens between reads */
+    do
+    {
+        u32Tick = HAL_GetTick();
+        u32Value = SysTick->VAL;
+        u32Pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+    } while (u32Tick != HAL_GetTick());
+
+    /* Counter reloaded but tick irq not served yet */
+    if ((u32Pending != 0U) && (u32Value > (SysTick->LOAD / 2U)))
+    {
+        u32Tick++;
+    }
+
+    return (u32Tick * (SysTick->LOAD + 1U)) + (SysTick->LOAD - u32Value);
+}
+
+void vRtosBenchReset(rtos_bench_t * pxBench)
+{
+    ERR_ASSERT(pxBench != NULL);
+
+    pxBench->u32Min = UINT32_MAX;
+    pxBench->u32Max = 0U;
+    pxBench->u32Sum = 0U;
+    pxBench->u32Count = 0U;
+}
+
+void vRtosBenchAdd(rtos_bench_t * pxBench, uint32_t u32Cycles)
+{
+    ERR_ASSERT(pxBench != NULL);
+
+    if (u32Cycles < pxBench->u32Min)
+    {
+        pxBench->u32Min = u32Cycles;
+    }
+
+    if (u32Cycles > pxBench->u32Max)
+    {
+        pxBench->u32Max = u32Cycles;
+    }
+
+    pxBench->u32Sum += u32Cycles;
+    pxBench->u32Count++;
+}
+
+void vRtosStatsTimerInit(void)
+{
+    RTOS_STATS_TIM_CLK_ENABLE();
+
+    /* Free running up counter, no irq needed */
+    RTOS_STATS_TIM->CR1 = 0U;
+    RTOS_STATS_TIM->PSC = RTOS_STATS_CLOCK_CYCLES - 1U;
+    RTOS_STATS_TIM->ARR = 0xFFFFU;
+    RTOS_STATS_TIM->EGR = TIM_EGR_UG;
+    RTOS_STATS_TIM->CR1 = TIM_CR1_CEN;
+
+    u16StatsLast = (uint16_t)RTOS_STATS_TIM->CNT;
+    u32StatsBase = 0U;
+}
+
+uint32_t u32RtosStatsTimerGet(void)
+{
+    uint32_t u32Base = 0U;
+    uint16_t u16Last = 0U;
+    uint16_t u16Count = 0U;
+
+    /* Read again if tick irq updates the base meanwhile */
+    do
+    {
+        u32Base = u32StatsBase;
+        u16Last = u16StatsLast;
+        u16Count = (uint16_t)RTOS_STATS_TIM->CNT;
+    } while (u32Base != u32StatsBase);
+
+    return u32Base + (uint16_t)(u16Count - u16Last);
+}
+
 /*EOF*/
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ * @file    crash_store.h
+ * @author  Sebastian Del Moral Gallardo.
+ * @brief   Keep crash dumps across reset, RAM record moved to flash on next boot.
+ *
+ */
+
+#ifndef __CRASH_STORE_H
+#define __CRASH_STORE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Exported defines ----------------------------------------------------------*/
+
+/** Valid record mark */
+#define CRASH_STORE_MAGIC               ( 0xC4A5D00DU )
+
+/** Space for CrashCatcher binary dump */
+#define CRASH_STORE_DATA_SIZE           ( 1024U )
+
+/** Task name length kept on record */
+#define CRASH_STORE_NAME_LEN            ( 8U )
+
+/** Bytes of stack dumped above fault stack pointer */
+#define CRASH_STORE_STACK_SIZE          ( 512U )
+
+/** Bytes of current task control block dumped */
+#define CRASH_STORE_TCB_SIZE            ( 96U )
+
+/** Reset after dump, RAM record is moved to flash on next boot */
+#define CRASH_STORE_RESET_ON_END
+
+/* Exported types ------------------------------------------------------------*/
+
+/** Crash record, same layout on RAM and flash */
+typedef struct
+{
+    uint32_t u32Magic;
+    uint32_t u32Crc;                            /* CRC32 of all fields after this one */
+    uint32_t u32Len;                            /* Bytes used on pu8Data */
+    uint32_t u32TcbAddr;                        /* Task running on fault, 0 if none */
+    char pcTaskName[CRASH_STORE_NAME_LEN];
+    uint8_t pu8Data[CRASH_STORE_DATA_SIZE];     /* CrashCatcher dump, same format as hex dump */
+} crash_record_t;
+
+/* Exported functions --------------------------------------------------------*/
+
+/**
+  * @brief  Move a crash record left on RAM by previous run to flash, call on boot.
+  * @retval None.
+  */
+void vCrashStoreInit(void);
+
+/**
+  * @brief  Start a new RAM record, fault context only.
+  * @retval None.
+  */
+void vCrashStoreStart(void);
+
+/**
+  * @brief  Append dump data to RAM record, fault context only.
+  * @param  pu8Data data to append.
+  * @param  u32Len number of bytes.
+  * @retval None.
+  */
+void vCrashStoreAppend(const uint8_t * pu8Data, uint32_t u32Len);
+
+/**
+  * @brief  Close RAM record, fault context only.
+  * @retval None.
+  */
+void vCrashStoreEnd(void);
+
+/**
+  * @brief  Get address of task control block running on fault.
+  * @retval TCB address, 0 if scheduler was not running.
+  */
+uint32_t u32CrashStoreGetTcb(void);
+
+/**
+  * @brief  Get crash record stored on flash.
+  * @retval Pointer to record, NULL if no valid record.
+  */
+const crash_record_t * pxCrashStoreGet(void);
+
+/**
+  * @brief  Erase crash record stored on flash.
+  * @retval true if erased.
+  */
+bool bCrashStoreClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRASH_STORE_H */
+
+/* EOF */
@@ -5,11 +5,23 @@
 #include <CrashCatcher.h>
 #include "sys_ll_serial.h"
 #include "user_error.h"
+#include "crash_store.h"
+
+#include "stm32g0xx.h"
 
 
 /** Disable IRQ */
 #define DISABLE_IRQ()   __asm volatile ( " cpsid i " ::: "memory" )
 
+/** Regions dumped on crash: stack, TCB, ICSR */
+#define CRASH_REGION_NUM        3
+
+/** Top of stack, from linker file */
+extern uint32_t _estack[];
+
+/** Regions dumped on crash, filled on dump start */
+static CrashCatcherMemoryRegion regions[CRASH_REGION_NUM + 1];
+
 static void _uart_init()
 {
     (void)SYS_LL_UartInit(SYS_LL_SERIAL_0);
@@ -39,6 +51,9 @@ static void dumpBytes(const uint8_t* pMemory, size_t elementCount)
     size_t i;
     uint8_t new_line[2] = "\r\n";
 
+    /* Halfwords and words are copied to locals first, so element reads are kept */
+    vCrashStoreAppend(pMemory, elementCount);
+
     for (i = 0 ; i < elementCount ; i++)
     {
         /* Only dump 16 bytes to a single line before introducing a line break. */
@@ -82,8 +97,25 @@ static void dumpWords(const uint32_t* pMemory, size_t elementCount)
    a dump file, prompting the user to begin a crash dump, or whatever makes sense for your scenario. */
 void CrashCatcher_DumpStart(const CrashCatcherInfo* pInfo)
 {
+    uint32_t stackEnd = pInfo->sp + CRASH_STORE_STACK_SIZE;
+    uint32_t tcb;
+    size_t count = 0;
+
     DISABLE_IRQ();
 
+    vCrashStoreStart();
+    tcb = u32CrashStoreGetTcb();
+
+    if (stackEnd > (uint32_t)_estack)
+        stackEnd = (uint32_t)_estack;
+
+    /* Stack above fault, current task control block if any and fault status (no CFSR on M0+) */
+    regions[count++] = (CrashCatcherMemoryRegion){pInfo->sp, stackEnd, CRASH_CATCHER_WORD};
+    if (tcb != 0)
+        regions[count++] = (CrashCatcherMemoryRegion){tcb, tcb + CRASH_STORE_TCB_SIZE, CRASH_CATCHER_WORD};
+    regions[count++] = (CrashCatcherMemoryRegion){(uint32_t)&SCB->ICSR, (uint32_t)&SCB->ICSR + sizeof(uint32_t), CRASH_CATCHER_WORD};
+    regions[count] = (CrashCatcherMemoryRegion){0xFFFFFFFF, 0xFFFFFFFF, CRASH_CATCHER_BYTE};
+
     _uart_init();
 
     uint8_t crash_start_flag[17] = "\r\n\r\n###CRASH###\r\n";
@@ -96,12 +128,7 @@ void CrashCatcher_DumpStart(const CrashCatcherInfo* pInfo)
    If NULL is returned from this function, the core will only dump the registers. */
 const CrashCatcherMemoryRegion* CrashCatcher_GetMemoryRegions(void)
 {
-    // static const CrashCatcherMemoryRegion regions[] ={
-    //     {0x20000000, 0x20000100, CRASH_CATCHER_BYTE}, /* RAM content */
-    //     {0xFFFFFFFF, 0xFFFFFFFF, CRASH_CATCHER_BYTE}
-    // };
-    // return regions;
-    return 0;
+    return regions;
 }
 
 /* Called to dump the next chunk of memory to the dump (this memory may point to register contents which has been copied
@@ -134,6 +161,13 @@ CrashCatcherReturnCodes CrashCatcher_DumpEnd(void)
     uint8_t crash_end_flag[12] = "###END###\r\n";
     _print(crash_end_flag, sizeof(crash_end_flag));
 
+    /* Keep dump on RAM, moved to flash on next boot */
+    vCrashStoreEnd();
+
+#ifdef CRASH_STORE_RESET_ON_END
+    NVIC_SystemReset();
+#endif
+
     for(;;);
 
     return CRASH_CATCHER_EXIT;
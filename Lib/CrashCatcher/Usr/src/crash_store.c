@@ -0,0 +1,155 @@
+/**
+ * @file    crash_store.c
+ * @author  Sebastian Del Moral Gallardo.
+ * @brief   Keep crash dumps across reset, RAM record moved to flash on next boot.
+ *
+ */
+
+/* Includes -----------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "crash_store.h"
+#include "flash_driver.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Private defines ----------------------------------------------------------*/
+
+/** CRC32 parameters, same as zlib crc32 */
+#define CRASH_CRC_INIT          ( 0xFFFFFFFFU )
+#define CRASH_CRC_POLY          ( 0xEDB88320U )
+
+/** Flash page reserved on linker file */
+#define CRASH_FLASH_ADDR        ( (uint32_t)_scrash_store )
+#define CRASH_FLASH_PAGE        ( (CRASH_FLASH_ADDR - FLASH_BASE) / FLASH_PAGE_SIZE )
+
+/** Record size must fit flash page and double word programming */
+_Static_assert((sizeof(crash_record_t) % sizeof(uint64_t)) == 0U, "Crash record must be double word aligned");
+_Static_assert(sizeof(crash_record_t) <= FLASH_PAGE_SIZE, "Crash record must fit a flash page");
+
+/* Private constants  -------------------------------------------------------*/
+
+/** Start of flash page reserved for crash record */
+extern uint32_t _scrash_store[];
+
+/* Private variables --------------------------------------------------------*/
+
+/** Record written on fault, not initialized by startup so it survives reset */
+static crash_record_t xCrashRecord __attribute__((section(".noinit"), aligned(8)));
+
+/* Private functions declaration --------------------------------------------*/
+
+/**
+  * @brief  Compute record CRC.
+  * @param  pxRecord record to check.
+  * @retval CRC32 of record fields after CRC.
+  */
+static uint32_t u32CrashCrc(const crash_record_t * pxRecord);
+
+/**
+  * @brief  Check record mark and CRC.
+  * @param  pxRecord record to check.
+  * @retval true if valid.
+  */
+static bool bCrashValid(const crash_record_t * pxRecord);
+
+/* Private functions definitions --------------------------------------------*/
+
+static uint32_t u32CrashCrc(const crash_record_t * pxRecord)
+{
+    const uint8_t * pu8Data = (const uint8_t *)&pxRecord->u32Len;
+    uint32_t u32Len = sizeof(crash_record_t) - offsetof(crash_record_t, u32Len);
+    uint32_t u32Crc = CRASH_CRC_INIT;
+
+    while (u32Len-- != 0U)
+    {
+        u32Crc ^= *pu8Data++;
+
+        for (uint32_t u32Bit = 0U; u32Bit < 8U; u32Bit++)
+        {
+            u32Crc = (u32Crc >> 1U) ^ ((u32Crc & 1U) ? CRASH_CRC_POLY : 0U);
+        }
+    }
+
+    return ~u32Crc;
+}
+
+static bool bCrashValid(const crash_record_t * pxRecord)
+{
+    return (pxRecord->u32Magic == CRASH_STORE_MAGIC) &&
+           (pxRecord->u32Len <= CRASH_STORE_DATA_SIZE) &&
+           (pxRecord->u32Crc == u32CrashCrc(pxRecord));
+}
+
+/* Exported functions -------------------------------------------------------*/
+
+void vCrashStoreInit(void)
+{
+    if (bCrashValid(&xCrashRecord))
+    {
+        const uint64_t * pu64Src = (const uint64_t *)&xCrashRecord;
+        bool bWritten = (xFLASH_ErasePage(CRASH_FLASH_PAGE) == FLASH_DRIVER_OK);
+
+        for (uint32_t u32Index = 0U; bWritten && (u32Index < (sizeof(crash_record_t) / sizeof(uint64_t))); u32Index++)
+        {
+            bWritten = (xFLASH_WriteDoubleWord(CRASH_FLASH_ADDR + (u32Index * sizeof(uint64_t)), pu64Src[u32Index]) == FLASH_DRIVER_OK);
+        }
+    }
+
+    /* Record consumed, or garbage after power up */
+    xCrashRecord.u32Magic = 0U;
+}
+
+void vCrashStoreStart(void)
+{
+    TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+
+    memset(&xCrashRecord, 0, sizeof(xCrashRecord));
+
+    if (xTask != NULL)
+    {
+        xCrashRecord.u32TcbAddr = (uint32_t)xTask;
+        strncpy(xCrashRecord.pcTaskName, pcTaskGetName(xTask), CRASH_STORE_NAME_LEN - 1U);
+    }
+}
+
+void vCrashStoreAppend(const uint8_t * pu8Data, uint32_t u32Len)
+{
+    uint32_t u32Free = CRASH_STORE_DATA_SIZE - xCrashRecord.u32Len;
+
+    /* Truncate, header and registers go first so they are always kept */
+    if (u32Len > u32Free)
+    {
+        u32Len = u32Free;
+    }
+
+    memcpy(&xCrashRecord.pu8Data[xCrashRecord.u32Len], pu8Data, u32Len);
+    xCrashRecord.u32Len += u32Len;
+}
+
+void vCrashStoreEnd(void)
+{
+    xCrashRecord.u32Crc = u32CrashCrc(&xCrashRecord);
+    xCrashRecord.u32Magic = CRASH_STORE_MAGIC;
+}
+
+uint32_t u32CrashStoreGetTcb(void)
+{
+    return xCrashRecord.u32TcbAddr;
+}
+
+const crash_record_t * pxCrashStoreGet(void)
+{
+    const crash_record_t * pxRecord = (const crash_record_t *)CRASH_FLASH_ADDR;
+
+    return bCrashValid(pxRecord) ? pxRecord : NULL;
+}
+
+bool bCrashStoreClear(void)
+{
+    return (xFLASH_ErasePage(CRASH_FLASH_PAGE) == FLASH_DRIVER_OK);
+}
+
+/* EOF */
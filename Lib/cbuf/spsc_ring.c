@@ -0,0 +1,161 @@
+/**
+  ******************************************************************************
+  * @file           : spsc_ring.c
+  * @brief          : single producer single consumer ring buffer
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
+
+#include "spsc_ring.h"
+
+/* Private define ------------------------------------------------------------*/
+
+/* Keep data copies before index update, single core so compiler barrier is enough */
+#define SPSC_RING_BARRIER()     __asm volatile ("" ::: "memory")
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Public function prototypes -----------------------------------------------*/
+
+bool spsc_ring_init(spsc_ring_t * ring, uint8_t * buffer, uint32_t size)
+{
+    bool retval = false;
+
+    if ((ring != NULL) && (buffer != NULL) && (size != 0U) && ((size & (size - 1U)) == 0U))
+    {
+        ring->buffer = buffer;
+        ring->mask = size - 1U;
+        spsc_ring_reset(ring);
+        retval = true;
+    }
+
+    return retval;
+}
+
+void spsc_ring_reset(spsc_ring_t * ring)
+{
+    ring->head = 0U;
+    ring->tail = 0U;
+    ring->high_water = 0U;
+}
+
+uint32_t spsc_ring_push(spsc_ring_t * ring, const uint8_t * data, uint32_t len)
+{
+    uint32_t head = ring->head;
+    uint32_t used = head - ring->tail;
+    uint32_t space = (ring->mask + 1U) - used;
+
+    if (len > space)
+    {
+        len = space;
+    }
+
+    if (len != 0U)
+    {
+        uint32_t pos = head & ring->mask;
+        uint32_t first = (ring->mask + 1U) - pos;
+
+        /* Copy in two segments on wrap */
+        if (first > len)
+        {
+            first = len;
+        }
+        memcpy(&ring->buffer[pos], data, first);
+        memcpy(ring->buffer, &data[first], len - first);
+
+        SPSC_RING_BARRIER();
+        ring->head = head + len;
+
+        used += len;
+        if (used > ring->high_water)
+        {
+            ring->high_water = used;
+        }
+    }
+
+    return len;
+}
+
+uint32_t spsc_ring_pop(spsc_ring_t * ring, uint8_t * data, uint32_t len)
+{
+    uint32_t tail = ring->tail;
+    uint32_t used = ring->head - tail;
+
+    SPSC_RING_BARRIER();
+
+    if (len > used)
+    {
+        len = used;
+    }
+
+    if (len != 0U)
+    {
+        uint32_t pos = tail & ring->mask;
+        uint32_t first = (ring->mask + 1U) - pos;
+
+        /* Copy out two segments on wrap */
+        if (first > len)
+        {
+            first = len;
+        }
+        memcpy(data, &ring->buffer[pos], first);
+        memcpy(&data[first], ring->buffer, len - first);
+
+        SPSC_RING_BARRIER();
+        ring->tail = tail + len;
+    }
+
+    return len;
+}
+
+uint32_t spsc_ring_peek(const spsc_ring_t * ring, const uint8_t ** data)
+{
+    uint32_t tail = ring->tail;
+    uint32_t used = ring->head - tail;
+    uint32_t pos = tail & ring->mask;
+    uint32_t first = (ring->mask + 1U) - pos;
+
+    SPSC_RING_BARRIER();
+
+    *data = &ring->buffer[pos];
+
+    return (used < first) ? used : first;
+}
+
+void spsc_ring_consume(spsc_ring_t * ring, uint32_t len)
+{
+    uint32_t used = ring->head - ring->tail;
+
+    if (len > used)
+    {
+        len = used;
+    }
+
+    SPSC_RING_BARRIER();
+    ring->tail += len;
+}
+
+uint32_t spsc_ring_size(const spsc_ring_t * ring)
+{
+    return ring->head - ring->tail;
+}
+
+uint32_t spsc_ring_free(const spsc_ring_t * ring)
+{
+    return (ring->mask + 1U) - (ring->head - ring->tail);
+}
+
+uint32_t spsc_ring_capacity(const spsc_ring_t * ring)
+{
+    return ring->mask + 1U;
+}
+
+uint32_t spsc_ring_high_water(const spsc_ring_t * ring)
+{
+    return ring->high_water;
+}
+
+/*****END OF FILE****/
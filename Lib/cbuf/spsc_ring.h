@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file           : spsc_ring.h
+  * @brief          : single producer single consumer ring buffer
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/// Ring handler, head is only written by producer and tail only by consumer.
+/// Indexes run free and are masked on access, so no full flag is shared.
+typedef struct spsc_ring_t
+{
+    uint8_t *buffer;
+    uint32_t mask;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t high_water;
+} spsc_ring_t;
+
+/* Public function prototypes -----------------------------------------------*/
+
+/// Pass in a storage buffer and size, size must be a power of two
+/// Returns true if ring has been init, false if size is not valid
+bool spsc_ring_init(spsc_ring_t * ring, uint8_t * buffer, uint32_t size);
+
+/// Reset the ring to empty, only safe with producer stopped
+void spsc_ring_reset(spsc_ring_t * ring);
+
+/// Producer side, copy up to len bytes into the ring
+/// Returns number of bytes stored, lower than len if ring is full
+uint32_t spsc_ring_push(spsc_ring_t * ring, const uint8_t * data, uint32_t len);
+
+/// Consumer side, copy up to len bytes out of the ring
+/// Returns number of bytes read
+uint32_t spsc_ring_pop(spsc_ring_t * ring, uint8_t * data, uint32_t len);
+
+/// Consumer side, get pointer to the oldest contiguous block without copy
+/// Returns block length, data is kept until spsc_ring_consume is called
+uint32_t spsc_ring_peek(const spsc_ring_t * ring, const uint8_t ** data);
+
+/// Consumer side, release len bytes already read with spsc_ring_peek
+void spsc_ring_consume(spsc_ring_t * ring, uint32_t len);
+
+/// Returns the number of bytes stored in the ring
+uint32_t spsc_ring_size(const spsc_ring_t * ring);
+
+/// Returns the number of bytes that can be pushed
+uint32_t spsc_ring_free(const spsc_ring_t * ring);
+
+/// Returns the maximum capacity of the ring
+uint32_t spsc_ring_capacity(const spsc_ring_t * ring);
+
+/// Returns the maximum number of bytes stored since init
+uint32_t spsc_ring_high_water(const spsc_ring_t * ring);
+
+#endif //SPSC_RING_H_
+
+/*****END OF FILE****/
@@ -38,41 +38,61 @@ typedef enum
 #define MIDI_STATUS_GET_CMD(status) (((status)&MIDI_STATUS_CMD_MASK) >> 4)
 
 /* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
 
-/* Cb pointer for handle sys_ex functions */
-midi_cb_msg_sys_ex_t midi_cb_sys_ex = NULL;
-
-/* Cb pointer for handle msg data 1 functions */
-midi_cb_msg_data1_t midi_cb_msg_data_1 = NULL;
-
-/* Cb pointer for handle msg data 2 functions */
-midi_cb_msg_data2_t midi_cb_msg_data_2 = NULL;
+static midiStatus_t state_handler_wait_byte_init(midi_parser_t *parser, uint8_t rx_byte);
+static midiStatus_t state_handler_wait_byte_first_data(midi_parser_t *parser, uint8_t rx_byte);
+static midiStatus_t state_handler_wait_byte_second_data(midi_parser_t *parser, uint8_t rx_byte);
+static midiStatus_t state_handler_wait_byte_sys_ex(midi_parser_t *parser, uint8_t rx_byte);
+static midiStatus_t state_handler_wait_byte_data(midi_parser_t *parser, uint8_t rx_byte);
+static midiStatus_t state_handler_dispatch_status(midi_parser_t *parser, uint8_t rx_byte);
+static midiStatus_t sys_ex_store(midi_parser_t *parser, uint8_t rx_byte);
+static void sys_ex_stream_event(midi_parser_t *parser, midiSysExEvent_t event);
 
-/* Cb pointer for handle msg rt functions */
-midi_cb_msg_rt_t midi_cb_msg_rt = NULL;
+/* Private function ----------------------------------------------------------*/
 
-/* Current system state control var */
-static midi_rx_state_t fsm_rx_state = wait_byte_init;
+static midiStatus_t sys_ex_store(midi_parser_t *parser, uint8_t rx_byte)
+{
+    midiStatus_t retval = midiOk;
 
-/* Tmp var for running status */
-static uint8_t midi_running_status = 0;
-static uint8_t midi_tmp_data_1 = 0;
-static uint8_t midi_tmp_data_2 = 0;
-static uint32_t i_data_sys_ex = 0;
-static uint8_t sys_ex_buff_data[SYS_EX_BUFF_SIZE] = {0};
+    /* Rest of an oversized sysEx is discarded until its end byte */
+    if (parser->sys_ex_overflow != 0)
+    {
+        retval = midiSysExcBuffFull;
+    }
+    else if (parser->cb_sys_ex_stream != NULL)
+    {
+        parser->cb_sys_ex_stream(midiSysExData, rx_byte);
+    }
 
-/* Private function prototypes -----------------------------------------------*/
+    if ((parser->sys_ex_buff != NULL) && (retval == midiOk))
+    {
+        if (parser->sys_ex_len < parser->sys_ex_size)
+        {
+            parser->sys_ex_buff[parser->sys_ex_len++] = rx_byte;
+        }
+        else
+        {
+            parser->sys_ex_len = 0;
+            parser->sys_ex_overflow = 1;
+            parser->sys_ex_drop_count++;
+            sys_ex_stream_event(parser, midiSysExAbort);
+            retval = midiSysExcBuffFull;
+        }
+    }
 
-static midiStatus_t state_handler_wait_byte_init(uint8_t rx_byte);
-static midiStatus_t state_handler_wait_byte_first_data(uint8_t rx_byte);
-static midiStatus_t state_handler_wait_byte_second_data(uint8_t rx_byte);
-static midiStatus_t state_handler_wait_byte_sys_ex(uint8_t rx_byte);
-static midiStatus_t state_handler_wait_byte_data(uint8_t rx_byte);
-static midiStatus_t state_handler_dispatch_status(uint8_t rx_byte);
+    return retval;
+}
 
-/* Private function ----------------------------------------------------------*/
+static void sys_ex_stream_event(midi_parser_t *parser, midiSysExEvent_t event)
+{
+    if (parser->cb_sys_ex_stream != NULL)
+    {
+        parser->cb_sys_ex_stream(event, 0);
+    }
+}
 
-static midiStatus_t state_handler_wait_byte_init(uint8_t rx_byte)
+static midiStatus_t state_handler_wait_byte_init(midi_parser_t *parser, uint8_t rx_byte)
 {
     midiStatus_t retval = midiOk;
 
@@ -80,14 +100,14 @@ static midiStatus_t state_handler_wait_byte_init(uint8_t rx_byte)
     {
         if (MIDI_IS_RT(rx_byte))
         {
-            if (midi_cb_msg_rt != NULL)
+            if (parser->cb_msg_rt != NULL)
             {
-                midi_cb_msg_rt(rx_byte);
+                parser->cb_msg_rt(rx_byte);
             }
         }
         else
         {
-            fsm_rx_state = dispatch_status;
+            parser->rx_state = dispatch_status;
             retval = midiHandleNewState;
         }
     }
@@ -95,7 +115,7 @@ static midiStatus_t state_handler_wait_byte_init(uint8_t rx_byte)
     return retval;
 }
 
-static midiStatus_t state_handler_wait_byte_first_data(uint8_t rx_byte)
+static midiStatus_t state_handler_wait_byte_first_data(midi_parser_t *parser, uint8_t rx_byte)
 {
     midiStatus_t retval = midiOk;
 
@@ -103,27 +123,27 @@ static midiStatus_t state_handler_wait_byte_first_data(uint8_t rx_byte)
     {
         if (MIDI_IS_RT(rx_byte))
         {
-            if (midi_cb_msg_rt != NULL)
+            if (parser->cb_msg_rt != NULL)
             {
-                midi_cb_msg_rt(rx_byte);
+                parser->cb_msg_rt(rx_byte);
             }
         }
         else
         {
-            fsm_rx_state = dispatch_status;
+            parser->rx_state = dispatch_status;
             retval = midiHandleNewState;
         }
     }
     else
     {
-        midi_tmp_data_1 = rx_byte;
-        fsm_rx_state = wait_byte_second_data;
+        parser->tmp_data_1 = rx_byte;
+        parser->rx_state = wait_byte_second_data;
     }
 
     return retval;
 }
 
-static midiStatus_t state_handler_wait_byte_second_data(uint8_t rx_byte)
+static midiStatus_t state_handler_wait_byte_second_data(midi_parser_t *parser, uint8_t rx_byte)
 {
     midiStatus_t retval = midiOk;
 
@@ -131,33 +151,34 @@ static midiStatus_t state_handler_wait_byte_second_data(uint8_t rx_byte)
     {
         if (MIDI_IS_RT(rx_byte))
         {
-            if (midi_cb_msg_rt != NULL)
+            if (parser->cb_msg_rt != NULL)
             {
-                midi_cb_msg_rt(rx_byte);
+                parser->cb_msg_rt(rx_byte);
             }
         }
         else
         {
-            fsm_rx_state = dispatch_status;
+            parser->rx_state = dispatch_status;
             retval = midiHandleNewState;
         }
     }
     else
     {
-        midi_tmp_data_2 = rx_byte;
-        if (midi_cb_msg_data_2 != NULL)
+        parser->tmp_data_2 = rx_byte;
+        if (parser->cb_msg_data_2 != NULL)
         {
-            midi_cb_msg_data_2(midi_running_status, midi_tmp_data_1, midi_tmp_data_2);
+            parser->cb_msg_data_2(parser->running_status, parser->tmp_data_1, parser->tmp_data_2);
         }
-        fsm_rx_state = wait_byte_first_data;
-        midi_tmp_data_1 = 0;
-        midi_tmp_data_2 = 0;
+        parser->rx_state = wait_byte_first_data;
+        parser->tmp_data_1 = 0;
+        parser->tmp_data_2 = 0;
+        parser->msg_open = 0;
     }
 
     return retval;
 }
 
-static midiStatus_t state_handler_wait_byte_sys_ex(uint8_t rx_byte)
+static midiStatus_t state_handler_wait_byte_sys_ex(midi_parser_t *parser, uint8_t rx_byte)
 {
     midiStatus_t retval = midiOk;
 
@@ -165,45 +186,46 @@ static midiStatus_t state_handler_wait_byte_sys_ex(uint8_t rx_byte)
     {
         if (MIDI_IS_RT(rx_byte))
         {
-            if (midi_cb_msg_rt != NULL)
+            if (parser->cb_msg_rt != NULL)
             {
-                midi_cb_msg_rt(rx_byte);
+                parser->cb_msg_rt(rx_byte);
             }
         }
         else
         {
-            if (rx_byte == MIDI_STATUS_SYS_EX_END)
+            if (parser->sys_ex_overflow != 0)
+            {
+                /* Dropped sys_ex, abort already reported */
+                parser->sys_ex_overflow = 0;
+            }
+            else if (rx_byte == MIDI_STATUS_SYS_EX_END)
             {
                 /* Handle end of sys_ex */
-                if (midi_cb_sys_ex != NULL)
+                sys_ex_stream_event(parser, midiSysExEnd);
+                if ((parser->cb_sys_ex != NULL) && (parser->sys_ex_buff != NULL))
                 {
-                    midi_cb_sys_ex(sys_ex_buff_data, i_data_sys_ex);
-                    //i_data_sys_ex = 0;
+                    parser->cb_sys_ex(parser->sys_ex_buff, parser->sys_ex_len);
                 }
             }
-            fsm_rx_state = dispatch_status;
+            else
+            {
+                /* Status byte before end, sys_ex not completed */
+                sys_ex_stream_event(parser, midiSysExAbort);
+            }
+            parser->rx_state = dispatch_status;
             retval = midiHandleNewState;
         }
     }
     else
     {
-        /* Handle data byte for sys_ex */
-        if (i_data_sys_ex < SYS_EX_BUFF_SIZE)
-        {
-            sys_ex_buff_data[i_data_sys_ex++] = rx_byte;
-        }
-        else
-        {
-            i_data_sys_ex = 0;
-            fsm_rx_state = wait_byte_init;
-            retval = midiSysExcBuffFull;
-        }
+        /* Handle data byte for sys_ex, message stays open until its end */
+        (void)sys_ex_store(parser, rx_byte);
     }
 
     return retval;
 }
 
-static midiStatus_t state_handler_wait_byte_data(uint8_t rx_byte)
+static midiStatus_t state_handler_wait_byte_data(midi_parser_t *parser, uint8_t rx_byte)
 {
     midiStatus_t retval = midiOk;
 
@@ -211,29 +233,30 @@ static midiStatus_t state_handler_wait_byte_data(uint8_t rx_byte)
     {
         if (MIDI_IS_RT(rx_byte))
         {
-            if (midi_cb_msg_rt != NULL)
+            if (parser->cb_msg_rt != NULL)
             {
-                midi_cb_msg_rt(rx_byte);
+                parser->cb_msg_rt(rx_byte);
             }
         }
         else
         {
-            fsm_rx_state = dispatch_status;
+            parser->rx_state = dispatch_status;
             retval = midiHandleNewState;
         }
     }
     else
     {
-        if (midi_cb_msg_data_1 != NULL)
+        if (parser->cb_msg_data_1 != NULL)
         {
-            midi_cb_msg_data_1(midi_running_status, rx_byte);
+            parser->cb_msg_data_1(parser->running_status, rx_byte);
         }
+        parser->msg_open = 0;
     }
 
     return retval;
 }
 
-static midiStatus_t state_handler_dispatch_status(uint8_t rx_byte)
+static midiStatus_t state_handler_dispatch_status(midi_parser_t *parser, uint8_t rx_byte)
 {
     midiStatus_t retval = midiError;
 
@@ -243,7 +266,7 @@ static midiStatus_t state_handler_dispatch_status(uint8_t rx_byte)
         (rx_byte == MIDI_STATUS_TIME_CODE) ||
         (rx_byte == MIDI_STATUS_SONG_SELECT))
     {
-        fsm_rx_state = wait_byte_data;
+        parser->rx_state = wait_byte_data;
         retval = midiOk;
     }
     /* Check if 2 data cmd */
@@ -254,26 +277,33 @@ static midiStatus_t state_handler_dispatch_status(uint8_t rx_byte)
              ((rx_byte & MIDI_STATUS_CMD_MASK) == MIDI_STATUS_PITCH_BEND) ||
              (rx_byte == MIDI_STATUS_SONG_POS))
     {
-        fsm_rx_state = wait_byte_first_data;
+        parser->rx_state = wait_byte_first_data;
         retval = midiOk;
     }
     /* Check if sys ex cmd */
     else if (rx_byte == MIDI_STATUS_SYS_EX_START)
     {
-        i_data_sys_ex = 0;
-        fsm_rx_state = wait_byte_sys_ex;
+        parser->sys_ex_len = 0;
+        parser->sys_ex_overflow = 0;
+        parser->rx_state = wait_byte_sys_ex;
+        sys_ex_stream_event(parser, midiSysExStart);
         retval = midiOk;
     }
     /* If not defined, jump to start */
     else
     {
-        fsm_rx_state = wait_byte_init;
+        parser->rx_state = wait_byte_init;
     }
 
     /* Save running status */
     if (retval == midiOk)
     {
-        midi_running_status = rx_byte;
+        parser->running_status = rx_byte;
+        parser->msg_open = 1;
+    }
+    else
+    {
+        parser->msg_open = 0;
     }
 
     return retval;
@@ -282,7 +312,7 @@ static midiStatus_t state_handler_dispatch_status(uint8_t rx_byte)
 /* ---------------------------------------------------------------------------*/
 
 /** State Handler definitions */
-midiStatus_t (*rx_state_table[])(uint8_t rx_byte) = {
+static midiStatus_t (*const rx_state_table[])(midi_parser_t *parser, uint8_t rx_byte) = {
     state_handler_wait_byte_init,
     state_handler_wait_byte_first_data,
     state_handler_wait_byte_second_data,
@@ -292,62 +322,204 @@ midiStatus_t (*rx_state_table[])(uint8_t rx_byte) = {
 
 /* Public function -----------------------------------------------------------*/
 
-/* Init library FSM and setup callback functions for rx parsing */
-midiStatus_t midi_init(midi_cb_msg_sys_ex_t cb_sys_ex,
+/* Init parser instance FSM and setup callback functions for rx parsing */
+midiStatus_t midi_init(midi_parser_t *parser,
+                       uint8_t *sys_ex_buff,
+                       uint32_t sys_ex_size,
+                       midi_cb_msg_sys_ex_t cb_sys_ex,
                        midi_cb_msg_data1_t cb_msg_data1,
                        midi_cb_msg_data2_t cb_msg_data2,
                        midi_cb_msg_rt_t cb_msg_rt)
 {
-    midiStatus_t retval = midiOk;
+    midiStatus_t retval = midiError;
 
-    /* Init private cb handlers */
-    if (cb_sys_ex != NULL)
-    {
-        midi_cb_sys_ex = cb_sys_ex;
-    }
-    if (cb_msg_data1 != NULL)
+    if (parser != NULL)
     {
-        midi_cb_msg_data_1 = cb_msg_data1;
+        /* Init instance cb handlers, NULL disables the message type */
+        parser->cb_sys_ex = cb_sys_ex;
+        parser->cb_msg_data_1 = cb_msg_data1;
+        parser->cb_msg_data_2 = cb_msg_data2;
+        parser->cb_msg_rt = cb_msg_rt;
+        parser->cb_sys_ex_stream = NULL;
+
+        /* SysEx storage is owned by caller */
+        parser->sys_ex_buff = sys_ex_buff;
+        parser->sys_ex_size = (sys_ex_buff != NULL) ? sys_ex_size : 0;
+        parser->sys_ex_drop_count = 0;
+
+        retval = midi_reset_fsm(parser);
     }
-    if (cb_msg_data2 != NULL)
-    {
-        midi_cb_msg_data_2 = cb_msg_data2;
-    }
-    if (cb_msg_rt != NULL)
-    {
-        midi_cb_msg_rt = cb_msg_rt;
-    }
-
-    fsm_rx_state = wait_byte_init;
-    midi_running_status = 0;
 
     return retval;
 }
 
+/* Set callback to receive sysEx bytes while they arrive */
+void midi_set_sys_ex_stream(midi_parser_t *parser, midi_cb_sys_ex_stream_t cb_sys_ex_stream)
+{
+    parser->cb_sys_ex_stream = cb_sys_ex_stream;
+}
+
 /* Update midi rx_fsm */
-midiStatus_t midi_update_fsm(uint8_t data_rx)
+midiStatus_t midi_update_fsm(midi_parser_t *parser, uint8_t data_rx)
 {
     midiStatus_t retval = midiError;
 
     do
     {
-        retval = rx_state_table[fsm_rx_state](data_rx);
+        retval = rx_state_table[parser->rx_state](parser, data_rx);
     } while (retval == midiHandleNewState);
 
     return retval;
 }
 
+/* Parse a contiguous span of midi bytes */
+size_t midi_parse(midi_parser_t *parser, const uint8_t *buf, size_t len, midi_msg_t *msg_batch, size_t batch_size, size_t *parsed)
+{
+    /* Work on local copies, byte stores into msg_batch would force reloads of parser fields */
+    midi_rx_state_t state = parser->rx_state;
+    uint8_t status = parser->running_status;
+    uint8_t data_1 = parser->tmp_data_1;
+    uint8_t msg_open = parser->msg_open;
+    size_t n_msg = 0;
+    size_t i_byte = 0;
+
+    while ((i_byte < len) && (n_msg < batch_size))
+    {
+        uint8_t rx_byte = buf[i_byte++];
+
+        if (!MIDI_IS_STATUS(rx_byte))
+        {
+            /* Data bytes, most frequent path */
+            if (state == wait_byte_first_data)
+            {
+                data_1 = rx_byte;
+                state = wait_byte_second_data;
+            }
+            else if (state == wait_byte_second_data)
+            {
+                msg_batch[n_msg].type = midiMsgData2;
+                msg_batch[n_msg].status = status;
+                msg_batch[n_msg].data0 = data_1;
+                msg_batch[n_msg].data1 = rx_byte;
+                n_msg++;
+                state = wait_byte_first_data;
+                msg_open = 0;
+            }
+            else if (state == wait_byte_data)
+            {
+                msg_batch[n_msg].type = midiMsgData1;
+                msg_batch[n_msg].status = status;
+                msg_batch[n_msg].data0 = rx_byte;
+                msg_batch[n_msg].data1 = 0;
+                n_msg++;
+                msg_open = 0;
+            }
+            else if (state == wait_byte_sys_ex)
+            {
+                (void)sys_ex_store(parser, rx_byte);
+            }
+        }
+        else if (MIDI_IS_RT(rx_byte))
+        {
+            /* Real time bytes do not modify parser state */
+            msg_batch[n_msg].type = midiMsgRt;
+            msg_batch[n_msg].status = rx_byte;
+            msg_batch[n_msg].data0 = 0;
+            msg_batch[n_msg].data1 = 0;
+            n_msg++;
+        }
+        else if ((state == wait_byte_sys_ex) && (rx_byte == MIDI_STATUS_SYS_EX_END) && (parser->sys_ex_overflow != 0))
+        {
+            /* End of a dropped sysEx, nothing to report */
+            parser->sys_ex_overflow = 0;
+            state = wait_byte_init;
+            msg_open = 0;
+        }
+        else if ((state == wait_byte_sys_ex) && (rx_byte == MIDI_STATUS_SYS_EX_END))
+        {
+            sys_ex_stream_event(parser, midiSysExEnd);
+            msg_batch[n_msg].type = midiMsgSysEx;
+            msg_batch[n_msg].status = MIDI_STATUS_SYS_EX_START;
+            msg_batch[n_msg].data0 = 0;
+            msg_batch[n_msg].data1 = 0;
+            n_msg++;
+            state = wait_byte_init;
+            msg_open = 0;
+
+            /* Return sysEx before buffer can be overwritten */
+            break;
+        }
+        else
+        {
+            /* Status bytes are rare, reuse fsm dispatch */
+            if ((state == wait_byte_sys_ex) && (parser->sys_ex_overflow == 0))
+            {
+                sys_ex_stream_event(parser, midiSysExAbort);
+            }
+            parser->sys_ex_overflow = 0;
+            parser->rx_state = state;
+            (void)state_handler_dispatch_status(parser, rx_byte);
+            state = parser->rx_state;
+            status = parser->running_status;
+            msg_open = parser->msg_open;
+        }
+    }
+
+    parser->rx_state = state;
+    parser->tmp_data_1 = data_1;
+    parser->msg_open = msg_open;
+
+    if (parsed != NULL)
+    {
+        *parsed = i_byte;
+    }
+
+    return n_msg;
+}
+
+/* Get data of last received sysEx message */
+uint8_t *midi_get_sys_ex(midi_parser_t *parser, uint32_t *len_data)
+{
+    if (len_data != NULL)
+    {
+        *len_data = parser->sys_ex_len;
+    }
+
+    return parser->sys_ex_buff;
+}
+
+/* Get number of dropped sysEx messages */
+uint32_t midi_get_sys_ex_drop(const midi_parser_t *parser)
+{
+    return parser->sys_ex_drop_count;
+}
+
 /* Set rx_fsm into reset state */
-midiStatus_t midi_reset_fsm(void)
+midiStatus_t midi_reset_fsm(midi_parser_t *parser)
 {
     midiStatus_t retval = midiOk;
 
-    fsm_rx_state = wait_byte_init;
-    midi_running_status = 0;
-    midi_tmp_data_1 = 0;
-    midi_tmp_data_2 = 0;
+    /* Stream decoder must not wait for the end of a lost sysEx */
+    if ((parser->rx_state == wait_byte_sys_ex) && (parser->sys_ex_overflow == 0))
+    {
+        sys_ex_stream_event(parser, midiSysExAbort);
+    }
+
+    parser->rx_state = wait_byte_init;
+    parser->running_status = 0;
+    parser->tmp_data_1 = 0;
+    parser->tmp_data_2 = 0;
+    parser->sys_ex_len = 0;
+    parser->sys_ex_overflow = 0;
+    parser->msg_open = 0;
 
     return retval;
 }
 
+/* Check if a message has been started and not completed */
+bool midi_msg_pending(const midi_parser_t *parser)
+{
+    return (parser->msg_open != 0);
+}
+
 /* EOF */
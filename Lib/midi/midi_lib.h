@@ -17,6 +17,7 @@ extern "C"
   /* Includes ------------------------------------------------------------------*/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stddef.h>
 
   /* Exported types ------------------------------------------------------------*/
@@ -45,6 +46,24 @@ typedef enum
     midiError,
 } midiStatus_t;
 
+/** Decoded message types returned by span parser */
+typedef enum
+{
+    midiMsgData1 = 0x00,
+    midiMsgData2,
+    midiMsgRt,
+    midiMsgSysEx,
+} midiMsgType_t;
+
+/** Decoded midi message */
+typedef struct
+{
+    uint8_t type;
+    uint8_t status;
+    uint8_t data0;
+    uint8_t data1;
+} midi_msg_t;
+
 /** CB for handle sys_ex */
 typedef void (*midi_cb_msg_sys_ex_t)(uint8_t *pdata, uint32_t len_data);
 
@@ -57,6 +76,41 @@ typedef void (*midi_cb_msg_data2_t)(uint8_t cmd, uint8_t data0, uint8_t data1);
 /** CB for handle rt message */
 typedef void (*midi_cb_msg_rt_t)(uint8_t rt_data);
 
+/** Events reported to sysEx stream callback */
+typedef enum
+{
+    midiSysExStart = 0x00,
+    midiSysExData,
+    midiSysExEnd,
+    midiSysExAbort,
+} midiSysExEvent_t;
+
+/** CB for handle sysEx bytes as they are received */
+typedef void (*midi_cb_sys_ex_stream_t)(midiSysExEvent_t event, uint8_t data);
+
+/** Parser instance, one per midi input stream */
+typedef struct
+{
+    /* Rx fsm state */
+    uint8_t rx_state;
+    uint8_t running_status;
+    uint8_t tmp_data_1;
+    uint8_t tmp_data_2;
+    uint8_t msg_open;
+    /* Caller supplied sysEx storage */
+    uint8_t *sys_ex_buff;
+    uint32_t sys_ex_size;
+    uint32_t sys_ex_len;
+    uint8_t sys_ex_overflow;
+    uint32_t sys_ex_drop_count;
+    /* Instance callbacks */
+    midi_cb_msg_sys_ex_t cb_sys_ex;
+    midi_cb_msg_data1_t cb_msg_data_1;
+    midi_cb_msg_data2_t cb_msg_data_2;
+    midi_cb_msg_rt_t cb_msg_rt;
+    midi_cb_sys_ex_stream_t cb_sys_ex_stream;
+} midi_parser_t;
+
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
 /* Exported defines ----------------------------------------------------------*/
@@ -102,6 +156,7 @@ typedef void (*midi_cb_msg_rt_t)(uint8_t rt_data);
 #define MIDI_CC_C25                 0x19U
 #define MIDI_CC_C26                 0x1AU
 #define MIDI_CC_C27                 0x1BU
+#define MIDI_CC_C28                 0x1CU
 #define MIDI_CC_C52                 0x34U
 #define MIDI_CC_C53                 0x35U
 #define MIDI_CC_C54                 0x36U
@@ -113,6 +168,7 @@ typedef void (*midi_cb_msg_rt_t)(uint8_t rt_data);
 #define MIDI_CC_C60                 0x3CU
 #define MIDI_CC_C61                 0x3DU
 #define MIDI_CC_C62                 0x3EU
+#define MIDI_CC_C63                 0x3FU
 #define MIDI_CC_BRI                 0x4AU
 #define MIDI_CC_HAR                 0x47U
 #define MIDI_CC_ATT                 0x49U
@@ -142,13 +198,16 @@ typedef void (*midi_cb_msg_rt_t)(uint8_t rt_data);
 #define MIDI_STATUS_SYS_EX_START    0xF0
 #define MIDI_STATUS_SYS_EX_END      0xF7
 
-/* Sys ex max buffer size */
+/* Sys ex default buffer size */
 #define SYS_EX_BUFF_SIZE            ( 400U )
 
 /* Exported functions prototypes ---------------------------------------------*/
 
 /**
- * @brief  Init library FSM and setup callback functions for rx parsing.
+ * @brief  Init parser instance FSM and setup callback functions for rx parsing.
+ * @param  parser: parser instance to init.
+ * @param  sys_ex_buff: storage for sysEx data, NULL to discard sysEx.
+ * @param  sys_ex_size: size of sys_ex_buff.
  * @param  cb_sys_ex: callback function for sysEx messages.
  * @param  cb_msg_data1: callback function for 1 data messages.
  * @param  cb_msg_data2: callback function for 2 data messages.
@@ -156,24 +215,78 @@ typedef void (*midi_cb_msg_rt_t)(uint8_t rt_data);
  * @retval Operation status.
  */
 midiStatus_t midi_init(
+    midi_parser_t *parser,
+    uint8_t *sys_ex_buff,
+    uint32_t sys_ex_size,
     midi_cb_msg_sys_ex_t cb_sys_ex,
     midi_cb_msg_data1_t cb_msg_data1,
     midi_cb_msg_data2_t cb_msg_data2,
     midi_cb_msg_rt_t cb_msg_rt);
 
+/**
+ * @brief  Set callback to receive sysEx bytes while they arrive.
+ *         Can be used without sysEx storage, init parser with NULL buffer.
+ * @param  parser: parser instance.
+ * @param  cb_sys_ex_stream: callback for sysEx events, NULL to disable.
+ * @retval None.
+ */
+void midi_set_sys_ex_stream(midi_parser_t *parser, midi_cb_sys_ex_stream_t cb_sys_ex_stream);
+
 /**
  * @brief  Update midi rx_fsm.
+ * @param  parser: parser instance.
  * @param  data_rx: input byte to update midi_rx fsm.
  * @retval Operation result.
  */
-midiStatus_t midi_update_fsm(uint8_t data_rx);
+midiStatus_t midi_update_fsm(midi_parser_t *parser, uint8_t data_rx);
 
 /**
- * @brief  Set rx_fsm into reset state.
- * @param  None.
+ * @brief  Parse a contiguous span of midi bytes.
+ *         Running status, real time bytes interleaved in messages and sysEx
+ *         are handled inline, sharing parser state with midi_update_fsm.
+ *         Decoded messages are stored in msg_batch. Parsing stops when the
+ *         batch is full or after a sysEx end, so sysEx data returned by
+ *         midi_get_sys_ex is valid until the next call.
+ * @param  parser: parser instance.
+ * @param  buf: input bytes.
+ * @param  len: number of input bytes.
+ * @param  msg_batch: output array for decoded messages.
+ * @param  batch_size: number of elements in msg_batch.
+ * @param  parsed: number of input bytes consumed.
+ * @retval Number of decoded messages.
+ */
+size_t midi_parse(midi_parser_t *parser, const uint8_t *buf, size_t len, midi_msg_t *msg_batch, size_t batch_size, size_t *parsed);
+
+/**
+ * @brief  Get data of last received sysEx message.
+ * @param  parser: parser instance.
+ * @param  len_data: pointer to store sysEx length.
+ * @retval Pointer to sysEx data, without start and end bytes.
+ */
+uint8_t *midi_get_sys_ex(midi_parser_t *parser, uint32_t *len_data);
+
+/**
+ * @brief  Get number of sysEx messages dropped for not fitting on buffer.
+ *         Bytes of a dropped sysEx are discarded up to its end byte.
+ * @param  parser: parser instance.
+ * @retval Dropped sysEx messages since init.
+ */
+uint32_t midi_get_sys_ex_drop(const midi_parser_t *parser);
+
+/**
+ * @brief  Set rx_fsm into reset state, an open sysEx is aborted.
+ * @param  parser: parser instance.
  * @retval Operation result.
  */
-midiStatus_t midi_reset_fsm(void);
+midiStatus_t midi_reset_fsm(midi_parser_t *parser);
+
+/**
+ * @brief  Check if a message has been started and not completed yet.
+ *         Used to split midi bytes from other data on shared ports.
+ * @param  parser: parser instance.
+ * @retval True while a status byte is waiting for its data bytes.
+ */
+bool midi_msg_pending(const midi_parser_t *parser);
 
 #ifdef __cplusplus
 }
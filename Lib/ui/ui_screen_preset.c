@@ -24,7 +24,8 @@
 /* Defined elements for Test screen */
 typedef enum
 {
-    PRESET_SCREEN_ELEMENT_BANK = 0,
+    PRESET_SCREEN_ELEMENT_PART = 0,
+    PRESET_SCREEN_ELEMENT_BANK,
     PRESET_SCREEN_ELEMENT_PROGRAM,
     PRESET_SCREEN_ELEMENT_NAME,
     PRESET_SCREEN_ELEMENT_SELECT,
@@ -38,7 +39,12 @@ typedef enum
 #define MAX_LEN_NAME                    (16U)
 #define MAX_LEN_NAME_SAVE_AUX           (4U)
 
+/* Part selection value to apply preset on all parts */
+#define PRESET_PART_ALL                 (0U)
+
 /* Format for screen elements */
+#define NAME_FORMAT_PART_ALL            "PART       ALL"
+#define NAME_FORMAT_PART                "PART %d     %d:%02d"
 #define NAME_FORMAT_BANK                "BANK        %02d"
 #define NAME_FORMAT_PROGRAM             "PROGRAM     %02d"
 #define NAME_FORMAT_NAME                " %s"
@@ -55,6 +61,7 @@ const char pcScreenPresetName[MAX_LEN_NAME] = "PRESET";
 ui_element_t xPresetScreenElementList[PRESET_SCREEN_ELEMENT_LAST_ELEMENT];
 
 /** String var with element messages */
+char pcPresetPartName[MAX_LEN_NAME] = {0};
 char pcPresetBankName[MAX_LEN_NAME] = {0};
 char pcPresetProgramName[MAX_LEN_NAME] = {0};
 char pcPresetNameName[MAX_LEN_NAME] = {0};
@@ -64,6 +71,9 @@ char pcPresetReturnName[MAX_LEN_NAME] = {0};
 /** Temporal string to save selection result */
 char pcPresetSlectionAuxName[MAX_LEN_NAME] = {0};
 
+/** Current part selection, PRESET_PART_ALL or part number starting on 1 */
+uint8_t u8SelectionPart = PRESET_PART_ALL;
+
 /** Current bank selection */
 uint8_t u8SelectionBank = 0;
 
@@ -74,6 +84,7 @@ uint8_t u8SelectionProgram = 0;
 
 /* Render function */
 static void vScreenPresetRender(void * pvDisplay, void * pvScreen);
+static void vElementPartRender(void * pvDisplay, void * pvScreen, void * pvElement);
 static void vElementBankRender(void * pvDisplay, void * pvScreen, void * pvElement);
 static void vElementProgramRender(void * pvDisplay, void * pvScreen, void * pvElement);
 static void vElementNameRender(void * pvDisplay, void * pvScreen, void * pvElement);
@@ -82,6 +93,7 @@ static void vElementReturnRender(void * pvDisplay, void * pvScreen, void * pvEle
 
 /* Action function */
 static void vScreenPresetAction(void * pvMenu, void * pvEventData);
+static void vElementPartAction(void * pvMenu, void * pvEventData);
 static void vElementBankAction(void * pvMenu, void * pvEventData);
 static void vElementProgramAction(void * pvMenu, void * pvEventData);
 static void vElementNameAction(void * pvMenu, void * pvEventData);
@@ -117,6 +129,40 @@ static void vScreenPresetRender(void * pvDisplay, void * pvScreen)
     }
 }
 
+static void vElementPartRender(void * pvDisplay, void * pvScreen, void * pvElement)
+{
+    if ((pvDisplay != NULL) && (pvScreen != NULL) && (pvElement != NULL))
+    {
+        u8g2_t * pxDisplayHandler = pvDisplay;
+        ui_screen_t * pxScreen = pvScreen;
+        ui_element_t * pxElement = pvElement;
+        uint32_t u32IndX = UI_OFFSET_ELEMENT_X;
+        uint32_t u32IndY = UI_OFFSET_ELEMENT_Y;
+
+        /* Compute element offset */
+        u32IndY += u32UI_MISC_GetDrawIndexY(pxDisplayHandler, pxScreen->u32ElementRenderIndex, pxElement->u32Index);
+
+        if ((u32IndY < u8g2_GetDisplayHeight(pxDisplayHandler)) && (u32IndY > UI_OFFSET_ELEMENT_Y))
+        {
+            if (u8SelectionPart == PRESET_PART_ALL)
+            {
+                sprintf(pxElement->pcName, NAME_FORMAT_PART_ALL);
+            }
+            else
+            {
+                /* Show program currently loaded on the part */
+                MidiPartPreset_t xPartPreset = xMidiGetPartPreset(u8SelectionPart - 1U);
+                snprintf(pxElement->pcName, MAX_LEN_NAME, NAME_FORMAT_PART, u8SelectionPart, xPartPreset.u8Bank, xPartPreset.u8Program);
+            }
+
+            /* Print selection ico */
+            vUI_MISC_DrawSelection(pxDisplayHandler, pxScreen, pxElement->u32Index, (uint8_t)u32IndY);
+
+            u8g2_DrawStr(pxDisplayHandler, (uint8_t)u32IndX, (uint8_t)u32IndY, pxElement->pcName);
+        }
+    }
+}
+
 static void vElementBankRender(void * pvDisplay, void * pvScreen, void * pvElement)
 {
     if ((pvDisplay != NULL) && (pvScreen != NULL) && (pvElement != NULL))
@@ -183,16 +229,10 @@ static void vElementNameRender(void * pvDisplay, void * pvScreen, void * pvEleme
 
         if ((u32IndY < u8g2_GetDisplayHeight(pxDisplayHandler)) && (u32IndY > UI_OFFSET_ELEMENT_Y))
         {
-            if (u8SelectionBank == LFS_MIDI_BANK_FLASH)
-            {
-                lfs_ym_data_t xYmData = { 0U };
-                LFS_read_ym_data(u8SelectionProgram, &xYmData);
-                snprintf(pxElement->pcName, MAX_LEN_NAME - 1U, NAME_FORMAT_NAME, xYmData.pu8Name);
-            }
-            else
-            {
-                snprintf(pxElement->pcName, MAX_LEN_NAME - 1U, NAME_FORMAT_NAME, pxSYNTH_APP_DATA_CONST_get_name(u8SelectionProgram));
-            }
+            char pcYmName[LFS_YM_CF_NAME_MAX_LEN + 1U];
+
+            /* Name from RAM directory, no flash access on render */
+            snprintf(pxElement->pcName, MAX_LEN_NAME - 1U, NAME_FORMAT_NAME, LFS_get_ym_name(u8SelectionBank, u8SelectionProgram, pcYmName, sizeof(pcYmName)));
 
             /* Print selection ico */
             vUI_MISC_DrawSelection(pxDisplayHandler, pxScreen, pxElement->u32Index, (uint8_t)u32IndY);
@@ -285,6 +325,51 @@ static void vScreenPresetAction(void * pvMenu, void * pvEventData)
     }
 }
 
+static void vElementPartAction(void * pvMenu, void * pvEventData)
+{
+    if ((pvMenu != NULL) && (pvEventData != NULL))
+    {
+        uint32_t * pu32Event = pvEventData;
+        ui_menu_t * pxMenu = pvMenu;
+        ui_screen_t * pxScreen = &pxMenu->pxScreenList[pxMenu->u32ScreenSelectionIndex];
+
+        /* Handle encoder events */
+        if (RTOS_CHECK_SIGNAL(*pu32Event, UI_SIGNAL_ENC_UPDATE_CW) || RTOS_CHECK_SIGNAL(*pu32Event, UI_SIGNAL_ENC_UPDATE_CCW))
+        {
+            if (pxScreen->bElementSelection)
+            {
+                if (RTOS_CHECK_SIGNAL(*pu32Event, UI_SIGNAL_ENC_UPDATE_CW))
+                {
+                    if (u8SelectionPart < SYNTH_MAX_NUM_VOICE)
+                    {
+                        u8SelectionPart++;
+                    }
+                }
+                else if (RTOS_CHECK_SIGNAL(*pu32Event, UI_SIGNAL_ENC_UPDATE_CCW))
+                {
+                    if (u8SelectionPart != PRESET_PART_ALL)
+                    {
+                        u8SelectionPart--;
+                    }
+                }
+
+                /* Start bank and program selection from the preset loaded on the part */
+                if (u8SelectionPart != PRESET_PART_ALL)
+                {
+                    MidiPartPreset_t xPartPreset = xMidiGetPartPreset(u8SelectionPart - 1U);
+                    u8SelectionBank = xPartPreset.u8Bank;
+                    u8SelectionProgram = xPartPreset.u8Program;
+                }
+            }
+        }
+        /* Element selection action */
+        else if (RTOS_CHECK_SIGNAL(*pu32Event, UI_SIGNAL_ENC_UPDATE_SW_SET))
+        {
+            pxScreen->bElementSelection = !pxScreen->bElementSelection;
+        }
+    }
+}
+
 static void vElementBankAction(void * pvMenu, void * pvEventData)
 {
     if ((pvMenu != NULL) && (pvEventData != NULL))
@@ -429,13 +514,21 @@ static void vElementSelectAction(void * pvMenu, void * pvEventData)
                 sprintf(pcPresetSlectionAuxName, "ERR");
             }
 
-            // TODO: Set preset here
-
             MidiTaskCmd_t xMidiCmd = { 0U };
 
-            xMidiCmd.eCmd = MIDI_CMD_SET_PRESET;
-            xMidiCmd.uPayload.xSetPreset.u8Bank = u8SelectionBank;
-            xMidiCmd.uPayload.xSetPreset.u8Program = u8SelectionProgram;
+            if (u8SelectionPart == PRESET_PART_ALL)
+            {
+                xMidiCmd.eCmd = MIDI_CMD_SET_PRESET;
+                xMidiCmd.uPayload.xSetPreset.u8Bank = u8SelectionBank;
+                xMidiCmd.uPayload.xSetPreset.u8Program = u8SelectionProgram;
+            }
+            else
+            {
+                xMidiCmd.eCmd = MIDI_CMD_SET_PART_PRESET;
+                xMidiCmd.uPayload.xSetPartPreset.u8Part = u8SelectionPart - 1U;
+                xMidiCmd.uPayload.xSetPartPreset.u8Bank = u8SelectionBank;
+                xMidiCmd.uPayload.xSetPartPreset.u8Program = u8SelectionProgram;
+            }
 
             (void)bMidiSendCmd(xMidiCmd);
         }
@@ -484,6 +577,7 @@ ui_status_t UI_screen_preset_init(ui_screen_t * pxScreenHandler)
         pxScreenHandler->bElementSelection = false;
 
         /* Init name var */
+        sprintf(pcPresetPartName, NAME_FORMAT_PART_ALL);
         sprintf(pcPresetBankName, NAME_FORMAT_BANK, u8SelectionBank);
         sprintf(pcPresetProgramName, NAME_FORMAT_PROGRAM, u8SelectionProgram);
         sprintf(pcPresetProgramName, NAME_FORMAT_NAME, "");
@@ -491,6 +585,11 @@ ui_status_t UI_screen_preset_init(ui_screen_t * pxScreenHandler)
         sprintf(pcPresetReturnName, NAME_FORMAT_RETURN);
 
         /* Init elements */
+        xPresetScreenElementList[PRESET_SCREEN_ELEMENT_PART].pcName = pcPresetPartName;
+        xPresetScreenElementList[PRESET_SCREEN_ELEMENT_PART].u32Index = PRESET_SCREEN_ELEMENT_PART;
+        xPresetScreenElementList[PRESET_SCREEN_ELEMENT_PART].render_cb = vElementPartRender;
+        xPresetScreenElementList[PRESET_SCREEN_ELEMENT_PART].action_cb = vElementPartAction;
+
         xPresetScreenElementList[PRESET_SCREEN_ELEMENT_BANK].pcName = pcPresetBankName;
         xPresetScreenElementList[PRESET_SCREEN_ELEMENT_BANK].u32Index = PRESET_SCREEN_ELEMENT_BANK;
         xPresetScreenElementList[PRESET_SCREEN_ELEMENT_BANK].render_cb = vElementBankRender;
@@ -10,13 +10,95 @@
 #include "ui_sys.h"
 #include "ui_menu_main.h"
 
+#include <string.h>
+
 /* Private includes ----------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+
+/* Cycles of frames sent to display, written by ui task */
+static rtos_bench_t xUiPushBench = { UINT32_MAX, 0U, 0U, 0U };
+
 /* Private function prototypes -----------------------------------------------*/
+
+/**
+  * @brief  Mark all tiles as unknown, next render sends full display.
+  * @param  pxMenuHandler menu handler to use.
+  * @retval None.
+  */
+static void vTileShadowReset(ui_menu_t * pxMenuHandler);
+
+/**
+  * @brief  Send to display only tiles changed since last update, one area per tile row.
+  * @param  pxIniDisplayHandler display handler.
+  * @param  pxMenuHandler menu handler to use.
+  * @retval Number of tile rows sent.
+  */
+static uint32_t u32SendChangedTiles(u8g2_t * pxIniDisplayHandler, ui_menu_t * pxMenuHandler);
+
 /* Private user code ---------------------------------------------------------*/
+
+static void vTileShadowReset(ui_menu_t * pxMenuHandler)
+{
+    pxMenuHandler->bFullFrame = true;
+}
+
+static uint32_t u32SendChangedTiles(u8g2_t * pxIniDisplayHandler, ui_menu_t * pxMenuHandler)
+{
+    uint32_t u32Rows = 0U;
+    uint8_t * pu8Buffer = u8g2_GetBufferPtr(pxIniDisplayHandler);
+    uint32_t u32TileWidth = u8g2_GetBufferTileWidth(pxIniDisplayHandler);
+    uint32_t u32TileHeight = u8g2_GetBufferTileHeight(pxIniDisplayHandler);
+
+    if (u32TileWidth > UI_TILE_MAX_WIDTH)
+    {
+        u32TileWidth = UI_TILE_MAX_WIDTH;
+    }
+
+    if (u32TileHeight > UI_TILE_MAX_HEIGHT)
+    {
+        u32TileHeight = UI_TILE_MAX_HEIGHT;
+    }
+
+    for (uint32_t u32TileY = 0U; u32TileY < u32TileHeight; u32TileY++)
+    {
+        uint32_t u32FirstX = u32TileWidth;
+        uint32_t u32LastX = 0U;
+
+        /* Find changed span on this tile row, exact compare against last sent data */
+        for (uint32_t u32TileX = 0U; u32TileX < u32TileWidth; u32TileX++)
+        {
+            const uint8_t * pu8Tile = &pu8Buffer[((u32TileY * u32TileWidth) + u32TileX) * UI_TILE_SIZE];
+            uint8_t * pu8Shadow = pxMenuHandler->pu8TileShadow[u32TileY][u32TileX];
+
+            if (pxMenuHandler->bFullFrame || (memcmp(pu8Tile, pu8Shadow, UI_TILE_SIZE) != 0))
+            {
+                memcpy(pu8Shadow, pu8Tile, UI_TILE_SIZE);
+
+                if (u32FirstX == u32TileWidth)
+                {
+                    u32FirstX = u32TileX;
+                }
+
+                u32LastX = u32TileX;
+            }
+        }
+
+        if (u32FirstX < u32TileWidth)
+        {
+            u8g2_UpdateDisplayArea(pxIniDisplayHandler, (uint8_t)u32FirstX, (uint8_t)u32TileY, (uint8_t)(u32LastX - u32FirstX + 1U), 1U);
+            u32Rows++;
+        }
+    }
+
+    pxMenuHandler->bFullFrame = false;
+
+    return u32Rows;
+}
+
 /* Public user code ----------------------------------------------------------*/
 
 ui_status_t UI_init(ui_menu_t * pxMenuHandler)
@@ -25,6 +107,12 @@ ui_status_t UI_init(ui_menu_t * pxMenuHandler)
 
     if (UI_menu_main_init(pxMenuHandler) == UI_STATUS_OK)
     {
+        /* Display content unknown, first render sends full frame */
+        pxMenuHandler->bDirty = true;
+        pxMenuHandler->u32EncoderSteps = 1U;
+        pxMenuHandler->u32RenderedScreenIndex = pxMenuHandler->u32ScreenSelectionIndex;
+        vTileShadowReset(pxMenuHandler);
+
         retval = UI_STATUS_OK;
     }
 
@@ -43,21 +131,43 @@ ui_status_t UI_render(u8g2_t * pxIniDisplayHandler, ui_menu_t * pxMenuHandler)
         /* Get screen to render */
         pxScreen = &pxMenuHandler->pxScreenList[u32ScreenIndex];
 
-        /* Update display data */
-        u8g2_ClearBuffer(pxIniDisplayHandler);
-
-        /* Render screen marquee*/
-        pxScreen->render_cb(pxIniDisplayHandler, pxScreen);
-
-        /* Render screen elements */
-        for (uint32_t u32Index = 0; u32Index < pxScreen->u32ElementNumber; u32Index++)
+        /* Screen switch, resend full frame to recover from any missed tile */
+        if (u32ScreenIndex != pxMenuHandler->u32RenderedScreenIndex)
         {
-            ui_element_t * pxElement = &pxScreen->pxElementList[u32Index];
-            pxElement->render_cb(pxIniDisplayHandler, pxScreen, pxElement);
+            pxMenuHandler->u32RenderedScreenIndex = u32ScreenIndex;
+            pxMenuHandler->bDirty = true;
+            vTileShadowReset(pxMenuHandler);
         }
 
-        /* Send data to display */
-        u8g2_SendBuffer(pxIniDisplayHandler);
+        if (pxMenuHandler->bDirty)
+        {
+            pxMenuHandler->bDirty = false;
+
+            /* Update display data */
+            u8g2_ClearBuffer(pxIniDisplayHandler);
+
+            /* Render screen marquee*/
+            pxScreen->render_cb(pxIniDisplayHandler, pxScreen);
+
+            /* Render screen elements */
+            for (uint32_t u32Index = 0; u32Index < pxScreen->u32ElementNumber; u32Index++)
+            {
+                ui_element_t * pxElement = &pxScreen->pxElementList[u32Index];
+                pxElement->render_cb(pxIniDisplayHandler, pxScreen, pxElement);
+            }
+
+            /* Send modified data to display */
+            uint32_t u32StartCount = u32RtosStatsTimerGet();
+
+            if (u32SendChangedTiles(pxIniDisplayHandler, pxMenuHandler) != 0U)
+            {
+                uint32_t u32Cycles = (u32RtosStatsTimerGet() - u32StartCount) * RTOS_STATS_CLOCK_CYCLES;
+
+                taskENTER_CRITICAL();
+                vRtosBenchAdd(&xUiPushBench, u32Cycles);
+                taskEXIT_CRITICAL();
+            }
+        }
 
         retval = UI_STATUS_OK;
     }
@@ -78,6 +188,31 @@ void UI_action(ui_menu_t * pxMenuHandler, void * pvEvent)
 
         /* Send action to screen */
         pxScreen->action_cb(pxMenuHandler, pvEvent);
+
+        /* Any action may change screen content */
+        pxMenuHandler->bDirty = true;
+    }
+}
+
+void UI_set_dirty(ui_menu_t * pxMenuHandler)
+{
+    if (pxMenuHandler != NULL)
+    {
+        pxMenuHandler->bDirty = true;
+    }
+}
+
+void UI_get_push_bench(rtos_bench_t * pxBench, bool bReset)
+{
+    if (pxBench != NULL)
+    {
+        taskENTER_CRITICAL();
+        *pxBench = xUiPushBench;
+        if (bReset)
+        {
+            vRtosBenchReset(&xUiPushBench);
+        }
+        taskEXIT_CRITICAL();
     }
 }
 
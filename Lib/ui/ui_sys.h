@@ -20,12 +20,20 @@ extern "C"
 #include <stdbool.h>
 
 #include "u8g2.h"
+#include "sys_rtos.h"
 
 /* Private defines -----------------------------------------------------------*/
 
 /* Maximun len display string */
 #define UI_STR_MAX_LEN     (16U)
 
+/* Max display size in tiles (8x8 pixels), 128x64 display */
+#define UI_TILE_MAX_WIDTH  (16U)
+#define UI_TILE_MAX_HEIGHT (8U)
+
+/* Bytes per tile on display buffer */
+#define UI_TILE_SIZE       (8U)
+
 /* Exported types ------------------------------------------------------------*/
 
 /* Operation status */
@@ -79,6 +87,11 @@ typedef struct
     char * pcName;
     uint32_t u32ScreenSelectionIndex;
     ui_screen_t * pxScreenList;
+    bool bDirty;                                                    /* Render pending */
+    uint32_t u32EncoderSteps;                                       /* Accelerated steps of current encoder event */
+    uint32_t u32RenderedScreenIndex;                                /* Screen on display */
+    bool bFullFrame;                                                /* Display content unknown, send all tiles */
+    uint8_t pu8TileShadow[UI_TILE_MAX_HEIGHT][UI_TILE_MAX_WIDTH][UI_TILE_SIZE]; /* Copy of tiles on display */
 } ui_menu_t;
 
 /* Exported constants --------------------------------------------------------*/
@@ -93,7 +106,8 @@ typedef struct
 ui_status_t UI_init(ui_menu_t * pxMenuHandler);
 
 /**
-  * @brief  Render menu image.
+  * @brief  Render menu image if dirty, only changed tiles are sent to display.
+  * @note   Returns once last tile row is queued on I2C DMA, display may still be receiving it.
   * @param  pxIniDisplayHandler.
   * @param  pxMenuHandler.
   * @retval Operation status.
@@ -108,6 +122,23 @@ ui_status_t UI_render(u8g2_t * pxIniDisplayHandler, ui_menu_t * pxMenuHandler);
   */
 void UI_action(ui_menu_t * pxMenuHandler, void * pvEvent);
 
+/**
+  * @brief  Request a render of active screen on next update.
+  * @param  pxMenuHandler menu handler to use.
+  * @retval None.
+  */
+void UI_set_dirty(ui_menu_t * pxMenuHandler);
+
+/**
+  * @brief  Get cycles spent sending changed tiles of rendered frames, frames without
+  *         changes are not counted. Measured with run time stats clock, includes waits
+  *         for previous I2C DMA transfers.
+  * @param  pxBench where to copy measures.
+  * @param  bReset clear measures after copy.
+  * @retval None.
+  */
+void UI_get_push_bench(rtos_bench_t * pxBench, bool bReset);
+
 #ifdef __cplusplus
 }
 #endif
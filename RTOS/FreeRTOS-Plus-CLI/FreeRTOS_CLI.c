@@ -46,12 +46,6 @@ one of the application files:
 	#define configAPPLICATION_PROVIDES_cOutputBuffer 0
 #endif
 
-typedef struct xCOMMAND_INPUT_LIST
-{
-	const CLI_Command_Definition_t *pxCommandLineDefinition;
-	struct xCOMMAND_INPUT_LIST *pxNext;
-} CLI_Definition_List_Item_t;
-
 /*
  * The callback function that is executed when "help" is entered.  This is the
  * only default command that is always present.
@@ -63,6 +57,13 @@ static BaseType_t prvHelpCommand( char *pcWriteBuffer, size_t xWriteBufferLen, c
  */
 static int8_t prvGetNumberOfParameters( const char *pcCommandString );
 
+/*
+ * Add a list item, that references the command being registered, to the end
+ * of the list of registered commands.
+ */
+static void prvRegisterCommand( const CLI_Command_Definition_t * const pxCommandToRegister,
+								CLI_Definition_List_Item_t * pxCliDefinitionListItemBuffer );
+
 /* The definition of the "help" command.  This command is always at the front
 of the list of registered commands. */
 static const CLI_Command_Definition_t xHelpCommand =
@@ -102,9 +103,10 @@ buffer needs to be placed at a fixed address (rather than by the linker). */
 
 /*-----------------------------------------------------------*/
 
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
 BaseType_t FreeRTOS_CLIRegisterCommand( const CLI_Command_Definition_t * const pxCommandToRegister )
 {
-static CLI_Definition_List_Item_t *pxLastCommandInList = &xRegisteredCommands;
 CLI_Definition_List_Item_t *pxNewListItem;
 BaseType_t xReturn = pdFAIL;
 
@@ -117,29 +119,54 @@ BaseType_t xReturn = pdFAIL;
 
 	if( pxNewListItem != NULL )
 	{
-		taskENTER_CRITICAL();
-		{
-			/* Reference the command being registered from the newly created
-			list item. */
-			pxNewListItem->pxCommandLineDefinition = pxCommandToRegister;
+		prvRegisterCommand( pxCommandToRegister, pxNewListItem );
+		xReturn = pdPASS;
+	}
 
-			/* The new list item will get added to the end of the list, so
-			pxNext has nowhere to point. */
-			pxNewListItem->pxNext = NULL;
+	return xReturn;
+}
 
-			/* Add the newly created list item to the end of the already existing
-			list. */
-			pxLastCommandInList->pxNext = pxNewListItem;
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
 
-			/* Set the end of list marker to the new list item. */
-			pxLastCommandInList = pxNewListItem;
-		}
-		taskEXIT_CRITICAL();
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 
-		xReturn = pdPASS;
-	}
+BaseType_t FreeRTOS_CLIRegisterCommandStatic( const CLI_Command_Definition_t * const pxCommandToRegister,
+											  CLI_Definition_List_Item_t * pxCliDefinitionListItemBuffer )
+{
+	/* Check the parameters are not NULL. */
+	configASSERT( pxCommandToRegister );
+	configASSERT( pxCliDefinitionListItemBuffer );
 
-	return xReturn;
+	prvRegisterCommand( pxCommandToRegister, pxCliDefinitionListItemBuffer );
+
+	return pdPASS;
+}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static void prvRegisterCommand( const CLI_Command_Definition_t * const pxCommandToRegister,
+								CLI_Definition_List_Item_t * pxCliDefinitionListItemBuffer )
+{
+static CLI_Definition_List_Item_t *pxLastCommandInList = &xRegisteredCommands;
+
+	taskENTER_CRITICAL();
+	{
+		/* Reference the command being registered from the list item. */
+		pxCliDefinitionListItemBuffer->pxCommandLineDefinition = pxCommandToRegister;
+
+		/* The new list item will get added to the end of the list, so
+		pxNext has nowhere to point. */
+		pxCliDefinitionListItemBuffer->pxNext = NULL;
+
+		/* Add the new list item to the end of the already existing list. */
+		pxLastCommandInList->pxNext = pxCliDefinitionListItemBuffer;
+
+		/* Set the end of list marker to the new list item. */
+		pxLastCommandInList = pxCliDefinitionListItemBuffer;
+	}
+	taskEXIT_CRITICAL();
 }
 /*-----------------------------------------------------------*/
 
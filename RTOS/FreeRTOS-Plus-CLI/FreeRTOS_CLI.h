@@ -48,13 +48,32 @@ typedef struct xCOMMAND_LINE_INPUT
 /* For backward compatibility. */
 #define xCommandLineInput CLI_Command_Definition_t
 
+/* The structure that links registered commands, one per registered command. */
+typedef struct xCOMMAND_INPUT_LIST
+{
+	const CLI_Command_Definition_t *pxCommandLineDefinition;
+	struct xCOMMAND_INPUT_LIST *pxNext;
+} CLI_Definition_List_Item_t;
+
 /*
  * Register the command passed in using the pxCommandToRegister parameter.
  * Registering a command adds the command to the list of commands that are
  * handled by the command interpreter.  Once a command has been registered it
  * can be executed from the command line.
  */
-BaseType_t FreeRTOS_CLIRegisterCommand( const CLI_Command_Definition_t * const pxCommandToRegister );
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	BaseType_t FreeRTOS_CLIRegisterCommand( const CLI_Command_Definition_t * const pxCommandToRegister );
+#endif
+
+/*
+ * Same as FreeRTOS_CLIRegisterCommand, the list item is provided by the
+ * application in pxCliDefinitionListItemBuffer, which must not go out of
+ * scope while the command is registered.
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	BaseType_t FreeRTOS_CLIRegisterCommandStatic( const CLI_Command_Definition_t * const pxCommandToRegister,
+												  CLI_Definition_List_Item_t * pxCliDefinitionListItemBuffer );
+#endif
 
 /*
  * Runs the command interpreter for the command string "pcCommandInput".  Any
@@ -0,0 +1,231 @@
+/**
+ * @file    midi_parse_bench.c
+ * @brief   Host benchmark of midi_lib, per byte fsm against span parser.
+ *
+ *          Both paths parse the same synthetic stream: note on with running
+ *          status, program changes, clock bytes inside messages and short
+ *          sysEx. Output of both paths is checked to be the same.
+ *
+ *          Build and run from repo root:
+ *          gcc -Os -ILib/midi Tools/host_bench/midi_parse_bench.c Lib/midi/midi_lib.c -o midi_parse_bench
+ *          ./midi_parse_bench
+ *          or run Tools/py_tools/host_bench.py.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "midi_lib.h"
+
+/* Private defines -----------------------------------------------------------*/
+
+/* Synthetic stream size */
+#define BENCH_STREAM_SIZE       ( 1024U * 1024U )
+
+/* Best of runs is reported */
+#define BENCH_RUNS              ( 20U )
+
+/* Same batch size used by midi task */
+#define BENCH_BATCH_SIZE        ( 8U )
+
+/* Same chunk size used by midi task */
+#define BENCH_CHUNK_SIZE        ( 32U )
+
+/* SysEx storage, larger than generated sysEx */
+#define BENCH_SYS_EX_SIZE       ( 64U )
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint8_t pu8Stream[BENCH_STREAM_SIZE];
+static uint8_t pu8SysEx[BENCH_SYS_EX_SIZE];
+static uint32_t u32Check = 0U;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void vCheckAdd(uint8_t u8Type, uint8_t u8Status, uint8_t u8Data0, uint8_t u8Data1)
+{
+    u32Check = (u32Check * 31U) + (((uint32_t)u8Type << 24U) | ((uint32_t)u8Status << 16U) | ((uint32_t)u8Data0 << 8U) | u8Data1);
+}
+
+static void vCbSysEx(uint8_t *pdata, uint32_t len_data)
+{
+    (void)pdata;
+    vCheckAdd(midiMsgSysEx, 0xF0U, 0U, 0U);
+    u32Check += len_data;
+}
+
+static void vCbData1(uint8_t cmd, uint8_t data)
+{
+    vCheckAdd(midiMsgData1, cmd, data, 0U);
+}
+
+static void vCbData2(uint8_t cmd, uint8_t data0, uint8_t data1)
+{
+    vCheckAdd(midiMsgData2, cmd, data0, data1);
+}
+
+static void vCbRt(uint8_t rt_data)
+{
+    vCheckAdd(midiMsgRt, rt_data, 0U, 0U);
+}
+
+static void vStreamBuild(void)
+{
+    uint32_t u32Seed = 1U;
+    uint32_t u32Pos = 0U;
+
+    while (u32Pos < (BENCH_STREAM_SIZE - 16U))
+    {
+        uint32_t u32Rand = 0U;
+
+        u32Seed = (u32Seed * 1103515245U) + 12345U;
+        u32Rand = u32Seed >> 16U;
+
+        if ((u32Rand % 64U) == 0U)
+        {
+            /* Short sysEx */
+            pu8Stream[u32Pos++] = 0xF0U;
+            for (uint32_t u32Index = 0U; u32Index < 8U; u32Index++)
+            {
+                pu8Stream[u32Pos++] = (uint8_t)((u32Rand + u32Index) & 0x7FU);
+            }
+            pu8Stream[u32Pos++] = 0xF7U;
+        }
+        else if ((u32Rand % 16U) == 0U)
+        {
+            /* Program change breaks running status */
+            pu8Stream[u32Pos++] = 0xC0U;
+            pu8Stream[u32Pos++] = (uint8_t)(u32Rand & 0x7FU);
+            pu8Stream[u32Pos++] = 0x90U;
+        }
+        else if ((u32Rand % 8U) == 0U)
+        {
+            /* Clock between note data bytes */
+            pu8Stream[u32Pos++] = (uint8_t)(u32Rand & 0x7FU);
+            pu8Stream[u32Pos++] = 0xF8U;
+            pu8Stream[u32Pos++] = 100U;
+        }
+        else
+        {
+            /* Note on, running status */
+            pu8Stream[u32Pos++] = (uint8_t)(u32Rand & 0x7FU);
+            pu8Stream[u32Pos++] = (uint8_t)((u32Rand >> 7U) & 0x7FU);
+        }
+    }
+
+    /* Pad with clock, keeps stream ending outside a message */
+    while (u32Pos < BENCH_STREAM_SIZE)
+    {
+        pu8Stream[u32Pos++] = 0xF8U;
+    }
+
+    pu8Stream[0U] = 0x90U;
+}
+
+static double dNowNs(void)
+{
+    struct timespec xTime;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+
+    return ((double)xTime.tv_sec * 1e9) + (double)xTime.tv_nsec;
+}
+
+static uint32_t u32RunFsm(double *pdNs)
+{
+    midi_parser_t xParser;
+    double dStart = 0.0;
+
+    (void)midi_init(&xParser, pu8SysEx, BENCH_SYS_EX_SIZE, vCbSysEx, vCbData1, vCbData2, vCbRt);
+    u32Check = 0U;
+
+    dStart = dNowNs();
+    for (uint32_t u32Index = 0U; u32Index < BENCH_STREAM_SIZE; u32Index++)
+    {
+        (void)midi_update_fsm(&xParser, pu8Stream[u32Index]);
+    }
+    *pdNs = dNowNs() - dStart;
+
+    return u32Check;
+}
+
+static uint32_t u32RunSpan(double *pdNs)
+{
+    midi_parser_t xParser;
+    midi_msg_t xMsgBatch[BENCH_BATCH_SIZE];
+    double dStart = 0.0;
+
+    (void)midi_init(&xParser, pu8SysEx, BENCH_SYS_EX_SIZE, NULL, NULL, NULL, NULL);
+    u32Check = 0U;
+
+    dStart = dNowNs();
+    for (uint32_t u32Chunk = 0U; u32Chunk < BENCH_STREAM_SIZE; u32Chunk += BENCH_CHUNK_SIZE)
+    {
+        size_t xParsed = 0U;
+
+        while (xParsed < BENCH_CHUNK_SIZE)
+        {
+            size_t xUsed = 0U;
+            size_t xNumMsg = midi_parse(&xParser, &pu8Stream[u32Chunk + xParsed], BENCH_CHUNK_SIZE - xParsed, xMsgBatch, BENCH_BATCH_SIZE, &xUsed);
+
+            for (size_t xIndex = 0U; xIndex < xNumMsg; xIndex++)
+            {
+                if (xMsgBatch[xIndex].type == midiMsgSysEx)
+                {
+                    uint32_t u32Len = 0U;
+                    uint8_t * pu8Data = midi_get_sys_ex(&xParser, &u32Len);
+
+                    vCbSysEx(pu8Data, u32Len);
+                }
+                else
+                {
+                    vCheckAdd(xMsgBatch[xIndex].type, xMsgBatch[xIndex].status, xMsgBatch[xIndex].data0, xMsgBatch[xIndex].data1);
+                }
+            }
+            xParsed += xUsed;
+        }
+    }
+    *pdNs = dNowNs() - dStart;
+
+    return u32Check;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+    double dBestFsm = 0.0;
+    double dBestSpan = 0.0;
+    uint32_t u32CheckFsm = 0U;
+    uint32_t u32CheckSpan = 0U;
+
+    vStreamBuild();
+
+    for (uint32_t u32Run = 0U; u32Run < BENCH_RUNS; u32Run++)
+    {
+        double dFsm = 0.0;
+        double dSpan = 0.0;
+
+        u32CheckFsm = u32RunFsm(&dFsm);
+        u32CheckSpan = u32RunSpan(&dSpan);
+
+        if ((u32Run == 0U) || (dFsm < dBestFsm))
+        {
+            dBestFsm = dFsm;
+        }
+        if ((u32Run == 0U) || (dSpan < dBestSpan))
+        {
+            dBestSpan = dSpan;
+        }
+    }
+
+    printf("midi fsm   %.2f ns/byte\n", dBestFsm / BENCH_STREAM_SIZE);
+    printf("midi span  %.2f ns/byte\n", dBestSpan / BENCH_STREAM_SIZE);
+    printf("check      fsm 0x%08X span 0x%08X %s\n", u32CheckFsm, u32CheckSpan, (u32CheckFsm == u32CheckSpan) ? "OK" : "MISMATCH");
+
+    return (u32CheckFsm == u32CheckSpan) ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file    ring_bench.c
+ * @brief   Host benchmark of serial rx buffers, circular_buffer against spsc_ring.
+ *
+ *          Each iteration stores a 64 byte and a 13 byte segment, as DMA
+ *          half and idle line events do, then drains the buffer. Indexes
+ *          keep moving, so segments wrap over the buffer end. Output of
+ *          both buffers is checked to be the same on an extra untimed run.
+ *
+ *          Build and run from repo root:
+ *          gcc -Os -ILib/cbuf Tools/host_bench/ring_bench.c Lib/cbuf/circular_buffer.c Lib/cbuf/spsc_ring.c -o ring_bench
+ *          ./ring_bench
+ *          or run Tools/py_tools/host_bench.py.
+ */
+
+/* Includes ------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "circular_buffer.h"
+#include "spsc_ring.h"
+
+/* Private defines -----------------------------------------------------------*/
+
+/* Same size used by serial driver */
+#define BENCH_RING_SIZE         ( 512U )
+
+/* Segments stored on each iteration */
+#define BENCH_SEG_LONG          ( 64U )
+#define BENCH_SEG_SHORT         ( 13U )
+#define BENCH_SEG_TOTAL         ( BENCH_SEG_LONG + BENCH_SEG_SHORT )
+
+/* Iterations per run, about 1 MiB moved */
+#define BENCH_ITERATIONS        ( (1024U * 1024U) / BENCH_SEG_TOTAL )
+
+/* Best of runs is reported */
+#define BENCH_RUNS              ( 20U )
+
+/* Private variables ---------------------------------------------------------*/
+
+static uint8_t pu8RingBuffer[BENCH_RING_SIZE];
+static uint8_t pu8Input[BENCH_SEG_TOTAL];
+static uint8_t pu8Output[BENCH_RING_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t u32CheckAdd(uint32_t u32Check, const uint8_t * pu8Data, uint32_t u32Len)
+{
+    for (uint32_t u32Index = 0U; u32Index < u32Len; u32Index++)
+    {
+        u32Check = (u32Check * 31U) + pu8Data[u32Index];
+    }
+
+    return u32Check;
+}
+
+static double dNowNs(void)
+{
+    struct timespec xTime;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+
+    return ((double)xTime.tv_sec * 1e9) + (double)xTime.tv_nsec;
+}
+
+static uint32_t u32RunCbuf(double *pdNs, bool bCheck)
+{
+    circular_buf_t xCbuf;
+    uint32_t u32Check = 0U;
+    double dStart = 0.0;
+
+    circular_buf_init(&xCbuf, pu8RingBuffer, BENCH_RING_SIZE);
+
+    dStart = dNowNs();
+    for (uint32_t u32Iter = 0U; u32Iter < BENCH_ITERATIONS; u32Iter++)
+    {
+        uint32_t u32Read = 0U;
+
+        /* One byte per call, as old serial driver did */
+        for (uint32_t u32Index = 0U; u32Index < BENCH_SEG_TOTAL; u32Index++)
+        {
+            (void)circular_buf_put2(&xCbuf, (uint8_t)(pu8Input[u32Index] + u32Iter));
+        }
+
+        while (circular_buf_get(&xCbuf, &pu8Output[u32Read]) == 0)
+        {
+            u32Read++;
+        }
+
+        if (bCheck)
+        {
+            u32Check = u32CheckAdd(u32Check, pu8Output, u32Read);
+        }
+    }
+    *pdNs = dNowNs() - dStart;
+
+    return u32Check;
+}
+
+static uint32_t u32RunSpsc(double *pdNs, bool bCheck)
+{
+    spsc_ring_t xRing;
+    uint8_t pu8Segment[BENCH_SEG_TOTAL];
+    uint32_t u32Check = 0U;
+    double dStart = 0.0;
+
+    (void)spsc_ring_init(&xRing, pu8RingBuffer, BENCH_RING_SIZE);
+
+    dStart = dNowNs();
+    for (uint32_t u32Iter = 0U; u32Iter < BENCH_ITERATIONS; u32Iter++)
+    {
+        uint32_t u32Read = 0U;
+
+        /* Same data as cbuf run, built out of the store calls */
+        for (uint32_t u32Index = 0U; u32Index < BENCH_SEG_TOTAL; u32Index++)
+        {
+            pu8Segment[u32Index] = (uint8_t)(pu8Input[u32Index] + u32Iter);
+        }
+
+        (void)spsc_ring_push(&xRing, pu8Segment, BENCH_SEG_LONG);
+        (void)spsc_ring_push(&xRing, &pu8Segment[BENCH_SEG_LONG], BENCH_SEG_SHORT);
+
+        u32Read = spsc_ring_pop(&xRing, pu8Output, BENCH_RING_SIZE);
+
+        if (bCheck)
+        {
+            u32Check = u32CheckAdd(u32Check, pu8Output, u32Read);
+        }
+    }
+    *pdNs = dNowNs() - dStart;
+
+    return u32Check;
+}
+
+/* Exported functions --------------------------------------------------------*/
+
+int main(void)
+{
+    double dBestCbuf = 0.0;
+    double dBestSpsc = 0.0;
+    double dCheckNs = 0.0;
+    uint32_t u32CheckCbuf = 0U;
+    uint32_t u32CheckSpsc = 0U;
+    double dBytes = (double)BENCH_ITERATIONS * BENCH_SEG_TOTAL;
+
+    for (uint32_t u32Index = 0U; u32Index < BENCH_SEG_TOTAL; u32Index++)
+    {
+        pu8Input[u32Index] = (uint8_t)((u32Index * 7U) + 1U);
+    }
+
+    for (uint32_t u32Run = 0U; u32Run < BENCH_RUNS; u32Run++)
+    {
+        double dCbuf = 0.0;
+        double dSpsc = 0.0;
+
+        (void)u32RunCbuf(&dCbuf, false);
+        (void)u32RunSpsc(&dSpsc, false);
+
+        if ((u32Run == 0U) || (dCbuf < dBestCbuf))
+        {
+            dBestCbuf = dCbuf;
+        }
+        if ((u32Run == 0U) || (dSpsc < dBestSpsc))
+        {
+            dBestSpsc = dSpsc;
+        }
+    }
+
+    u32CheckCbuf = u32RunCbuf(&dCheckNs, true);
+    u32CheckSpsc = u32RunSpsc(&dCheckNs, true);
+
+    printf("ring cbuf  %.2f ns/byte\n", dBestCbuf / dBytes);
+    printf("ring spsc  %.2f ns/byte\n", dBestSpsc / dBytes);
+    printf("check      cbuf 0x%08X spsc 0x%08X %s\n", u32CheckCbuf, u32CheckSpsc, (u32CheckCbuf == u32CheckSpsc) ? "OK" : "MISMATCH");
+
+    return (u32CheckCbuf == u32CheckSpsc) ? 0 : 1;
+}
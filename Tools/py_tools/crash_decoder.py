@@ -0,0 +1,136 @@
+#! /usr/bin/env python
+"""
+Decode a CrashCatcher dump, from UART fault output or from CLI crash command
+"""
+from __future__ import print_function
+import argparse
+import re
+import struct
+import subprocess
+import sys
+
+# Dump marks, must match crash_hexdump.c and crash command on cli_cmd.c
+CRASH_START = '###CRASH###'
+CRASH_END = '###END###'
+CRASH_HEADER = re.compile(r'CRASH: task (.*), TCB 0x([0-9A-Fa-f]+), (\d+) bytes')
+
+# CrashCatcher dump format, must match CrashCatcher.h
+CC_SIGNATURE = b'cC'
+CC_FLAGS_FLOATING_POINT = 1 << 0
+CC_STACK_SENTINEL = bytes([0xAC, 0xCE, 0x55, 0xED])
+CC_REGS = ['R0', 'R1', 'R2', 'R3', 'R4', 'R5', 'R6', 'R7', 'R8', 'R9', 'R10', 'R11', 'R12',
+           'SP', 'LR', 'PC', 'XPSR', 'MSP', 'PSP', 'EXC_PSR']
+CC_FP_REG_NUM = 33
+
+# Cortex-M exception numbers
+EXCEPTIONS = {0: 'Thread', 2: 'NMI', 3: 'HardFault', 11: 'SVCall', 14: 'PendSV', 15: 'SysTick'}
+
+# Interrupt control and state register, dumped as fault status on M0+
+SCB_ICSR = 0xE000ED04
+
+def extract_dump(text):
+    """Get task info and dump bytes of last crash found on captured text"""
+    start = text.rfind(CRASH_START)
+    end = text.find(CRASH_END, start)
+    if start < 0 or end < 0:
+        return None, None
+    # Header only present when read by CLI crash command
+    headers = list(CRASH_HEADER.finditer(text[:start]))
+    header = headers[-1] if headers else None
+    hex_data = ''
+    for line in text[start + len(CRASH_START):end].splitlines():
+        tokens = line.split()
+        # CLI adds a prefix, hex data is always the last token
+        if tokens and re.match(r'^[0-9A-Fa-f]+$', tokens[-1]):
+            hex_data += tokens[-1]
+    return header, bytes(bytearray.fromhex(hex_data))
+
+def parse_dump(data):
+    """Split CrashCatcher dump on registers and memory regions"""
+    if data[0:2] != CC_SIGNATURE:
+        raise ValueError('CRASH: bad signature %s' % data[0:4])
+    version = (data[2], data[3])
+    flags = struct.unpack_from('<I', data, 4)[0]
+    offset = 8
+    regs = dict(zip(CC_REGS, struct.unpack_from('<%dI' % len(CC_REGS), data, offset)))
+    offset += 4 * len(CC_REGS)
+    if flags & CC_FLAGS_FLOATING_POINT:
+        offset += 4 * CC_FP_REG_NUM
+    regions = []
+    overflow = False
+    while offset + 8 <= len(data):
+        start, end = struct.unpack_from('<II', data, offset)
+        offset += 8
+        regions.append((start, data[offset:offset + end - start]))
+        offset += end - start
+    if data[offset:offset + 4] == CC_STACK_SENTINEL:
+        overflow = True
+    return version, flags, regs, regions, overflow
+
+def addr2line(elf, addr):
+    """Resolve address to function and source line"""
+    try:
+        out = subprocess.check_output(['arm-none-eabi-addr2line', '-f', '-C', '-e', elf, '0x%08X' % addr])
+        func, line = out.decode('ascii', 'replace').splitlines()[:2]
+        return '%s %s' % (func, line)
+    except (OSError, subprocess.CalledProcessError, ValueError):
+        return '?'
+
+def main():
+    # Get parameters
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-f', '--file', type=str, required=False, help="captured output with crash dump")
+    parser.add_argument('-s', '--serial', type=str, required=False, help="serial port, crash command is sent to read dump")
+    parser.add_argument('-e', '--elf', type=str, required=False, help="firmware elf to resolve PC and LR (build/*.elf)")
+    parser.add_argument('-o', '--output', type=str, required=False, help="save binary dump, to be used with CrashDebug")
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, 'rb') as byte_reader:
+            text = byte_reader.read().decode('ascii', 'replace')
+    elif args.serial:
+        import serial
+        ser = serial.Serial(args.serial, baudrate="115200", timeout=1)
+        ser.write(b'crash\r\n')
+        text = ''
+        while CRASH_END not in text:
+            data = ser.read(256)
+            if not data:
+                break
+            text += data.decode('ascii', 'replace')
+        ser.close()
+    else:
+        print("CRASH: serial port or file required")
+        return
+
+    header, data = extract_dump(text)
+    if not data:
+        print("CRASH: no dump found")
+        return
+
+    if args.output:
+        with open(args.output, 'wb') as byte_writer:
+            byte_writer.write(data)
+
+    version, flags, regs, regions, overflow = parse_dump(data)
+    print('CrashCatcher %d.%d, flags %08X, %d bytes' % (version[0], version[1], flags, len(data)))
+    if header:
+        print('Task: %s, TCB 0x%s' % (header.group(1), header.group(2)))
+    exception = regs['EXC_PSR'] & 0x3F
+    print('Exception: %d %s' % (exception, EXCEPTIONS.get(exception, 'IRQ%d' % (exception - 16))))
+    for index in range(0, len(CC_REGS), 4):
+        print('  '.join('%-7s %08X' % (name, regs[name]) for name in CC_REGS[index:index + 4]))
+    if args.elf:
+        print('PC: %s' % addr2line(args.elf, regs['PC']))
+        print('LR: %s' % addr2line(args.elf, regs['LR'] & ~1))
+    for start, content in regions:
+        if start == SCB_ICSR and len(content) == 4:
+            print('ICSR: %08X' % struct.unpack('<I', content)[0])
+        else:
+            print('Region %08X-%08X, %d bytes' % (start, start + len(content), len(content)))
+    if overflow:
+        print('CrashCatcher stack overflow, dump could be corrupted')
+
+if __name__ == "__main__":
+    main()
+    sys.exit(0)
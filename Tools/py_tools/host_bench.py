@@ -0,0 +1,61 @@
+#! /usr/bin/env python
+"""
+Build and run host benchmarks of target libraries, numbers are host only, not target cycles
+"""
+from __future__ import print_function
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Repo root, this script lives on Tools/py_tools
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..', '..'))
+
+# Benchmark name to sources and include dirs, relative to repo root
+BENCHES = {
+    'midi': (['Tools/host_bench/midi_parse_bench.c', 'Lib/midi/midi_lib.c'], ['Lib/midi']),
+    'ring': (['Tools/host_bench/ring_bench.c', 'Lib/cbuf/circular_buffer.c', 'Lib/cbuf/spsc_ring.c'], ['Lib/cbuf']),
+}
+
+def run_bench(name, cc, opt):
+    """Build benchmark on a temp dir and run it, returns process exit code"""
+    sources, includes = BENCHES[name]
+    out_dir = tempfile.mkdtemp()
+    out = os.path.join(out_dir, name + '_bench')
+    cmd = [cc, opt, '-Wall', '-o', out]
+    cmd += ['-I' + os.path.join(ROOT, inc) for inc in includes]
+    cmd += [os.path.join(ROOT, src) for src in sources]
+
+    print("%s: %s" % (name, ' '.join(cmd)))
+    try:
+        if subprocess.call(cmd) != 0:
+            print("%s: build failed" % name)
+            return 1
+        return subprocess.call([out])
+    finally:
+        shutil.rmtree(out_dir)
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('bench', nargs='*', help="benchmarks to run, all if none: %s" % ', '.join(sorted(BENCHES)))
+    parser.add_argument('-c', '--cc', type=str, default='gcc', help="host compiler")
+    parser.add_argument('-O', '--opt', type=str, action='append', default=[],
+                        help="optimization level, -Os if none, can be repeated")
+    args = parser.parse_args()
+
+    for name in args.bench:
+        if name not in BENCHES:
+            parser.error("unknown benchmark %s" % name)
+
+    failed = False
+    for name in (args.bench or sorted(BENCHES)):
+        for opt in (args.opt or ['s']):
+            if run_bench(name, args.cc, '-O' + opt) != 0:
+                failed = True
+
+    return 1 if failed else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
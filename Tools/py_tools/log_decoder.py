@@ -0,0 +1,122 @@
+#! /usr/bin/env python
+"""
+Decode CLI output mixing text and binary log frames (CLI_LOG_BINARY)
+"""
+from __future__ import print_function
+import argparse
+import re
+import struct
+import sys
+
+# Binary frame definition, must match cli_task.h
+LOG_BIN_SYNC = 0x00
+LOG_BIN_MAX_ARGS = 6
+LOG_BIN_HEADER_SIZE = 8
+
+# printf conversion specifiers supported on binary log
+PRINTF_SPEC = re.compile(r'%([-+ 0#]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|t)?([diuxXoc%s])')
+
+def load_fmt_table(file_path):
+    """Load format strings dumped from .cli_log_fmt section, key is string offset"""
+    fmt_table = {}
+    with open(file_path, 'rb') as byte_reader:
+        byte_data = byte_reader.read()
+    offset = 0
+    while offset < len(byte_data):
+        end = byte_data.find(b'\x00', offset)
+        if end < 0:
+            end = len(byte_data)
+        if end > offset:
+            fmt_table[offset] = byte_data[offset:end].decode('ascii', 'replace')
+        offset = end + 1
+    return fmt_table
+
+def format_log(fmt, args):
+    """Apply raw 32 bit arguments to a printf format string"""
+    arg_iter = iter(args)
+    def replace(match):
+        flags, width, precision, _, conv = match.groups()
+        if conv == '%':
+            return '%'
+        value = next(arg_iter, 0)
+        if conv in 'di':
+            value = struct.unpack('<i', struct.pack('<I', value))[0]
+            conv = 'd'
+        elif conv == 'u':
+            conv = 'd'
+        elif conv == 's':
+            return '<str@%08X>' % value
+        spec = '%' + flags + width
+        if precision:
+            spec += '.' + precision
+        return (spec + conv) % value
+    return PRINTF_SPEC.sub(replace, fmt)
+
+class LogDecoder:
+    """
+    Split input stream on text and binary frames
+    """
+    def __init__(self, fmt_table):
+        self.fmt_table = fmt_table
+        self.pending = bytearray()
+
+    def feed(self, data):
+        """Process new input bytes, return decoded text"""
+        output = []
+        self.pending.extend(data)
+        while self.pending:
+            sync = self.pending.find(bytes([LOG_BIN_SYNC]))
+            # Plain text before next frame
+            if sync != 0:
+                text = self.pending if sync < 0 else self.pending[:sync]
+                output.append(text.decode('ascii', 'replace'))
+                del self.pending[:len(text)]
+                continue
+            if len(self.pending) < LOG_BIN_HEADER_SIZE:
+                break
+            num_args = self.pending[1]
+            if num_args > LOG_BIN_MAX_ARGS:
+                # Not a valid frame, skip sync byte
+                del self.pending[:1]
+                continue
+            frame_size = LOG_BIN_HEADER_SIZE + 4 * num_args
+            if len(self.pending) < frame_size:
+                break
+            fmt_id, tick = struct.unpack_from('<HI', self.pending, 2)
+            args = struct.unpack_from('<%dI' % num_args, self.pending, LOG_BIN_HEADER_SIZE)
+            del self.pending[:frame_size]
+            fmt = self.fmt_table.get(fmt_id)
+            if fmt is None:
+                output.append('\r\n%08x, LOG: unknown id %04X %s' % (tick, fmt_id, ' '.join('%08X' % a for a in args)))
+            else:
+                output.append('\r\n%08x, %s' % (tick, format_log(fmt, args)))
+        return ''.join(output)
+
+def main():
+    # Get parameters
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-t', '--table', type=str, required=True, help="format table generated on build (build/*.logfmt)")
+    parser.add_argument('-s', '--serial', type=str, required=False, help="serial port to read")
+    parser.add_argument('-f', '--file', type=str, required=False, help="captured raw output to decode")
+    args = parser.parse_args()
+    decoder = LogDecoder(load_fmt_table(args.table))
+    if args.file:
+        with open(args.file, 'rb') as byte_reader:
+            sys.stdout.write(decoder.feed(byte_reader.read()))
+    elif args.serial:
+        import serial
+        ser = serial.Serial(args.serial, baudrate="115200", timeout=0.1)
+        try:
+            while True:
+                data = ser.read(256)
+                if data:
+                    sys.stdout.write(decoder.feed(data))
+                    sys.stdout.flush()
+        except KeyboardInterrupt:
+            ser.close()
+    else:
+        print("LOG: serial port or file required")
+
+if __name__ == "__main__":
+    main()
+    sys.exit(0)
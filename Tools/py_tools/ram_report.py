@@ -0,0 +1,143 @@
+#! /usr/bin/env python
+"""
+RAM use per subsystem from linker map file, fails on overflow or budget exceeded
+"""
+from __future__ import print_function
+import argparse
+import fnmatch
+import os
+import re
+import sys
+
+# RAM output sections, must match STM32G070CBTx_FLASH.ld
+RAM_SECTIONS = ['.data', '.bss', '.noinit', '._user_heap_stack']
+
+# Linker reserve for main stack and libc heap, no input files on it
+RESERVE_SECTION = '._user_heap_stack'
+
+# Object file to subsystem, first match wins
+SUBSYSTEMS = [
+    ('SYNTH', ['synth_task.o', 'synth_app_data_const.o', 'YM2612_driver.o']),
+    ('MIDI', ['midi_task.o', 'midi_lib.o']),
+    ('UI', ['ui_*.o', 'display_driver.o', 'encoder_driver.o', 'u8g2_*.o', 'u8x8_*.o', 'u8log*.o']),
+    ('MAP', ['mapping_task.o', 'adc_driver.o']),
+    ('STORAGE', ['storage_task.o', 'app_lfs.o', 'lfs*.o']),
+    ('CLI', ['cli_*.o', 'printf.o', 'spsc_ring.o', 'circular_buffer.o', 'FreeRTOS_CLI.o']),
+    ('RTOS', ['tasks.o', 'queue.o', 'timers.o', 'list.o', 'port.o', 'croutine.o',
+              'event_groups.o', 'stream_buffer.o', 'sys_rtos.o']),
+    ('CRASH', ['CrashCatcher*.o', 'crash_*.o', 'user_error.o']),
+    ('HAL', ['stm32g0xx_*.o', 'system_stm32g0xx.o', 'sys_*.o', '*_driver.o', 'startup_*.o', 'main.o']),
+    ('LIBC', ['lib*.a(*)']),
+]
+
+MEM_REGION = re.compile(r'^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+OUT_SECTION = re.compile(r'^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+OUT_WRAPPED = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)')
+IN_SECTION = re.compile(r'^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S.*))?$')
+
+def subsystem(obj):
+    """Get subsystem name of an object file"""
+    name = os.path.basename(obj.strip())
+    for subsys, patterns in SUBSYSTEMS:
+        for pattern in patterns:
+            if fnmatch.fnmatch(name, pattern):
+                return subsys
+    return 'OTHER'
+
+def parse_map(map_lines):
+    """Get RAM region (origin, length) and bytes used per subsystem"""
+    ram = None
+    usage = {}
+    section = None
+    section_wrapped = False
+    pending = None
+    in_config = False
+    for line in map_lines:
+        line = line.rstrip()
+        if line.startswith('Memory Configuration'):
+            in_config = True
+            continue
+        if line.startswith('Linker script and memory map'):
+            in_config = False
+            continue
+        if in_config:
+            match = MEM_REGION.match(line)
+            if match and match.group(1) == 'RAM':
+                ram = (int(match.group(2), 16), int(match.group(3), 16))
+            continue
+        match = OUT_SECTION.match(line)
+        if match or (line and not line[0].isspace()):
+            section = line.split()[0]
+            section_wrapped = match is None
+            pending = None
+            if match and section == RESERVE_SECTION:
+                usage['RESERVE'] = usage.get('RESERVE', 0) + int(match.group(3), 16)
+            continue
+        if section_wrapped:
+            # Long output section names wrap, address and size on next line
+            section_wrapped = False
+            match = OUT_WRAPPED.match(line)
+            if match and section == RESERVE_SECTION:
+                usage['RESERVE'] = usage.get('RESERVE', 0) + int(match.group(2), 16)
+            if match:
+                continue
+        if section not in RAM_SECTIONS or section == RESERVE_SECTION:
+            continue
+        match = IN_SECTION.match(line)
+        if match:
+            size = int(match.group(3), 16)
+            if (match.group(1) or pending) == '*fill*':
+                subsys = 'FILL'
+            else:
+                subsys = subsystem(match.group(4) or '')
+            usage[subsys] = usage.get(subsys, 0) + size
+            pending = None
+        elif line.startswith(' ') and len(line.split()) == 1:
+            # Long input section names wrap, address and size on next line
+            pending = line.split()[0]
+    return ram, usage
+
+def main():
+    # Get parameters
+    parser = argparse.ArgumentParser()
+    parser.add_argument('map', type=str, help="linker map file")
+    parser.add_argument('-b', '--budget', type=str, action='append', default=[],
+                        help="subsystem budget in bytes, NAME=BYTES, can be repeated")
+    parser.add_argument('-f', '--min-free', type=int, default=0, help="min RAM left unused, bytes")
+    args = parser.parse_args()
+
+    with open(args.map, 'r') as map_reader:
+        ram, usage = parse_map(map_reader)
+
+    if ram is None:
+        print("RAM: region not found on %s" % args.map)
+        return 1
+
+    budgets = {}
+    for budget in args.budget:
+        name, size = budget.split('=')
+        budgets[name.upper()] = int(size, 0)
+
+    failed = False
+    total = sum(usage.values())
+    print('%-8s %8s %8s' % ('RAM', 'BYTES', 'BUDGET'))
+    for name in sorted(usage, key=lambda key: -usage[key]):
+        budget = budgets.get(name)
+        mark = ''
+        if budget is not None and usage[name] > budget:
+            mark = ' OVER'
+            failed = True
+        print('%-8s %8d %8s%s' % (name, usage[name], budget if budget is not None else '-', mark))
+    print('%-8s %8d %8d' % ('TOTAL', total, ram[1]))
+    print('%-8s %8d %8d' % ('FREE', ram[1] - total, args.min_free))
+
+    if (ram[1] - total) < args.min_free:
+        failed = True
+
+    if failed:
+        print("RAM: budget exceeded")
+        return 1
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
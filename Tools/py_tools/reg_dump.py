@@ -0,0 +1,134 @@
+#! /usr/bin/env python
+"""
+Fetch YM2612 register mirror in a single binary frame (regdump bin) and diff it
+"""
+from __future__ import print_function
+import argparse
+import struct
+import sys
+
+# Register mirror layout, must match YM2612_driver.h
+YM_NUM_BANK = 2
+YM_REG_FIRST = 0x21
+YM_REG_LAST = 0xB6
+YM_REG_NUM = YM_REG_LAST - YM_REG_FIRST + 1
+
+# Frame mark, must match regdump command on cli_cmd.c
+REG_FRAME_MARK = b'###REGS###'
+
+def read_frame(ser):
+    """Send regdump bin and get mirror data from frame: mark, length, data, sum"""
+    ser.reset_input_buffer()
+    ser.write(b'regdump bin\r\n')
+    rx_buff = b''
+    while REG_FRAME_MARK not in rx_buff:
+        data = ser.read(1)
+        if not data:
+            raise IOError('REGDUMP: frame not found')
+        rx_buff += data
+    length = struct.unpack('<H', ser.read(2))[0]
+    data = ser.read(length)
+    checksum = ser.read(1)
+    if len(data) != length or not checksum or (sum(bytearray(data)) & 0xFF) != bytearray(checksum)[0]:
+        raise IOError('REGDUMP: bad frame')
+    return bytearray(data)
+
+def reg_get(dump, bank, addr):
+    """Get register value from mirror data"""
+    return dump[bank * YM_REG_NUM + addr - YM_REG_FIRST]
+
+def preset_regs(ym_handler):
+    """Registers set by a preset, same encoding as bYM2612_get_preset_reg"""
+    regs = {(0, 0x22): ((ym_handler.lfo_on & 0x01) << 3) | (ym_handler.lfo_freq & 0x07)}
+    for ch_id in range(6):
+        bank = ch_id // 3
+        ch_offset = ch_id % 3
+        channel = ym_handler.channel[ch_id]
+        regs[(bank, 0xB0 + ch_offset)] = channel.get_reg_FBALG()
+        regs[(bank, 0xB4 + ch_offset)] = channel.get_reg_LRAMSPMS()
+        for op_id in range(4):
+            operator = channel.operator[op_id]
+            addr = ch_offset + op_id * 4
+            regs[(bank, 0x30 + addr)] = operator.get_reg_DETMUL()
+            regs[(bank, 0x40 + addr)] = operator.get_reg_TL()
+            regs[(bank, 0x50 + addr)] = operator.get_reg_KSAR()
+            regs[(bank, 0x60 + addr)] = operator.get_reg_AMDR()
+            regs[(bank, 0x70 + addr)] = operator.get_reg_SR()
+            regs[(bank, 0x80 + addr)] = operator.get_reg_SLRL()
+            regs[(bank, 0x90 + addr)] = operator.get_reg_SSGEG()
+    return regs
+
+def show_dump(dump):
+    """Print mirror, 16 registers per line"""
+    print('BK RG: ' + ' '.join('+%X' % col for col in range(16)))
+    for bank in range(YM_NUM_BANK):
+        for row in range(YM_REG_FIRST & 0xF0, YM_REG_LAST + 1, 16):
+            cells = []
+            for addr in range(row, row + 16):
+                if YM_REG_FIRST <= addr <= YM_REG_LAST:
+                    cells.append('%02X' % reg_get(dump, bank, addr))
+                else:
+                    cells.append('--')
+            print('%d  %02X: %s' % (bank, row, ' '.join(cells)))
+
+def show_diff(dump, ref):
+    """Print registers with different value, ref is a dict (bank, addr): value"""
+    diff_count = 0
+    print('BK RG: CHIP REF')
+    for (bank, addr), value in sorted(ref.items()):
+        chip = reg_get(dump, bank, addr)
+        if chip != value:
+            print('%d  %02X: %02X   %02X' % (bank, addr, chip, value))
+            diff_count += 1
+    print('REGDIFF: %d of %d registers differ' % (diff_count, len(ref)))
+
+def main():
+    # Get parameters
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-s', '--serial', type=str, required=False, help="serial port to read mirror from device")
+    parser.add_argument('-f', '--file', type=str, required=False, help="binary mirror saved before, used instead of device")
+    parser.add_argument('-o', '--output', type=str, required=False, help="save binary mirror")
+    parser.add_argument('-r', '--ref', type=str, required=False, help="binary mirror to diff against")
+    parser.add_argument('-v', '--vgi', type=str, required=False, help="vgi preset to diff against")
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, 'rb') as byte_reader:
+            dump = bytearray(byte_reader.read())
+    elif args.serial:
+        import serial
+        ser = serial.Serial(args.serial, baudrate="115200", timeout=1)
+        try:
+            dump = read_frame(ser)
+        finally:
+            ser.close()
+    else:
+        print("REGDUMP: serial port or file required")
+        return
+
+    if len(dump) != YM_NUM_BANK * YM_REG_NUM:
+        print("REGDUMP: bad size %d/%d" % (len(dump), YM_NUM_BANK * YM_REG_NUM))
+        return
+
+    if args.output:
+        with open(args.output, 'wb') as byte_writer:
+            byte_writer.write(dump)
+
+    if args.ref:
+        with open(args.ref, 'rb') as byte_reader:
+            ref_dump = bytearray(byte_reader.read())
+        show_diff(dump, {(bank, addr): reg_get(ref_dump, bank, addr)
+                         for bank in range(YM_NUM_BANK)
+                         for addr in range(YM_REG_FIRST, YM_REG_LAST + 1)})
+    elif args.vgi:
+        import YM2612
+        import fm_util
+        fm_chip = YM2612.YM2612Chip()
+        if fm_util.load_vgi_file(args.vgi, fm_chip):
+            show_diff(dump, preset_regs(fm_chip))
+    else:
+        show_dump(dump)
+
+if __name__ == "__main__":
+    main()
+    sys.exit(0)